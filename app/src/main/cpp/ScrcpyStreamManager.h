@@ -8,6 +8,10 @@
 #include "concurrentqueue/blockingconcurrentqueue.h"
 #include "stream/EncodedPacket.h"
 #include "stream/MediaPacketStore.h"
+#include "stream/PacketFanout.h"
+#include "stream/PacketSocketServer.h"
+#include "stream/ClockSkewEstimator.h"
+#include "util/MemoryBudget.h"
 #include "stream/StreamIO.h"
 #include "decoder/VideoDecoderNative.h"
 #include "decoder/AudioDecoderNative.h"
@@ -22,6 +26,7 @@
 #include <deque>
 #include <condition_variable>
 #include <memory>
+#include <chrono>
 
 // 事件回调: type, data (JSON string)
 using StreamEventCallback = std::function<void(const std::string& type, const std::string& data)>;
@@ -40,6 +45,24 @@ public:
         bool expectAudio = false;
         bool expectControl = true;
         bool sendDummyByte = true;
+        PacketRetention videoRetention = PacketRetention::KeyFrame;
+        size_t maxRetainedVideoBytes = 16 * 1024 * 1024;
+        // 连接池：各流所在的 ADB 连接，nullptr 表示使用 start() 传入的主连接
+        Adb* videoAdb = nullptr;
+        Adb* audioAdb = nullptr;
+        Adb* controlAdb = nullptr;
+    };
+
+    // 断线恢复：期望有视频却持续 deadPeerMs 收不到包，或传输层（keepalive / TCP_USER_TIMEOUT）报错时，
+    // 重连同一地址（TLS 会话复用 + 已授权的密钥）、用同样的命令重启 server，并接回现有解码器
+    struct ResumeOptions {
+        std::string serverCommand;   // 完整的 app_process 命令行
+        std::string socketName;      // server 的 localabstract socket 名
+        std::string pubKeyPath;
+        std::string priKeyPath;
+        int32_t deadPeerMs = 3000;
+        int32_t targetMs = 8000;     // 单次恢复（连接到出第一个视频包）的时限
+        int32_t maxAttempts = 3;
     };
 
     ScrcpyStreamManager();
@@ -52,8 +75,28 @@ public:
     // 向控制流发送数据
     bool sendControl(const uint8_t* data, size_t len);
 
+    // 请求视频解码器重新同步：flush 后用缓存的 config + 关键帧（及 GOP）立即出图
+    bool requestVideoResync();
+
+    // 旁路消费者：与解码器共享编码包负载，各自独立排队，不影响屏幕解码
+    int32_t addPacketSink(std::unique_ptr<IPacketSink> sink);
+    bool removePacketSink(int32_t sinkId);
+    // 在 127.0.0.1 上以原始 scrcpy 分帧输出视频/音频流，返回实际端口，失败返回负数
+    int32_t startPacketServer(FanoutMediaKind kind, uint16_t port);
+
+    // 系统内存压力通知：收缩编码包池和关键帧缓存
+    void trimMemory(MemoryPressure level);
+
     int32_t getVideoWidth() const { return videoWidth_.load(); }
     int32_t getVideoHeight() const { return videoHeight_.load(); }
+    // 设备时钟漂移与编码到到达的额外时延估计
+    std::string videoLatencyJson() const { return videoClock_.toJson(); }
+
+    // start/startReverse 成功后调用；连接不是按地址建立的（create(fd)）时返回 false
+    bool enableAutoResume(const ResumeOptions& options);
+    // 最近一次恢复建立的主连接，调用方据此替换原 adbId 对应的实例
+    std::shared_ptr<Adb> resumedAdb() const;
+    std::string resumeJson() const;
 
     // 停止所有线程并释放资源
     void stop();
@@ -63,12 +106,13 @@ public:
 private:
     // 线程函数
     void videoThreadFunc();
-    void videoDecodeThreadFunc();
+    void videoDecodeThreadFunc(bool reattached);
     void audioThreadFunc();
     void audioDecodeThreadFunc();
     void controlThreadFunc();
     void controlSendThreadFunc();
     void acceptThreadFunc();
+    void resumeThreadFunc();
 
     // 精确读取 N 字节（阻塞），抛出异常表示流关闭或超时
     std::vector<uint8_t> readExact(IByteStream* source, size_t size, int32_t timeoutMs = -1);
@@ -78,13 +122,44 @@ private:
     void releaseLocalTunnels();
     void closeListener();
     static void closeFd(int& fd);
+    // 进程内 reverse 直通：Adb 在收包线程上把命中监听端口的流交过来，accept 线程按到达顺序领取
+    bool onDirectReverseStream(AdbStream* stream);
+    void wakeAcceptThread();
+    void closeDirectReverseStreams();
     void initPacketPools();
-    void resetPacketPools();
+    void resetPacketPools(bool keepVideoGop = false);
+    bool submitVideoBytes(const uint8_t* data, size_t size, int64_t pts, uint32_t flags);
+    size_t primeVideoDecoder(int64_t replayUpToPts, uint64_t& appliedConfigSerial, bool flush);
+    void recordStartupSpan(const std::string& phase, std::chrono::steady_clock::time_point start);
+    // 起收流线程（反向模式起 accept 线程），start/startReverse 与断线恢复共用
+    void startStreamThreads();
+    // 断线恢复
+    bool transportLost() const;
+    void requestResume(const std::string& reason);
+    bool resumeSession(const std::string& reason);
+    void suspendPipeline();
+    // 连接快照：恢复线程会整体替换下面的连接指针，其它线程只经由这里读取
+    struct Connections {
+        Adb* primary = nullptr;
+        Adb* video = nullptr;
+        Adb* audio = nullptr;
+        Adb* control = nullptr;
+    };
+    Connections connections() const;
+    void setConnections(Adb* primary, Adb* video, Adb* audio, Adb* control);
+    bool reattach(Adb* adb, std::chrono::steady_clock::time_point deadline);
+    bool resumeCancelled() const;
+    void completeStartupTimeline();
 
     // 发送事件到 ArkTS
     void emitEvent(const std::string& type, const std::string& data = "");
 
+    // 保护 adb_/videoAdb_/audioAdb_/controlAdb_、config_ 中的流 id 与 serverShellId_ 的改写
+    mutable std::mutex connectionMutex_;
     Adb* adb_ = nullptr;
+    Adb* videoAdb_ = nullptr;
+    Adb* audioAdb_ = nullptr;
+    Adb* controlAdb_ = nullptr;
     Config config_;
     StreamEventCallback eventCallback_;
 
@@ -98,6 +173,12 @@ private:
     AdbChannel* controlChannel_ = nullptr;
 
     int listenFd_ = -1;
+    uint16_t reversePort_ = 0;
+    int acceptWakeFd_ = -1;
+    std::mutex directReverseMutex_;
+    std::deque<AdbStream*> directReverseStreams_;
+    // accept 线程领取的直通流，stop() 时关闭
+    std::vector<AdbStream*> acceptedDirectStreams_;
 
     std::thread videoThread_;
     std::thread videoDecodeThread_;
@@ -109,12 +190,38 @@ private:
     std::atomic<bool> running_{false};
     std::atomic<bool> videoReaderDone_{false};
     std::atomic<bool> audioReaderDone_{false};
+    std::atomic<bool> videoResyncRequested_{false};
     std::atomic<int32_t> videoWidth_{0};
     std::atomic<int32_t> videoHeight_{0};
+    std::string videoCodecType_;
+
+    ResumeOptions resumeOptions_;
+    std::thread resumeThread_;
+    std::atomic<bool> resumeEnabled_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> resuming_{false};
+    // 最近一个视频包到达的时间（steady_clock 纳秒），0 表示还没收到
+    std::atomic<int64_t> lastVideoPacketNs_{0};
+    mutable std::mutex resumeMutex_;
+    std::condition_variable resumeCv_;
+    std::string resumeReason_;
+    std::shared_ptr<Adb> resumedAdb_;
+    // 正在建立的连接，stop() 时关闭以中断恢复
+    std::shared_ptr<Adb> connectingAdb_;
+    int32_t serverShellId_ = -1;
+    std::atomic<uint32_t> resumeAttempts_{0};
+    std::atomic<uint32_t> resumeSuccesses_{0};
+    std::atomic<uint32_t> resumeFailures_{0};
+    std::atomic<int64_t> lastResumeMs_{-1};
     std::mutex eventMutex_;
     moodycamel::BlockingConcurrentQueue<std::vector<uint8_t>> controlReliableQueue_;
     MediaPacketStore<EncodedVideoPacket> videoPackets_;
     MediaPacketStore<EncodedAudioPacket> audioPackets_;
+    PacketFanout packetFanout_;
+    ClockSkewEstimator videoClock_;
+    std::mutex packetServerMutex_;
+    std::unique_ptr<PacketSocketServer> videoPacketServer_;
+    std::unique_ptr<PacketSocketServer> audioPacketServer_;
 };
 
 #endif // SCRCPY_STREAM_MANAGER_H
@@ -0,0 +1,171 @@
+// HappyEyeballs - RFC 8305 并行连接
+#include "adb/channel/HappyEyeballs.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <hilog/log.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#undef LOG_TAG
+#define LOG_TAG "HappyEyeballs"
+
+namespace {
+int pollRetryOnEintr(struct pollfd* pfd, nfds_t nfds, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return 0;
+        }
+        int remainingMs = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()
+        );
+
+        int ret = poll(pfd, nfds, remainingMs);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        return ret;
+    }
+}
+
+std::string describeAddress(const addrinfo* addr) {
+    char host[INET6_ADDRSTRLEN] = {0};
+    const void* src = nullptr;
+    if (addr->ai_family == AF_INET) {
+        src = &reinterpret_cast<const sockaddr_in*>(addr->ai_addr)->sin_addr;
+    } else if (addr->ai_family == AF_INET6) {
+        src = &reinterpret_cast<const sockaddr_in6*>(addr->ai_addr)->sin6_addr;
+    }
+    if (!src || !inet_ntop(addr->ai_family, src, host, sizeof(host))) {
+        return "?";
+    }
+    return host;
+}
+
+// 发起非阻塞连接，返回 fd（连接中或已连上），立即失败返回 -1
+int startConnectAttempt(const addrinfo* addr) {
+    int fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    if (fd < 0) {
+        return -1;
+    }
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    if (connect(fd, addr->ai_addr, addr->ai_addrlen) == 0 || errno == EINPROGRESS) {
+        return fd;
+    }
+    OH_LOG_ERROR(LOG_APP, "HappyEyeballs: Connect %{public}s immediate fail: %{public}s",
+                 describeAddress(addr).c_str(), strerror(errno));
+    ::close(fd);
+    return -1;
+}
+
+struct ConnectAttempt {
+    int fd;
+    const addrinfo* addr;
+};
+}
+
+std::vector<const addrinfo*> HappyEyeballs::interleaveAddressFamilies(const addrinfo* res) {
+    std::vector<const addrinfo*> preferred;
+    std::vector<const addrinfo*> other;
+    const int firstFamily = res ? res->ai_family : AF_UNSPEC;
+    for (const addrinfo* p = res; p != nullptr; p = p->ai_next) {
+        (p->ai_family == firstFamily ? preferred : other).push_back(p);
+    }
+    std::vector<const addrinfo*> ordered;
+    ordered.reserve(preferred.size() + other.size());
+    for (size_t i = 0; i < preferred.size() || i < other.size(); ++i) {
+        if (i < preferred.size()) {
+            ordered.push_back(preferred[i]);
+        }
+        if (i < other.size()) {
+            ordered.push_back(other[i]);
+        }
+    }
+    return ordered;
+}
+
+int HappyEyeballs::connect(const std::vector<const addrinfo*>& addrs, int timeoutMs, int attemptDelayMs) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    auto nextAttemptAt = Clock::now();
+    size_t next = 0;
+    std::vector<ConnectAttempt> inflight;
+    int winner = -1;
+
+    while (winner < 0) {
+        auto now = Clock::now();
+        if (now >= deadline) {
+            OH_LOG_ERROR(LOG_APP, "HappyEyeballs: Connect TIMEOUT (%{public}dms)", timeoutMs);
+            break;
+        }
+        // 到达间隔或当前没有进行中的尝试时，发起下一个地址
+        if (next < addrs.size() && (now >= nextAttemptAt || inflight.empty())) {
+            const addrinfo* addr = addrs[next++];
+            int fd = startConnectAttempt(addr);
+            if (fd >= 0) {
+                inflight.push_back({fd, addr});
+                nextAttemptAt = now + std::chrono::milliseconds(attemptDelayMs);
+            }
+            continue;
+        }
+        if (inflight.empty()) {
+            break;
+        }
+
+        auto waitUntil = next < addrs.size() ? std::min(deadline, nextAttemptAt) : deadline;
+        int waitMs = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(waitUntil - now).count());
+        std::vector<struct pollfd> pfds(inflight.size());
+        for (size_t i = 0; i < inflight.size(); ++i) {
+            pfds[i].fd = inflight[i].fd;
+            pfds[i].events = POLLOUT;
+            pfds[i].revents = 0;
+        }
+        int pollRes = pollRetryOnEintr(pfds.data(), pfds.size(), std::max(waitMs, 1));
+        if (pollRes < 0) {
+            OH_LOG_ERROR(LOG_APP, "HappyEyeballs: Poll error errno=%{public}d", errno);
+            break;
+        }
+
+        for (size_t i = inflight.size(); i-- > 0;) {
+            if (pfds[i].revents == 0) {
+                continue;
+            }
+            int error = 0;
+            socklen_t len = sizeof(error);
+            if (winner < 0 && getsockopt(inflight[i].fd, SOL_SOCKET, SO_ERROR, &error, &len) == 0 && error == 0 &&
+                (pfds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) == 0) {
+                winner = inflight[i].fd;
+                OH_LOG_INFO(LOG_APP, "HappyEyeballs: Connected via %{public}s",
+                            describeAddress(inflight[i].addr).c_str());
+            } else if (winner < 0) {
+                OH_LOG_ERROR(LOG_APP, "HappyEyeballs: Connect %{public}s failed with error: %{public}d",
+                             describeAddress(inflight[i].addr).c_str(), error);
+                ::close(inflight[i].fd);
+                // 一个尝试失败后立即开始下一个，不必等满间隔
+                nextAttemptAt = Clock::now();
+            } else {
+                ::close(inflight[i].fd);
+            }
+            inflight.erase(inflight.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+    }
+
+    for (const auto& attempt : inflight) {
+        ::close(attempt.fd);
+    }
+    if (winner >= 0) {
+        int flags = fcntl(winner, F_GETFL, 0);
+        fcntl(winner, F_SETFL, flags & ~O_NONBLOCK); // Restore blocking
+    }
+    return winner;
+}
@@ -0,0 +1,19 @@
+// HappyEyeballs - RFC 8305 并行连接
+// 解析出的多个地址按 IPv6/IPv4 交错、每隔 attemptDelayMs 发起一次非阻塞连接，先连上者胜出，其余关闭。
+// 从 TcpChannel 中拆出，只依赖 POSIX socket，便于在主机上单独测试（见 app/src/test/cpp）。
+#ifndef SCRCPY_HAPPY_EYEBALLS_H
+#define SCRCPY_HAPPY_EYEBALLS_H
+
+#include <netdb.h>
+#include <vector>
+
+class HappyEyeballs {
+public:
+    // 以首个结果的地址族优先，两族交错排列
+    static std::vector<const addrinfo*> interleaveAddressFamilies(const addrinfo* res);
+
+    // 返回胜出的 fd（已恢复阻塞模式）；全部失败或 timeoutMs 截止时返回 -1，进行中的尝试全部关闭
+    static int connect(const std::vector<const addrinfo*>& addrs, int timeoutMs, int attemptDelayMs);
+};
+
+#endif // SCRCPY_HAPPY_EYEBALLS_H
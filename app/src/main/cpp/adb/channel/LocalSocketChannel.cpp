@@ -1,5 +1,6 @@
 // LocalSocketChannel - 基于本地 socket fd 的通道实现
 #include "adb/channel/LocalSocketChannel.h"
+#include "util/SocketTuning.h"
 
 #include <algorithm>
 #include <cerrno>
@@ -34,7 +35,7 @@ int pollRetryOnEintr(int fd, short events, int timeoutMs) {
 }
 }
 
-LocalSocketChannel::LocalSocketChannel(int fd) : fd_(fd) {
+LocalSocketChannel::LocalSocketChannel(int fd, bool quickAck) : fd_(fd), quickAck_(quickAck) {
     if (fd_ < 0) {
         throw std::invalid_argument("LocalSocketChannel: invalid fd");
     }
@@ -96,6 +97,9 @@ void LocalSocketChannel::readWithTimeout(uint8_t* buf, size_t len, int timeoutMs
         }
         offset += static_cast<size_t>(n);
     }
+    if (quickAck_) {
+        SocketTuning::rearmQuickAck(fd_);
+    }
 }
 
 void LocalSocketChannel::close() {
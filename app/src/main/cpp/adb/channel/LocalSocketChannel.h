@@ -9,7 +9,8 @@
 
 class LocalSocketChannel : public AdbChannel {
 public:
-    explicit LocalSocketChannel(int fd);
+    // quickAck: 控制通道每次读到数据后重新打开 TCP_QUICKACK
+    explicit LocalSocketChannel(int fd, bool quickAck = false);
     ~LocalSocketChannel() override;
 
     void write(const uint8_t* data, size_t len) override;
@@ -20,6 +21,7 @@ public:
 
 private:
     int fd_;
+    bool quickAck_;
     std::atomic<bool> closed_{false};
     std::mutex writeMutex_;
 };
@@ -2,6 +2,8 @@
 // 参考 TcpChannel.ets 实现
 // 不实现网络连接逻辑，fd由ArkTS传入
 #include "adb/channel/TcpChannel.h"
+#include "adb/channel/HappyEyeballs.h"
+#include "util/SocketTuning.h"
 #include <cerrno>
 #include <cstring>
 #include <unistd.h>
@@ -14,6 +16,9 @@
 #include <poll.h>
 #include <stdexcept>
 #include <chrono>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include <hilog/log.h>
 
 #undef LOG_TAG
@@ -61,21 +66,16 @@ TcpChannel::TcpChannel(int fd) : fd_(fd) {
         fcntl(fd_, F_SETFL, flags & ~O_NONBLOCK);
         OH_LOG_INFO(LOG_APP, "TcpChannel: set fd=%{public}d to blocking mode (was flags=0x%{public}x)", fd_, flags);
     }
-    int nodelay = 1;
-    if (setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&nodelay),
-                   sizeof(nodelay)) != 0) {
-        OH_LOG_WARN(LOG_APP, "TcpChannel: failed to set TCP_NODELAY on fd=%{public}d errno=%{public}d",
-                    fd_, errno);
-    }
+    SocketTuning::apply(fd_, SocketProfile::Bulk, "adb");
     buffer_.resize(BUFFER_SIZE);
     OH_LOG_INFO(LOG_APP, "TcpChannel: created with fd=%{public}d", fd_);
 }
 
-TcpChannel::TcpChannel(const std::string& host, int port) {
+TcpChannel::TcpChannel(const std::string& host, int port, int connectTimeoutMs) {
     fd_ = -1;
     buffer_.resize(BUFFER_SIZE);
 
-    struct addrinfo hints, *res, *p;
+    struct addrinfo hints, *res;
     std::memset(&hints, 0, sizeof(hints));
     hints.ai_family = AF_UNSPEC; // IPv4 or IPv6
     hints.ai_socktype = SOCK_STREAM;
@@ -89,85 +89,15 @@ TcpChannel::TcpChannel(const std::string& host, int port) {
         throw std::runtime_error("getaddrinfo failed: " + std::string(gai_strerror(status)));
     }
 
-    // Iterate through results and try to connect
-    for (p = res; p != nullptr; p = p->ai_next) {
-        fd_ = socket(p->ai_family, p->ai_socktype, p->ai_protocol);
-        if (fd_ < 0) {
-            continue;
-        }
-
-        // Set non-blocking
-        int flags = fcntl(fd_, F_GETFL, 0);
-        fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
-
-//        OH_LOG_INFO(LOG_APP, "TcpChannel: Connecting (non-blocking)...");
-        int res = connect(fd_, p->ai_addr, p->ai_addrlen);
-        
-        if (res == 0) {
-            // Success immediately
-             fcntl(fd_, F_SETFL, flags); // Restore blocking
-             break;
-        } else if (res < 0 && errno == EINPROGRESS) {
-            // Waiting for connection
-            struct pollfd pfd;
-            pfd.fd = fd_;
-            pfd.events = POLLOUT;
-            
-            // Timeout: 30 seconds (30000 ms)
-            int pollRes = pollRetryOnEintr(&pfd, 1, 30000);
-            
-            if (pollRes > 0) {
-                if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
-                    OH_LOG_ERROR(LOG_APP, "TcpChannel: Connect poll error revents=0x%{public}x", pfd.revents);
-                    ::close(fd_);
-                    fd_ = -1;
-                    continue;
-                }
-                int error = 0;
-                socklen_t len = sizeof(error);
-                if (getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0) {
-                     // Connection failed
-                     OH_LOG_ERROR(LOG_APP, "TcpChannel: Connect failed with error: %{public}d", error);
-                     ::close(fd_);
-                     fd_ = -1;
-                     continue;
-                }
-                // Success
-                OH_LOG_INFO(LOG_APP, "TcpChannel: Connected via poll");
-                fcntl(fd_, F_SETFL, flags); // Restore blocking
-                break;
-            } else if (pollRes == 0) {
-                 OH_LOG_ERROR(LOG_APP, "TcpChannel: Connect TIMEOUT (30s)");
-                 ::close(fd_);
-                 fd_ = -1;
-                 continue; // Try next address?
-            } else {
-                 OH_LOG_ERROR(LOG_APP, "TcpChannel: Poll error errno=%{public}d", errno);
-                 ::close(fd_);
-                 fd_ = -1;
-                 continue;
-            }
-        } else {
-             // Immediate failure
-             OH_LOG_ERROR(LOG_APP, "TcpChannel: Connect immediate fail: %{public}s", strerror(errno));
-             ::close(fd_);
-             fd_ = -1;
-             continue;
-        }
-
-        ::close(fd_);
-        fd_ = -1;
-    }
-
+    fd_ = HappyEyeballs::connect(HappyEyeballs::interleaveAddressFamilies(res), connectTimeoutMs,
+                                 CONNECTION_ATTEMPT_DELAY_MS);
     freeaddrinfo(res);
 
     if (fd_ < 0) {
         throw std::runtime_error("Failed to connect to " + host + ":" + portStr);
     }
 
-    // Set TCP_NODELAY
-    int flag = 1;
-    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, (char *)&flag, sizeof(int));
+    SocketTuning::apply(fd_, SocketProfile::Bulk, "adb");
 
     OH_LOG_INFO(LOG_APP, "TcpChannel: connected fd=%{public}d", fd_);
 }
@@ -275,6 +205,53 @@ void TcpChannel::fillBuffer(int timeoutMs) {
     bufferTail_ = static_cast<size_t>(n);
 }
 
+size_t TcpChannel::readNonBlocking(uint8_t* buf, size_t len) {
+    if (closed_.load()) {
+        throw std::runtime_error("TcpChannel: read on closed channel");
+    }
+    // 握手阶段读进缓冲但尚未消费的数据先交出去
+    size_t available = bufferTail_ - bufferHead_;
+    if (available > 0) {
+        size_t toCopy = std::min(available, len);
+        std::memcpy(buf, buffer_.data() + bufferHead_, toCopy);
+        bufferHead_ += toCopy;
+        return toCopy;
+    }
+
+    while (true) {
+        ssize_t n = ::recv(fd_, buf, len, MSG_DONTWAIT);
+        if (n > 0) {
+            return static_cast<size_t>(n);
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        throw std::runtime_error("TcpChannel: read failed or connection closed");
+    }
+}
+
+size_t TcpChannel::writeNonBlocking(const uint8_t* data, size_t len) {
+    if (closed_.load()) {
+        throw std::runtime_error("TcpChannel: write on closed channel");
+    }
+    while (true) {
+        ssize_t n = ::send(fd_, data, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n >= 0) {
+            return static_cast<size_t>(n);
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        throw std::runtime_error("TcpChannel: write failed (broken pipe or closed)");
+    }
+}
+
 void TcpChannel::close() {
     bool expected = false;
     if (closed_.compare_exchange_strong(expected, true)) {
@@ -292,6 +269,16 @@ bool TcpChannel::isClosed() const {
     return closed_.load();
 }
 
+std::vector<uint8_t> TcpChannel::takeBufferedBytes() {
+    std::vector<uint8_t> bytes;
+    if (bufferTail_ > bufferHead_) {
+        bytes.assign(buffer_.begin() + bufferHead_, buffer_.begin() + bufferTail_);
+    }
+    bufferHead_ = 0;
+    bufferTail_ = 0;
+    return bytes;
+}
+
 int TcpChannel::releaseFd() {
     int fd = fd_;
     fd_ = -1;
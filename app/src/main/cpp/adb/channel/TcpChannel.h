@@ -7,13 +7,21 @@
 #include "adb/core/AdbChannel.h"
 #include <atomic>
 #include <mutex>
+#include <string>
+#include <vector>
 
 class TcpChannel : public AdbChannel {
 public:
     // 构造函数接受ArkTS传入的文件描述符
     explicit TcpChannel(int fd);
-    // 构造函数:直接连接指定IP和端口
-    TcpChannel(const std::string& ip, int port);
+    static constexpr int DEFAULT_CONNECT_TIMEOUT_MS = 30000;
+    // 相邻两次连接尝试的间隔（RFC 8305 Connection Attempt Delay）
+    static constexpr int CONNECTION_ATTEMPT_DELAY_MS = 250;
+
+    // 构造函数:直接连接指定主机和端口
+    // 解析出的多个地址按 IPv6/IPv4 交错、每隔 CONNECTION_ATTEMPT_DELAY_MS 发起一次并行连接，
+    // 先连上者胜出，其余取消；connectTimeoutMs 为整体截止时间
+    TcpChannel(const std::string& ip, int port, int connectTimeoutMs = DEFAULT_CONNECT_TIMEOUT_MS);
     ~TcpChannel() override;
 
     void read(uint8_t* buf, size_t len) override;
@@ -21,7 +29,12 @@ public:
     void write(const uint8_t* data, size_t len) override;
     void close() override;
     bool isClosed() const override;
+    int reactorFd() const override { return closed_.load() ? -1 : fd_; }
+    size_t readNonBlocking(uint8_t* buf, size_t len) override;
+    size_t writeNonBlocking(const uint8_t* data, size_t len) override;
     int releaseFd();
+    // 取走已读入缓冲但尚未消费的字节（切换到其它通道实现前调用）
+    std::vector<uint8_t> takeBufferedBytes();
 
 private:
     int fd_;
@@ -1,12 +1,23 @@
 #include "adb/channel/TlsAdbChannel.h"
+#include "diag/StallWatchdog.h"
+#include "diag/ThreadCpuMonitor.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
 #include <poll.h>
+#include <sstream>
 #include <stdexcept>
 #include <string_view>
 #include <chrono>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <time.h>
 #include <unistd.h>
+#include <hilog/log.h>
+
+#undef LOG_TAG
+#define LOG_TAG "TlsAdbChannel"
 
 namespace {
 int pollRetryOnEintr(struct pollfd* pfd, nfds_t nfds, int timeoutMs) {
@@ -36,6 +47,47 @@ int pollRetryOnEintr(struct pollfd* pfd, nfds_t nfds, int timeoutMs) {
         return ret;
     }
 }
+
+// TLS 记录最大 16KB 明文，缓冲剩余空间不足一条记录时停止继续排空
+constexpr size_t MAX_TLS_RECORD_PLAINTEXT = 16 * 1024;
+constexpr size_t TLS_RECORD_HEADER_SIZE = 5;
+// 未开 read-ahead 时 SSL_read 每条记录读两次 socket（记录头、记录体）
+constexpr uint64_t SYSCALLS_PER_SSL_READ = 2;
+
+uint64_t threadCpuNs() {
+    struct timespec ts {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+std::atomic<uint64_t> g_plaintextBytes{0};
+std::atomic<uint64_t> g_polls{0};
+std::atomic<uint64_t> g_sslReads{0};
+// 读路径上的系统调用（poll、排空前的 peek/FIONREAD、SSL_read 内的 read）与解密耗费的线程 CPU
+std::atomic<uint64_t> g_readSyscalls{0};
+std::atomic<uint64_t> g_readCpuNs{0};
+std::atomic<uint64_t> g_writtenBytes{0};
+std::atomic<uint64_t> g_writeRecords{0};
+std::atomic<uint64_t> g_coalescedMessages{0};
+
+std::atomic<bool> g_decryptPipelineEnabled{false};
+
+// socket 里已经排着一条完整的 TLS 记录：此时 SSL_read 不会阻塞
+bool wholeRecordQueued(int fd) {
+    uint8_t header[TLS_RECORD_HEADER_SIZE];
+    g_readSyscalls.fetch_add(1, std::memory_order_relaxed);
+    ssize_t peeked = ::recv(fd, header, sizeof(header), MSG_PEEK | MSG_DONTWAIT);
+    if (peeked < static_cast<ssize_t>(sizeof(header))) {
+        return false;
+    }
+    const size_t recordSize = TLS_RECORD_HEADER_SIZE + ((static_cast<size_t>(header[3]) << 8) | header[4]);
+    int queued = 0;
+    g_readSyscalls.fetch_add(1, std::memory_order_relaxed);
+    if (ioctl(fd, FIONREAD, &queued) != 0) {
+        return false;
+    }
+    return queued >= 0 && static_cast<size_t>(queued) >= recordSize;
+}
 }
 
 TlsAdbChannel::TlsAdbChannel(std::unique_ptr<scrcpy::pairing::TlsConnection> tlsConnection, int fd)
@@ -43,22 +95,140 @@ TlsAdbChannel::TlsAdbChannel(std::unique_ptr<scrcpy::pairing::TlsConnection> tls
     if (!tlsConnection_ || fd_ < 0) {
         throw std::invalid_argument("Invalid TLS ADB channel");
     }
+    buffer_.resize(BUFFER_SIZE);
+    writeStaging_.resize(MAX_TLS_RECORD_PLAINTEXT);
 }
 
 TlsAdbChannel::~TlsAdbChannel() {
     if (!closed_.load()) {
         close();
     }
+    if (decryptThread_.joinable()) {
+        decryptThread_.join();
+    }
     tlsConnection_.reset();
 }
 
+void TlsAdbChannel::setDecryptPipelineEnabled(bool enabled) {
+    g_decryptPipelineEnabled.store(enabled);
+}
+
+bool TlsAdbChannel::decryptPipelineEnabled() {
+    return g_decryptPipelineEnabled.load();
+}
+
+void TlsAdbChannel::startDecryptThread() {
+    if (decryptThread_.joinable() || closed_.load()) {
+        return;
+    }
+    decryptRing_ = std::make_unique<RingBuffer>(DECRYPT_RING_SIZE);
+    decryptThread_ = std::thread(&TlsAdbChannel::decryptLoop, this);
+}
+
+void TlsAdbChannel::decryptLoop() {
+    StallWatchdog::ThreadScope watchdogScope("tls-decrypt");
+    ThreadCpuMonitor::Scope cpuScope("decrypt", "tls-decrypt");
+    try {
+        while (!closed_.load()) {
+            auto writeInfo = decryptRing_->getWritePtr();
+            if (writeInfo.second == 0) {
+                // 解复用跟不上：等消费端腾出空间，TCP 背压自然传到对端
+                StallWatchdog::WaitScope waitScope("decrypt_ring_space", -1, StallWatchdog::WaitKind::Idle);
+                if (!decryptRing_->waitForSpace(1, -1)) {
+                    break;
+                }
+                continue;
+            }
+            {
+                StallWatchdog::WaitScope waitScope("tls_socket_read", -1, StallWatchdog::WaitKind::Idle);
+                waitReadable(false, Clock::time_point{});
+            }
+            size_t n = readSome(writeInfo.first, writeInfo.second);
+            decryptRing_->commitWrite(n);
+        }
+    } catch (const std::exception& e) {
+        if (!closed_.load()) {
+            OH_LOG_WARN(LOG_APP, "[TLS] Decrypt thread stopped: %{public}s", e.what());
+        }
+    }
+    decryptFailed_.store(true);
+    decryptRing_->close();
+}
+
+void TlsAdbChannel::readFromDecryptRing(uint8_t* buf, size_t len, int timeoutMs) {
+    const bool hasDeadline = timeoutMs >= 0;
+    const auto deadline = hasDeadline
+        ? Clock::now() + std::chrono::milliseconds(timeoutMs)
+        : Clock::time_point{};
+
+    size_t offset = 0;
+    while (offset < len) {
+        offset += decryptRing_->copyTo(buf + offset, len - offset);
+        if (offset >= len) {
+            break;
+        }
+        if ((decryptFailed_.load() || closed_.load()) && decryptRing_->empty()) {
+            throw std::runtime_error(closed_.load() ? "TlsAdbChannel: read on closed channel"
+                                                    : "TlsAdbChannel: read failed");
+        }
+
+        // 分片等待：生产端 notify 不持锁，避免极端情况下错过唤醒一直挂起
+        int waitMs = 100;
+        if (hasDeadline) {
+            auto now = Clock::now();
+            if (now >= deadline) {
+                throw std::runtime_error("TlsAdbChannel: read timeout");
+            }
+            waitMs = static_cast<int>(std::min<int64_t>(
+                waitMs, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1));
+        }
+        decryptRing_->waitForData(1, waitMs);
+    }
+}
+
 void TlsAdbChannel::write(const uint8_t* data, size_t len) {
     if (closed_.load()) {
         throw std::runtime_error("TlsAdbChannel: write on closed channel");
     }
+    // 保证先前暂存的数据先发出，维持字节序
+    flush();
+    sealRecord(data, len);
+}
+
+void TlsAdbChannel::writeBuffered(const uint8_t* data, size_t len) {
+    if (closed_.load()) {
+        throw std::runtime_error("TlsAdbChannel: write on closed channel");
+    }
+    // 放不进当前暂存区：先封装已有数据
+    if (writeStagingSize_ + len > MAX_TLS_RECORD_PLAINTEXT) {
+        flush();
+    }
+    // 单条消息本身就超过一条记录，直接交给 SSL_write 分片
+    if (len >= MAX_TLS_RECORD_PLAINTEXT) {
+        sealRecord(data, len);
+        return;
+    }
+    std::memcpy(writeStaging_.data() + writeStagingSize_, data, len);
+    writeStagingSize_ += len;
+    g_coalescedMessages.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TlsAdbChannel::flush() {
+    if (writeStagingSize_ == 0) {
+        return;
+    }
+    const size_t size = writeStagingSize_;
+    writeStagingSize_ = 0;
+    sealRecord(writeStaging_.data(), size);
+}
+
+void TlsAdbChannel::sealRecord(const uint8_t* data, size_t len) {
     if (!tlsConnection_->WriteFully(std::string_view(reinterpret_cast<const char*>(data), len))) {
         throw std::runtime_error("TlsAdbChannel: write failed");
     }
+    g_writtenBytes.fetch_add(len, std::memory_order_relaxed);
+    g_writeRecords.fetch_add((len + MAX_TLS_RECORD_PLAINTEXT - 1) / MAX_TLS_RECORD_PLAINTEXT,
+                             std::memory_order_relaxed);
 }
 
 void TlsAdbChannel::read(uint8_t* buf, size_t len) {
@@ -70,59 +240,151 @@ void TlsAdbChannel::readWithTimeout(uint8_t* buf, size_t len, int timeoutMs) {
         throw std::runtime_error("TlsAdbChannel: read on closed channel");
     }
 
+    if (decryptRing_) {
+        readFromDecryptRing(buf, len, timeoutMs);
+        return;
+    }
+
     size_t offset = 0;
     const bool hasDeadline = timeoutMs >= 0;
     const auto deadline = hasDeadline
-        ? std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs)
-        : std::chrono::steady_clock::time_point{};
+        ? Clock::now() + std::chrono::milliseconds(timeoutMs)
+        : Clock::time_point{};
 
     while (offset < len) {
+        // 1. 先从明文缓冲取
+        size_t available = bufferTail_ - bufferHead_;
+        if (available > 0) {
+            size_t toCopy = std::min(available, len - offset);
+            std::memcpy(buf + offset, buffer_.data() + bufferHead_, toCopy);
+            bufferHead_ += toCopy;
+            offset += toCopy;
+            continue;
+        }
+
         if (closed_.load()) {
             throw std::runtime_error("TlsAdbChannel: read on closed channel");
         }
 
-        if (tlsConnection_->PendingBytes() == 0) {
-            int waitTimeout = -1;
-            if (hasDeadline) {
-                auto now = std::chrono::steady_clock::now();
-                if (now >= deadline) {
-                    throw std::runtime_error("TlsAdbChannel: read timeout");
-                }
-                waitTimeout = static_cast<int>(
-                    std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()
-                );
-            }
+        // 2. 缓冲为空：大块读取直接解密到目标，小读取先填满缓冲
+        size_t needed = len - offset;
+        if (needed >= BUFFER_SIZE) {
+            waitReadable(hasDeadline, deadline);
+            offset += readSome(buf + offset, needed);
+        } else {
+            fillBuffer(hasDeadline, deadline);
+        }
+    }
+}
 
-            struct pollfd pfd;
-            pfd.fd = fd_;
-            pfd.events = POLLIN;
-            pfd.revents = 0;
-            int pollResult = pollRetryOnEintr(&pfd, 1, waitTimeout);
-            if (pollResult == 0) {
-                throw std::runtime_error("TlsAdbChannel: read timeout");
-            }
-            if (pollResult < 0) {
-                throw std::runtime_error("TlsAdbChannel: poll failed");
-            }
-            if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
-                throw std::runtime_error("TlsAdbChannel: read failed");
-            }
+void TlsAdbChannel::waitReadable(bool hasDeadline, Clock::time_point deadline) {
+    if (tlsConnection_->PendingBytes() > 0) {
+        return;
+    }
+
+    int waitTimeout = -1;
+    if (hasDeadline) {
+        auto now = Clock::now();
+        if (now >= deadline) {
+            throw std::runtime_error("TlsAdbChannel: read timeout");
         }
+        waitTimeout = static_cast<int>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()
+        );
+    }
+
+    struct pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    g_polls.fetch_add(1, std::memory_order_relaxed);
+    g_readSyscalls.fetch_add(1, std::memory_order_relaxed);
+    int pollResult = pollRetryOnEintr(&pfd, 1, waitTimeout);
+    if (pollResult == 0) {
+        throw std::runtime_error("TlsAdbChannel: read timeout");
+    }
+    if (pollResult < 0) {
+        throw std::runtime_error("TlsAdbChannel: poll failed");
+    }
+    if ((pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0) {
+        throw std::runtime_error("TlsAdbChannel: read failed");
+    }
+}
 
-        int bytesRead = tlsConnection_->ReadSome(buf + offset, len - offset);
-        if (bytesRead <= 0) {
-            throw std::runtime_error("TlsAdbChannel: read failed");
+size_t TlsAdbChannel::readSome(uint8_t* dest, size_t len) {
+    g_sslReads.fetch_add(1, std::memory_order_relaxed);
+    g_readSyscalls.fetch_add(SYSCALLS_PER_SSL_READ, std::memory_order_relaxed);
+    const uint64_t cpuBefore = threadCpuNs();
+    int bytesRead = tlsConnection_->ReadSome(dest, len);
+    g_readCpuNs.fetch_add(threadCpuNs() - cpuBefore, std::memory_order_relaxed);
+    if (bytesRead <= 0) {
+        throw std::runtime_error("TlsAdbChannel: read failed");
+    }
+    g_plaintextBytes.fetch_add(static_cast<uint64_t>(bytesRead), std::memory_order_relaxed);
+    return static_cast<size_t>(bytesRead);
+}
+
+void TlsAdbChannel::fillBuffer(bool hasDeadline, Clock::time_point deadline) {
+    bufferHead_ = 0;
+    bufferTail_ = 0;
+
+    waitReadable(hasDeadline, deadline);
+    bufferTail_ = readSome(buffer_.data(), BUFFER_SIZE);
+
+    // 一次 SSL_read 最多返回一条记录；socket 上已排着完整的后续记录时继续排空，后面的小读取就不必再 poll。
+    // 只有部分记录到达时不能读：fd 是阻塞的，SSL_read 会等剩下的字节，把已解密的明文一起压住
+    while (BUFFER_SIZE - bufferTail_ >= MAX_TLS_RECORD_PLAINTEXT) {
+        if (tlsConnection_->PendingBytes() == 0 && !wholeRecordQueued(fd_)) {
+            break;
         }
-        offset += static_cast<size_t>(bytesRead);
+        bufferTail_ += readSome(buffer_.data() + bufferTail_, BUFFER_SIZE - bufferTail_);
     }
 }
 
+std::string TlsAdbChannel::statsJson() {
+    const uint64_t bytes = g_plaintextBytes.load(std::memory_order_relaxed);
+    const uint64_t polls = g_polls.load(std::memory_order_relaxed);
+    const uint64_t reads = g_sslReads.load(std::memory_order_relaxed);
+    const uint64_t writtenBytes = g_writtenBytes.load(std::memory_order_relaxed);
+    const uint64_t writeRecords = g_writeRecords.load(std::memory_order_relaxed);
+    const uint64_t syscalls = g_readSyscalls.load(std::memory_order_relaxed);
+    const double cpuMs = static_cast<double>(g_readCpuNs.load(std::memory_order_relaxed)) / 1e6;
+    const double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::ostringstream oss;
+    oss << "{\"decryptPipeline\":" << (g_decryptPipelineEnabled.load() ? "true" : "false")
+        << ",\"plaintextBytes\":" << bytes
+        << ",\"polls\":" << polls
+        << ",\"sslReads\":" << reads
+        << ",\"pollsPerMB\":" << (mb > 0 ? static_cast<double>(polls) / mb : 0)
+        << ",\"sslReadsPerMB\":" << (mb > 0 ? static_cast<double>(reads) / mb : 0)
+        << ",\"readSyscalls\":" << syscalls
+        << ",\"readSyscallsPerMB\":" << (mb > 0 ? static_cast<double>(syscalls) / mb : 0)
+        << ",\"readCpuMs\":" << cpuMs
+        << ",\"readCpuMsPerMB\":" << (mb > 0 ? cpuMs / mb : 0)
+        << ",\"writtenBytes\":" << writtenBytes
+        << ",\"writeRecords\":" << writeRecords
+        << ",\"coalescedMessages\":" << g_coalescedMessages.load(std::memory_order_relaxed)
+        << ",\"bytesPerRecord\":"
+        << (writeRecords > 0 ? static_cast<double>(writtenBytes) / static_cast<double>(writeRecords) : 0)
+        << "}";
+    return oss.str();
+}
+
 void TlsAdbChannel::close() {
     if (closed_.exchange(true)) {
         return;
     }
     if (fd_ >= 0) {
         ::shutdown(fd_, SHUT_RDWR);
+    }
+    // 解密线程可能还在 poll/SSL_read 这个 fd：先 shutdown 唤醒它并等待退出，再关闭 fd
+    if (decryptRing_) {
+        decryptRing_->close();
+    }
+    if (decryptThread_.joinable() && decryptThread_.get_id() != std::this_thread::get_id()) {
+        decryptThread_.join();
+    }
+    if (fd_ >= 0) {
         ::close(fd_);
         fd_ = -1;
     }
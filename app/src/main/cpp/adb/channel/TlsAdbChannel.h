@@ -3,9 +3,14 @@
 
 #include "adb/core/AdbChannel.h"
 #include "adb/pairing/TlsConnection.h"
+#include "adb/util/RingBuffer.h"
 
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 class TlsAdbChannel : public AdbChannel {
 public:
@@ -13,15 +18,55 @@ public:
     ~TlsAdbChannel() override;
 
     void write(const uint8_t* data, size_t len) override;
+    void writeBuffered(const uint8_t* data, size_t len) override;
+    void flush() override;
     void read(uint8_t* buf, size_t len) override;
     void readWithTimeout(uint8_t* buf, size_t len, int timeoutMs) override;
     void close() override;
     bool isClosed() const override;
 
+    // 解密流水线（可选）：独立线程负责 poll + SSL_read，把明文写入 SPSC 环形缓冲，
+    // readWithTimeout 只从环形缓冲取数据，解密与 ADB 解复用分摊到两个核心。
+    // 必须在 channel 创建后、第一次读取前调用
+    static void setDecryptPipelineEnabled(bool enabled);
+    static bool decryptPipelineEnabled();
+    void startDecryptThread();
+
+    // 进程内所有 TLS 通道的读写统计：明文字节数、poll 次数、SSL_read 次数、TLS 记录数，
+    // 以及读路径每 MB 的系统调用数和解密 CPU
+    static std::string statsJson();
+
 private:
+    using Clock = std::chrono::steady_clock;
+
     std::unique_ptr<scrcpy::pairing::TlsConnection> tlsConnection_;
     int fd_;
     std::atomic<bool> closed_{false};
+
+    // 解密后的明文缓冲，参照 TcpChannel：小读取从缓冲取，大读取直接解密到目标
+    static const size_t BUFFER_SIZE = 65536; // 64KB
+    std::vector<uint8_t> buffer_;
+    size_t bufferHead_ = 0;
+    size_t bufferTail_ = 0;
+
+    // 出站明文暂存：多条 ADB 消息合并成一条 TLS 记录（上限 16KB 明文）
+    std::vector<uint8_t> writeStaging_;
+    size_t writeStagingSize_ = 0;
+
+    void sealRecord(const uint8_t* data, size_t len);
+
+    static const size_t DECRYPT_RING_SIZE = 1024 * 1024; // 1MB
+    std::unique_ptr<RingBuffer> decryptRing_;
+    std::thread decryptThread_;
+    std::atomic<bool> decryptFailed_{false};
+
+    void decryptLoop();
+    void readFromDecryptRing(uint8_t* buf, size_t len, int timeoutMs);
+
+    // SSL 层没有已解密数据时才 poll
+    void waitReadable(bool hasDeadline, Clock::time_point deadline);
+    size_t readSome(uint8_t* dest, size_t len);
+    void fillBuffer(bool hasDeadline, Clock::time_point deadline);
 };
 
 #endif // TLS_ADB_CHANNEL_H
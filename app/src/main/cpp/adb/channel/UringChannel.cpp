@@ -0,0 +1,655 @@
+// UringChannel - 基于 io_uring 的 ADB 通道
+// 直接使用系统调用，不依赖 liburing
+#include "adb/channel/UringChannel.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <hilog/log.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/utsname.h>
+#include <signal.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+// multishot recv（6.0）是最晚引入的依赖，编译期以它为准
+#if defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#define SCRCPY_HAS_IO_URING 1
+#else
+#define SCRCPY_HAS_IO_URING 0
+#endif
+
+#undef LOG_TAG
+#define LOG_TAG "UringChannel"
+
+namespace {
+std::atomic<bool> g_enabled{false};
+std::atomic<int> g_supported{-1};
+std::atomic<uint32_t> g_channels{0};
+std::atomic<uint64_t> g_bytesIn{0};
+std::atomic<uint64_t> g_bytesOut{0};
+std::atomic<uint64_t> g_recvCompletions{0};
+std::atomic<uint64_t> g_recvRearms{0};
+std::atomic<uint64_t> g_sendBatches{0};
+std::atomic<uint64_t> g_sendSqes{0};
+std::atomic<uint64_t> g_enterCalls{0};
+
+constexpr uint64_t RECV_TAG = 0x52454356; // "RECV"
+constexpr uint16_t BUFFER_GROUP = 0;
+constexpr unsigned RECV_RING_ENTRIES = 16;
+constexpr unsigned SEND_RING_ENTRIES = 8;
+}
+
+#if SCRCPY_HAS_IO_URING
+
+struct UringChannel::Ring {
+    int fd = -1;
+    unsigned features = 0;
+    unsigned sqEntries = 0;
+
+    void* sqPtr = MAP_FAILED;
+    size_t sqSize = 0;
+    void* cqPtr = MAP_FAILED;
+    size_t cqSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned localTail = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqPtr != MAP_FAILED && cqPtr != sqPtr) munmap(cqPtr, cqSize);
+        if (sqPtr != MAP_FAILED) munmap(sqPtr, sqSize);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool init(unsigned entries) {
+        io_uring_params params {};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+        features = params.features;
+        sqEntries = params.sq_entries;
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMmap = (features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqSize = cqSize = std::max(sqSize, cqSize);
+        }
+        sqPtr = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqPtr == MAP_FAILED) {
+            return false;
+        }
+        cqPtr = singleMmap ? sqPtr
+                           : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                  IORING_OFF_CQ_RING);
+        if (cqPtr == MAP_FAILED) {
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        auto* sq = static_cast<uint8_t*>(sqPtr);
+        auto* cq = static_cast<uint8_t*>(cqPtr);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        auto* sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < params.sq_entries; ++i) {
+            sqArray[i] = i;
+        }
+        localTail = *sqTail;
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    io_uring_sqe* nextSqe() {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (localTail - head >= sqEntries) {
+            return nullptr;
+        }
+        io_uring_sqe* sqe = &sqes[localTail & sqMask];
+        std::memset(sqe, 0, sizeof(*sqe));
+        ++localTail;
+        return sqe;
+    }
+
+    // 已发布但内核尚未取走的 SQE 数
+    unsigned publish() {
+        __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+        return localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+    }
+
+    int enter(unsigned toSubmit, unsigned waitNr, unsigned flags, const void* arg, size_t argSize) {
+        g_enterCalls.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, waitNr, flags, arg, argSize));
+    }
+
+    bool peek(io_uring_cqe& out) {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        out = cqes[head & cqMask];
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+};
+
+namespace {
+bool kernelAtLeast(int wantMajor, int wantMinor) {
+    struct utsname name {};
+    if (uname(&name) != 0) {
+        return false;
+    }
+    int major = 0;
+    int minor = 0;
+    if (std::sscanf(name.release, "%d.%d", &major, &minor) != 2) {
+        return false;
+    }
+    return major > wantMajor || (major == wantMajor && minor >= wantMinor);
+}
+
+// 不经 io_uring_buf_ring::bufs 访问：C++ 下 __DECLARE_FLEX_ARRAY 里的空 struct 占 1 字节，bufs 偏移变成 8
+io_uring_buf* bufRingEntries(void* ptr) {
+    return static_cast<io_uring_buf*>(ptr);
+}
+}
+
+bool UringChannel::supported() {
+    int cached = g_supported.load();
+    if (cached >= 0) {
+        return cached == 1;
+    }
+
+    bool ok = false;
+    // multishot recv 需要 6.0，provided buffer ring 需要 5.19
+    if (kernelAtLeast(6, 0)) {
+        Ring ring;
+        if (ring.init(4) && (ring.features & IORING_FEAT_EXT_ARG) != 0 &&
+            (ring.features & IORING_FEAT_NODROP) != 0) {
+            constexpr unsigned PROBE_OPS = 256;
+            std::vector<uint8_t> probeStorage(sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op));
+            auto* probe = reinterpret_cast<io_uring_probe*>(probeStorage.data());
+            if (syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_PROBE, probe, PROBE_OPS) == 0) {
+                auto opSupported = [probe](unsigned op) {
+                    return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+                };
+                ok = opSupported(IORING_OP_RECV) && opSupported(IORING_OP_WRITE_FIXED);
+            }
+        }
+    }
+    g_supported.store(ok ? 1 : 0);
+    OH_LOG_INFO(LOG_APP, "UringChannel: io_uring %{public}s", ok ? "supported" : "not supported, using TcpChannel");
+    return ok;
+}
+
+UringChannel* UringChannel::create(int fd) {
+    if (fd < 0 || !supported()) {
+        return nullptr;
+    }
+    auto* channel = new UringChannel(fd);
+    if (!channel->init()) {
+        OH_LOG_WARN(LOG_APP, "UringChannel: ring setup failed errno=%{public}d, using TcpChannel", errno);
+        // 尚未接管 fd，析构时不能关闭它
+        channel->fd_.store(-1);
+        channel->closed_.store(true);
+        delete channel;
+        return nullptr;
+    }
+    return channel;
+}
+
+bool UringChannel::init() {
+    recvRing_ = new Ring();
+    if (!recvRing_->init(RECV_RING_ENTRIES)) {
+        return false;
+    }
+
+    bufRingSize_ = RECV_BUFFERS * sizeof(io_uring_buf);
+    bufRing_ = mmap(nullptr, bufRingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bufRing_ == MAP_FAILED) {
+        bufRing_ = nullptr;
+        return false;
+    }
+    io_uring_buf_reg reg {};
+    reg.ring_addr = reinterpret_cast<uint64_t>(bufRing_);
+    reg.ring_entries = RECV_BUFFERS;
+    reg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, recvRing_->fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        return false;
+    }
+    recvBuffers_.resize(RECV_BUFFERS * RECV_BUFFER_SIZE);
+    for (uint16_t bid = 0; bid < RECV_BUFFERS; ++bid) {
+        recycle(bid);
+    }
+
+    sendRing_ = new Ring();
+    if (!sendRing_->init(SEND_RING_ENTRIES)) {
+        return false;
+    }
+    sendBuffer_.resize(SEND_BUFFER_SIZE);
+    struct iovec iov {};
+    iov.iov_base = sendBuffer_.data();
+    iov.iov_len = sendBuffer_.size();
+    if (syscall(__NR_io_uring_register, sendRing_->fd, IORING_REGISTER_BUFFERS, &iov, 1) != 0) {
+        return false;
+    }
+    return true;
+}
+
+void UringChannel::start(std::vector<uint8_t> pending) {
+    pending_ = std::move(pending);
+    pendingOffset_ = 0;
+    g_channels.fetch_add(1, std::memory_order_relaxed);
+    armRecv();
+    OH_LOG_INFO(LOG_APP, "UringChannel: started fd=%{public}d pending=%{public}zu", fd_.load(), pending_.size());
+}
+
+void UringChannel::recycle(uint16_t bid) {
+    io_uring_buf* entries = bufRingEntries(bufRing_);
+    io_uring_buf* buf = &entries[bufTail_ & (RECV_BUFFERS - 1)];
+    buf->addr = reinterpret_cast<uint64_t>(recvBuffers_.data() + static_cast<size_t>(bid) * RECV_BUFFER_SIZE);
+    buf->len = static_cast<uint32_t>(RECV_BUFFER_SIZE);
+    buf->bid = bid;
+    ++bufTail_;
+    // tail 与 bufs[0].resv 重叠
+    __atomic_store_n(&entries[0].resv, bufTail_, __ATOMIC_RELEASE);
+}
+
+void UringChannel::armRecv() {
+    const int fd = fd_.load();
+    if (fd < 0) {
+        throw std::runtime_error("UringChannel: channel closed");
+    }
+    io_uring_sqe* sqe = recvRing_->nextSqe();
+    if (!sqe) {
+        throw std::runtime_error("UringChannel: submission queue full");
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = RECV_TAG;
+    unsigned toSubmit = recvRing_->publish();
+    if (recvRing_->enter(toSubmit, 0, 0, nullptr, 0) < 0) {
+        throw std::runtime_error("UringChannel: recv submit failed: " + std::string(strerror(errno)));
+    }
+    recvArmed_ = true;
+    g_recvRearms.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool UringChannel::reapRecv(int timeoutMs) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeoutMs, 0));
+    while (true) {
+        bool got = false;
+        io_uring_cqe cqe {};
+        while (recvRing_->peek(cqe)) {
+            if (cqe.user_data != RECV_TAG) {
+                continue;
+            }
+            got = true;
+            if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+                recvArmed_ = false;
+            }
+            if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER) != 0) {
+                completions_.push_back({static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT),
+                                        static_cast<uint32_t>(cqe.res)});
+                g_recvCompletions.fetch_add(1, std::memory_order_relaxed);
+            } else if (cqe.res == 0) {
+                eof_ = true;
+            } else if (cqe.res != -ENOBUFS) {
+                // ENOBUFS：缓冲全在读者手里，归还后重新挂 recv 即可
+                recvError_ = -cqe.res;
+            }
+        }
+        if (got) {
+            return true;
+        }
+        if (closed_.load()) {
+            throw std::runtime_error("UringChannel: read on closed channel");
+        }
+        if (!recvArmed_) {
+            armRecv();
+        }
+
+        int ret;
+        if (timeoutMs < 0) {
+            ret = recvRing_->enter(0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        } else {
+            auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                return false;
+            }
+            __kernel_timespec ts {};
+            ts.tv_sec = remaining / 1000000000LL;
+            ts.tv_nsec = remaining % 1000000000LL;
+            io_uring_getevents_arg arg {};
+            arg.sigmask_sz = _NSIG / 8;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+            ret = recvRing_->enter(0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+        }
+        if (ret < 0 && errno != EINTR && errno != ETIME && errno != EBUSY) {
+            throw std::runtime_error("UringChannel: wait failed: " + std::string(strerror(errno)));
+        }
+    }
+}
+
+size_t UringChannel::readSome(uint8_t* dest, size_t len, int timeoutMs) {
+    if (pendingOffset_ < pending_.size()) {
+        size_t n = std::min(len, pending_.size() - pendingOffset_);
+        std::memcpy(dest, pending_.data() + pendingOffset_, n);
+        pendingOffset_ += n;
+        if (pendingOffset_ == pending_.size()) {
+            std::vector<uint8_t>().swap(pending_);
+            pendingOffset_ = 0;
+        }
+        return n;
+    }
+
+    while (true) {
+        if (currentBid_ >= 0) {
+            size_t n = std::min(len, static_cast<size_t>(currentLen_ - currentOffset_));
+            std::memcpy(dest, recvBuffers_.data() + static_cast<size_t>(currentBid_) * RECV_BUFFER_SIZE + currentOffset_,
+                        n);
+            currentOffset_ += static_cast<uint32_t>(n);
+            if (currentOffset_ == currentLen_) {
+                recycle(static_cast<uint16_t>(currentBid_));
+                currentBid_ = -1;
+            }
+            g_bytesIn.fetch_add(n, std::memory_order_relaxed);
+            return n;
+        }
+        if (!completions_.empty()) {
+            Completion completion = completions_.front();
+            completions_.pop_front();
+            currentBid_ = completion.bid;
+            currentLen_ = completion.len;
+            currentOffset_ = 0;
+            continue;
+        }
+        if (eof_ || recvError_ != 0) {
+            throw std::runtime_error("UringChannel: read failed or connection closed");
+        }
+        if (!reapRecv(timeoutMs)) {
+            return 0;
+        }
+    }
+}
+
+void UringChannel::read(uint8_t* buf, size_t len) {
+    readWithTimeout(buf, len, -1);
+}
+
+void UringChannel::readWithTimeout(uint8_t* buf, size_t len, int timeoutMs) {
+    if (closed_.load()) {
+        throw std::runtime_error("UringChannel: read on closed channel");
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::max(timeoutMs, 0));
+    size_t total = 0;
+    while (total < len) {
+        int remainingMs = -1;
+        if (timeoutMs >= 0) {
+            remainingMs = static_cast<int>(std::max<int64_t>(0,
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count()));
+        }
+        size_t n = readSome(buf + total, len - total, remainingMs);
+        if (n == 0) {
+            throw std::runtime_error("UringChannel: read timeout");
+        }
+        total += n;
+    }
+}
+
+void UringChannel::appendLocked(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        if (staged_ == sendBuffer_.size()) {
+            flushLocked();
+        }
+        size_t n = std::min(len, sendBuffer_.size() - staged_);
+        std::memcpy(sendBuffer_.data() + staged_, data, n);
+        staged_ += n;
+        data += n;
+        len -= n;
+    }
+}
+
+void UringChannel::flushLocked() {
+    size_t offset = 0;
+    while (offset < staged_) {
+        // 每块一个 WRITE_FIXED，链式提交；短写或失败会让后续块 ECANCELED，下一轮从断点续发
+        size_t chunkLens[SEND_BUFFER_SIZE / SEND_CHUNK_SIZE] = {};
+        unsigned count = 0;
+        for (size_t pos = offset; pos < staged_ && count < SEND_BUFFER_SIZE / SEND_CHUNK_SIZE; ++count) {
+            size_t chunk = std::min(SEND_CHUNK_SIZE, staged_ - pos);
+            io_uring_sqe* sqe = sendRing_->nextSqe();
+            if (!sqe) {
+                break;
+            }
+            sqe->opcode = IORING_OP_WRITE_FIXED;
+            sqe->fd = fd_.load();
+            sqe->addr = reinterpret_cast<uint64_t>(sendBuffer_.data() + pos);
+            sqe->len = static_cast<uint32_t>(chunk);
+            sqe->off = 0;
+            sqe->buf_index = 0;
+            sqe->user_data = count;
+            chunkLens[count] = chunk;
+            pos += chunk;
+        }
+        if (count == 0) {
+            throw std::runtime_error("UringChannel: submission queue full");
+        }
+        // 最后一个 SQE 不挂链
+        for (unsigned i = 0; i + 1 < count; ++i) {
+            sendRing_->sqes[(sendRing_->localTail - count + i) & sendRing_->sqMask].flags |= IOSQE_IO_LINK;
+        }
+
+        int results[SEND_BUFFER_SIZE / SEND_CHUNK_SIZE] = {};
+        unsigned reaped = 0;
+        while (reaped < count) {
+            unsigned toSubmit = sendRing_->publish();
+            int ret = sendRing_->enter(toSubmit, count - reaped, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (ret < 0 && errno != EINTR && errno != EBUSY) {
+                throw std::runtime_error("UringChannel: write submit failed: " + std::string(strerror(errno)));
+            }
+            io_uring_cqe cqe {};
+            while (sendRing_->peek(cqe)) {
+                if (cqe.user_data < count) {
+                    results[cqe.user_data] = cqe.res;
+                    ++reaped;
+                }
+            }
+        }
+        g_sendBatches.fetch_add(1, std::memory_order_relaxed);
+        g_sendSqes.fetch_add(count, std::memory_order_relaxed);
+
+        size_t advance = 0;
+        for (unsigned i = 0; i < count; ++i) {
+            int res = results[i];
+            if (res > 0 && static_cast<size_t>(res) == chunkLens[i]) {
+                advance += chunkLens[i];
+                continue;
+            }
+            if (res > 0) {
+                advance += static_cast<size_t>(res);
+                break;
+            }
+            if (res == -ECANCELED || res == -EINTR || res == -EAGAIN) {
+                break;
+            }
+            throw std::runtime_error("UringChannel: write failed (broken pipe or closed)");
+        }
+        if (advance == 0 && results[0] <= 0 && results[0] != -EINTR && results[0] != -EAGAIN) {
+            throw std::runtime_error("UringChannel: write failed (broken pipe or closed)");
+        }
+        offset += advance;
+        g_bytesOut.fetch_add(advance, std::memory_order_relaxed);
+    }
+    staged_ = 0;
+}
+
+void UringChannel::writeBuffered(const uint8_t* data, size_t len) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (closed_.load()) {
+        throw std::runtime_error("UringChannel: write on closed channel");
+    }
+    appendLocked(data, len);
+}
+
+void UringChannel::flush() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (closed_.load()) {
+        throw std::runtime_error("UringChannel: write on closed channel");
+    }
+    flushLocked();
+}
+
+void UringChannel::write(const uint8_t* data, size_t len) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (closed_.load()) {
+        throw std::runtime_error("UringChannel: write on closed channel");
+    }
+    appendLocked(data, len);
+    flushLocked();
+}
+
+UringChannel::~UringChannel() {
+    close();
+    delete recvRing_;
+    delete sendRing_;
+    if (bufRing_) {
+        munmap(bufRing_, bufRingSize_);
+    }
+}
+
+#else // !SCRCPY_HAS_IO_URING
+
+struct UringChannel::Ring {};
+
+bool UringChannel::supported() {
+    return false;
+}
+
+UringChannel* UringChannel::create(int fd) {
+    (void)fd;
+    return nullptr;
+}
+
+bool UringChannel::init() {
+    return false;
+}
+
+void UringChannel::start(std::vector<uint8_t> pending) {
+    (void)pending;
+}
+
+void UringChannel::read(uint8_t* buf, size_t len) {
+    readWithTimeout(buf, len, -1);
+}
+
+void UringChannel::readWithTimeout(uint8_t* buf, size_t len, int timeoutMs) {
+    (void)buf;
+    (void)len;
+    (void)timeoutMs;
+    throw std::runtime_error("UringChannel: io_uring not available");
+}
+
+void UringChannel::write(const uint8_t* data, size_t len) {
+    (void)data;
+    (void)len;
+    throw std::runtime_error("UringChannel: io_uring not available");
+}
+
+void UringChannel::writeBuffered(const uint8_t* data, size_t len) {
+    write(data, len);
+}
+
+void UringChannel::flush() {}
+
+UringChannel::~UringChannel() {
+    close();
+}
+
+#endif // SCRCPY_HAS_IO_URING
+
+UringChannel::UringChannel(int fd) : fd_(fd) {
+}
+
+void UringChannel::setEnabled(bool enabled) {
+    g_enabled.store(enabled);
+}
+
+bool UringChannel::enabled() {
+    return g_enabled.load();
+}
+
+void UringChannel::close() {
+    bool expected = false;
+    if (closed_.compare_exchange_strong(expected, true)) {
+        const int fd = fd_.load();
+        OH_LOG_INFO(LOG_APP, "UringChannel: closing fd=%{public}d", fd);
+        if (fd >= 0) {
+            // shutdown 让挂着的 multishot recv 以 0 完成，唤醒阻塞在 io_uring_enter 上的读线程，
+            // 进行中的写也随之失败返回并释放 writeMutex_
+            ::shutdown(fd, SHUT_RDWR);
+            // 持写锁再 close：写路径不会把 SQE 提交到已关闭（或被复用）的 fd 上
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            fd_.store(-1);
+            ::close(fd);
+        }
+        g_channels.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+bool UringChannel::isClosed() const {
+    return closed_.load();
+}
+
+std::string UringChannel::statsJson() {
+    const uint64_t bytesIn = g_bytesIn.load(std::memory_order_relaxed);
+    const uint64_t bytesOut = g_bytesOut.load(std::memory_order_relaxed);
+    const uint64_t enterCalls = g_enterCalls.load(std::memory_order_relaxed);
+    const double megabytes = static_cast<double>(bytesIn + bytesOut) / (1024.0 * 1024.0);
+    std::ostringstream oss;
+    oss << "{\"enabled\":" << (g_enabled.load() ? "true" : "false")
+        << ",\"supported\":" << g_supported.load()
+        << ",\"channels\":" << g_channels.load(std::memory_order_relaxed)
+        << ",\"bytesIn\":" << bytesIn
+        << ",\"bytesOut\":" << bytesOut
+        << ",\"recvCompletions\":" << g_recvCompletions.load(std::memory_order_relaxed)
+        << ",\"recvArms\":" << g_recvRearms.load(std::memory_order_relaxed)
+        << ",\"sendBatches\":" << g_sendBatches.load(std::memory_order_relaxed)
+        << ",\"sendSqes\":" << g_sendSqes.load(std::memory_order_relaxed)
+        << ",\"enterCalls\":" << enterCalls
+        << ",\"enterCallsPerMB\":" << (megabytes > 0.0 ? static_cast<double>(enterCalls) / megabytes : 0.0)
+        << "}";
+    return oss.str();
+}
@@ -0,0 +1,94 @@
+// UringChannel - 基于 io_uring 的 ADB 通道
+// 用于线程模式（handleInLoop / sendLoop）的明文 TCP 连接，减少每 MB 的系统调用与上下文切换：
+//   读：multishot recv + provided buffer ring，一次提交持续收包，数据直接落在内核选好的缓冲里
+//   写：sendLoop 的多条消息先合并进预注册的发送缓冲（IORING_REGISTER_BUFFERS），
+//       按块拆成多个 WRITE_FIXED，用 IOSQE_IO_LINK 串起来一次提交，短写会打断链，保证顺序
+// 收发各用一个 ring，对应 handleIn 线程和 send 线程，互不加锁。
+// 内核不支持（缺少 multishot recv / buffer ring，或被 seccomp 拦截）时 create() 返回 nullptr，调用方继续用 TcpChannel。
+#ifndef URING_CHANNEL_H
+#define URING_CHANNEL_H
+
+#include "adb/core/AdbChannel.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class UringChannel : public AdbChannel {
+public:
+    static constexpr unsigned RECV_BUFFERS = 16;
+    static constexpr size_t RECV_BUFFER_SIZE = 16 * 1024;
+    static constexpr size_t SEND_BUFFER_SIZE = 64 * 1024;
+    static constexpr size_t SEND_CHUNK_SIZE = 16 * 1024;
+
+    // 默认关闭：部分系统的 seccomp 策略对 io_uring 系统调用直接发 SIGSYS
+    static void setEnabled(bool enabled);
+    static bool enabled();
+    // 探测结果会缓存
+    static bool supported();
+
+    // 只建立 ring，不接管 fd；成功后调用方释放原通道的 fd 并调用 start()
+    static UringChannel* create(int fd);
+    // pending 为原通道已读入但未消费的字节
+    void start(std::vector<uint8_t> pending);
+
+    ~UringChannel() override;
+
+    void read(uint8_t* buf, size_t len) override;
+    void readWithTimeout(uint8_t* buf, size_t len, int timeoutMs = -1) override;
+    void write(const uint8_t* data, size_t len) override;
+    void writeBuffered(const uint8_t* data, size_t len) override;
+    void flush() override;
+    void close() override;
+    bool isClosed() const override;
+
+    static std::string statsJson();
+
+    struct Ring;
+
+private:
+    explicit UringChannel(int fd);
+    bool init();
+
+    // 返回拷贝的字节数；超时返回 0
+    size_t readSome(uint8_t* dest, size_t len, int timeoutMs);
+    bool reapRecv(int timeoutMs);
+    void armRecv();
+    void recycle(uint16_t bid);
+    void appendLocked(const uint8_t* data, size_t len);
+    void flushLocked();
+
+    // close() 在任意线程上置 -1；读线程重新挂 recv 时读取，写路径在 writeMutex_ 下读取
+    std::atomic<int> fd_;
+    std::atomic<bool> closed_{false};
+
+    Ring* recvRing_ = nullptr;
+    Ring* sendRing_ = nullptr;
+
+    // provided buffer ring
+    void* bufRing_ = nullptr;
+    size_t bufRingSize_ = 0;
+    uint16_t bufTail_ = 0;
+    std::vector<uint8_t> recvBuffers_;
+    bool recvArmed_ = false;
+    bool eof_ = false;
+    int recvError_ = 0;
+    struct Completion {
+        uint16_t bid;
+        uint32_t len;
+    };
+    std::deque<Completion> completions_;
+    int currentBid_ = -1;
+    uint32_t currentLen_ = 0;
+    uint32_t currentOffset_ = 0;
+    std::vector<uint8_t> pending_;
+    size_t pendingOffset_ = 0;
+
+    std::mutex writeMutex_;
+    std::vector<uint8_t> sendBuffer_;
+    size_t staged_ = 0;
+};
+
+#endif // URING_CHANNEL_H
@@ -1,8 +1,14 @@
 // Adb
 #include "adb/core/Adb.h"
+#include "adb/core/AdbReactor.h"
+#include "adb/core/ReverseBridgeLoop.h"
 #include "adb/channel/TcpChannel.h"
 #include "adb/channel/TlsAdbChannel.h"
+#include "adb/channel/UringChannel.h"
+#include "util/SocketTuning.h"
 #include "adb/pairing/TlsConnection.h"
+#include "adb/pairing/TlsSessionCache.h"
+#include "adb/crypto/AdbTlsCredentials.h"
 #include <cstring>
 #include <stdexcept>
 #include <algorithm>
@@ -11,13 +17,12 @@
 #include <cinttypes>
 #include <chrono>
 #include <memory>
+#include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <openssl/evp.h>
-#include <openssl/pem.h>
-#include <openssl/x509v3.h>
 #include <hilog/log.h>
 
 #undef LOG_TAG
@@ -25,10 +30,7 @@
 
 namespace {
 constexpr size_t MAX_PENDING_WRITE_BYTES = 256 * 1024;
-constexpr int kCertLifetimeSeconds = 10 * 365 * 24 * 60 * 60;
-const char kBasicConstraints[] = "critical,CA:TRUE";
-const char kKeyUsage[] = "critical,keyCertSign,cRLSign,digitalSignature";
-const char kSubjectKeyIdentifier[] = "hash";
+constexpr size_t MIN_PENDING_WRITE_BYTES = 64 * 1024;
 
 uint32_t readU32LE(const uint8_t* data) {
     return static_cast<uint32_t>(data[0])
@@ -52,6 +54,15 @@ std::string shellSingleQuote(const std::string& text) {
     return escaped;
 }
 
+// 流关闭后不再接收新数据，读缓冲与待发送缓冲的预算份额立即让给其余活跃流；
+// 剩余未读数据仍可读完，租约对象随流一起释放
+void releaseStreamBudget(AdbStream* stream) {
+    stream->readBuffer.releaseBudget();
+    if (stream->writeBudget) {
+        stream->writeBudget->release();
+    }
+}
+
 std::string trimTrailingNewlines(std::string text) {
     while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
         text.pop_back();
@@ -204,126 +215,36 @@ void closeFdIfNeeded(int& fd) {
     fd = -1;
 }
 
-void joinThreadIfNeeded(std::thread& thread) {
-    if (!thread.joinable()) {
-        return;
-    }
-    if (thread.get_id() == std::this_thread::get_id()) {
-        thread.detach();
-        return;
+// TLS 会话缓存键：对端 host:port + 客户端公钥指纹（换密钥后不会误用旧会话）
+std::string TlsSessionKey(int fd, const std::string& publicKeyFingerprint) {
+    sockaddr_storage addr {};
+    socklen_t addrLen = sizeof(addr);
+    if (getpeername(fd, reinterpret_cast<sockaddr*>(&addr), &addrLen) != 0) {
+        return "";
     }
-    thread.join();
-}
-
-void writeAllToFd(int fd, const uint8_t* data, size_t len) {
-    size_t offset = 0;
-    while (offset < len) {
-        ssize_t n = ::send(fd, data + offset, len - offset, MSG_NOSIGNAL);
-        if (n < 0 && errno == EINTR) {
-            continue;
-        }
-        if (n <= 0) {
-            throw std::runtime_error("reverse bridge write failed");
-        }
-        offset += static_cast<size_t>(n);
-    }
-}
-
-bssl::UniquePtr<EVP_PKEY> LoadPrivateKey(std::string_view pem) {
-    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())));
-    if (!bio) {
-        return nullptr;
-    }
-    return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
-}
-
-bool AddExtension(X509* cert, int nid, const char* value) {
-    size_t len = std::strlen(value) + 1;
-    std::vector<char> mutableValue(value, value + len);
-    X509V3_CTX context;
-
-    X509V3_set_ctx_nodb(&context);
-    X509V3_set_ctx(&context, cert, cert, nullptr, nullptr, 0);
-    X509_EXTENSION* ext = X509V3_EXT_nconf_nid(nullptr, &context, nid, mutableValue.data());
-    if (!ext) {
-        return false;
+    char host[INET6_ADDRSTRLEN] = {0};
+    int port = 0;
+    if (addr.ss_family == AF_INET) {
+        auto* in = reinterpret_cast<sockaddr_in*>(&addr);
+        inet_ntop(AF_INET, &in->sin_addr, host, sizeof(host));
+        port = ntohs(in->sin_port);
+    } else if (addr.ss_family == AF_INET6) {
+        auto* in6 = reinterpret_cast<sockaddr_in6*>(&addr);
+        inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+        port = ntohs(in6->sin6_port);
+    } else {
+        return "";
     }
-
-    X509_add_ext(cert, ext, -1);
-    X509_EXTENSION_free(ext);
-    return true;
+    return std::string(host) + ":" + std::to_string(port) + "|" + publicKeyFingerprint;
 }
 
-std::string PrivateKeyToPem(EVP_PKEY* pkey) {
-    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
-    if (!bio) {
-        throw std::runtime_error("Failed to allocate PEM BIO");
-    }
-    if (PEM_write_bio_PKCS8PrivateKey(bio.get(), pkey, nullptr, nullptr, 0, nullptr, nullptr) != 1) {
-        throw std::runtime_error("PEM_write_bio_PKCS8PrivateKey failed");
-    }
-    BUF_MEM* mem = nullptr;
-    BIO_get_mem_ptr(bio.get(), &mem);
-    if (!mem || !mem->data || mem->length == 0) {
-        throw std::runtime_error("BIO_get_mem_ptr failed");
-    }
-    return std::string(mem->data, mem->length);
-}
-
-std::string GenerateCertificatePem(EVP_PKEY* pkey) {
-    bssl::UniquePtr<X509> x509(X509_new());
-    if (!x509) {
-        throw std::runtime_error("Unable to allocate X509");
-    }
-    X509_set_version(x509.get(), 2);
-    ASN1_INTEGER_set(X509_get_serialNumber(x509.get()), 1);
-    X509_gmtime_adj(X509_get_notBefore(x509.get()), 0);
-    X509_gmtime_adj(X509_get_notAfter(x509.get()), kCertLifetimeSeconds);
-    if (!X509_set_pubkey(x509.get(), pkey)) {
-        throw std::runtime_error("Unable to set X509 public key");
-    }
-    X509_NAME* name = X509_get_subject_name(x509.get());
-    if (!name) {
-        throw std::runtime_error("Unable to get X509 subject name");
-    }
-    X509_NAME_add_entry_by_txt(name, "C", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("US"), -1, -1, 0);
-    X509_NAME_add_entry_by_txt(name, "O", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("Android"), -1, -1, 0);
-    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("Adb"), -1, -1, 0);
-    if (!X509_set_issuer_name(x509.get(), name)) {
-        throw std::runtime_error("Unable to set X509 issuer name");
-    }
-    if (!AddExtension(x509.get(), NID_basic_constraints, kBasicConstraints) ||
-        !AddExtension(x509.get(), NID_key_usage, kKeyUsage) ||
-        !AddExtension(x509.get(), NID_subject_key_identifier, kSubjectKeyIdentifier)) {
-        throw std::runtime_error("Unable to create X509 extensions");
-    }
-    if (X509_sign(x509.get(), pkey, EVP_sha256()) <= 0) {
-        throw std::runtime_error("Unable to sign X509 certificate");
-    }
-
-    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
-    if (!bio) {
-        throw std::runtime_error("Failed to allocate X509 PEM BIO");
-    }
-    if (PEM_write_bio_X509(bio.get(), x509.get()) != 1) {
-        throw std::runtime_error("PEM_write_bio_X509 failed");
-    }
-    BUF_MEM* mem = nullptr;
-    BIO_get_mem_ptr(bio.get(), &mem);
-    if (!mem || !mem->data || mem->length == 0) {
-        throw std::runtime_error("BIO_get_mem_ptr failed");
-    }
-    return std::string(mem->data, mem->length);
-}
 }
 
 Adb::Adb(AdbChannel* channel) : channel_(channel) {
-    sendRunning_.store(true);
-    sendThread_ = std::thread(&Adb::sendLoop, this);
 }
 
 std::string Adb::normalizeStreamKind(const std::string& streamKind) {
-    if (streamKind == "video" || streamKind == "audio" || streamKind == "control") {
+    if (streamKind == "video" || streamKind == "audio" || streamKind == "control" || streamKind == "bridge") {
         return streamKind;
     }
     return "other";
@@ -337,21 +258,47 @@ size_t Adb::getReadBufferCapacityForKind(const std::string& streamKind) {
     if (normalizedKind == "audio") {
         return 16 * 1024 * 1024;
     }
+    if (normalizedKind == "bridge") {
+        // 桥接流由事件循环直接搬到 socket，缓冲只需覆盖几轮搬运
+        return 1024 * 1024;
+    }
     return 10 * 1024 * 1024;
 }
 
+size_t Adb::getReadBufferMinimumForKind(const std::string& streamKind) {
+    const std::string normalizedKind = normalizeStreamKind(streamKind);
+    if (normalizedKind == "video") {
+        return 8 * 1024 * 1024;
+    }
+    if (normalizedKind == "audio") {
+        return 2 * 1024 * 1024;
+    }
+    if (normalizedKind == "bridge") {
+        return 256 * 1024;
+    }
+    return 1024 * 1024;
+}
+
 Adb::~Adb() {
     close();
+    if (reactorConnection_) {
+        // close() 在 I/O 线程上调用时不会等待，这里确保反应器已不再访问本实例
+        AdbReactor::instance().detach(reactorConnection_);
+    }
 
     // Destroy stream objects only when the ADB instance is destroyed.
     // close() may be triggered by handleIn thread on disconnect, while
     // reader threads are still unwinding from waitForData().
     {
-        std::lock_guard<std::mutex> lock(streamsMutex_);
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
         for (auto& pair : openStreams_) {
             delete pair.second;
         }
         openStreams_.clear();
+        for (AdbStream* retired : retiredStreams_) {
+            delete retired;
+        }
+        retiredStreams_.clear();
         connectionStreams_.clear();
         pendingOpenStreamKinds_.clear();
         pendingIncomingStreamKinds_.clear();
@@ -384,8 +331,12 @@ static AdbMessage readMessageFromChannel(AdbChannel* channel, int timeoutMs = -1
 
 int Adb::connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth) {
     clearLastConnectError();
+    if (!startupTimeline_.active()) {
+        startupTimeline_.begin();
+    }
     // 发送CONNECT消息
     OH_LOG_INFO(LOG_APP, "ADB: Sending CONNECT message...");
+    const auto cnxnStart = std::chrono::steady_clock::now();
     auto connectMsg = AdbProtocol::generateConnect();
     channel_->write(connectMsg.data(), connectMsg.size());
     OH_LOG_INFO(LOG_APP, "ADB: CONNECT sent, waiting for response (timeout 10s)...");
@@ -399,6 +350,7 @@ int Adb::connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth) {
         channel_->close();
         return -4; // Connect Timeout/Error
     }
+    startupTimeline_.addSpan("cnxn", cnxnStart);
 
     OH_LOG_INFO(LOG_APP, "ADB: Received response cmd=0x%{public}x arg0=%{public}u arg1=%{public}u payloadLen=%{public}u",
                 message.command, message.arg0, message.arg1, message.payloadLength);
@@ -406,6 +358,7 @@ int Adb::connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth) {
 
     if (message.command == AdbProtocol::CMD_STLS) {
         OH_LOG_INFO(LOG_APP, "ADB: Received STLS, upgrading transport to TLS...");
+        const auto tlsStart = std::chrono::steady_clock::now();
         int fd = -1;
         try {
             auto tlsRequest = AdbProtocol::generateTlsRequest();
@@ -420,29 +373,46 @@ int Adb::connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth) {
             delete channel_;
             channel_ = nullptr;
 
-            const std::string& privateKeyPem = keyPair.getPrivateKeyPem();
-            bssl::UniquePtr<EVP_PKEY> privateKey = LoadPrivateKey(privateKeyPem);
-            if (!privateKey) {
-                throw std::runtime_error("Failed to load ADB private key for TLS");
-            }
-            const std::string certPem = GenerateCertificatePem(privateKey.get());
-            const std::string normalizedPrivateKeyPem = PrivateKeyToPem(privateKey.get());
-
+            auto credentials = keyPair.getTlsCredentials();
             auto tlsConnection = scrcpy::pairing::TlsConnection::Create(
                 scrcpy::pairing::TlsConnection::Role::Client,
-                certPem,
-                normalizedPrivateKeyPem,
+                credentials->sslCtx.get(),
                 fd
             );
             if (!tlsConnection) {
                 throw std::runtime_error("Failed to create TLS connection");
             }
             tlsConnection->SetCertVerifyCallback([](X509_STORE_CTX*) { return 1; });
+
+            auto& sessionCache = scrcpy::pairing::TlsSessionCache::Instance();
+            const std::string sessionKey = TlsSessionKey(fd, credentials->publicKeyFingerprint);
+            std::vector<uint8_t> cachedSession;
+            if (!sessionKey.empty()) {
+                cachedSession = sessionCache.Get(sessionKey);
+                tlsConnection->SetResumptionSession(cachedSession);
+                tlsConnection->SetNewSessionCallback([sessionKey](std::vector<uint8_t> session) {
+                    scrcpy::pairing::TlsSessionCache::Instance().Put(sessionKey, std::move(session));
+                });
+            }
             if (tlsConnection->DoHandshake() != scrcpy::pairing::TlsConnection::TlsError::Success) {
+                if (!cachedSession.empty()) {
+                    // 下次重连直接走完整握手
+                    sessionCache.Remove(sessionKey);
+                }
                 throw std::runtime_error("TLS handshake failed");
             }
 
-            channel_ = new TlsAdbChannel(std::move(tlsConnection), fd);
+            const bool resumed = tlsConnection->SessionReused();
+            sessionCache.RecordHandshake(resumed);
+            OH_LOG_INFO(LOG_APP, "ADB: TLS %{public}s (cached session %{public}s)",
+                        resumed ? "session resumed" : "full handshake", cachedSession.empty() ? "no" : "yes");
+            auto* tlsChannel = new TlsAdbChannel(std::move(tlsConnection), fd);
+            channel_ = tlsChannel;
+            if (TlsAdbChannel::decryptPipelineEnabled()) {
+                tlsChannel->startDecryptThread();
+                OH_LOG_INFO(LOG_APP, "ADB: TLS decrypt pipeline enabled");
+            }
+            startupTimeline_.addSpan(resumed ? "tls_resume" : "tls_handshake", tlsStart);
             message = readMessageFromChannel(channel_, 10000);
             OH_LOG_INFO(LOG_APP,
                         "ADB: Post-TLS response cmd=0x%{public}x arg0=%{public}u arg1=%{public}u payloadLen=%{public}u",
@@ -461,6 +431,8 @@ int Adb::connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth) {
         }
     }
 
+    const auto authStart = std::chrono::steady_clock::now();
+    const bool authRequired = message.command == AdbProtocol::CMD_AUTH;
     if (message.command == AdbProtocol::CMD_AUTH) {
         OH_LOG_INFO(LOG_APP, "ADB: Got AUTH challenge, signing payload...");
         // 发送签名
@@ -552,6 +524,10 @@ int Adb::connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth) {
 
 
     clearLastConnectError();
+    if (authRequired) {
+        // 包含等待用户在设备上确认授权的时间
+        startupTimeline_.addSpan("auth", authStart);
+    }
     maxData_ = std::min<uint32_t>(message.arg1, AdbProtocol::CONNECT_MAXDATA);
     OH_LOG_INFO(LOG_APP,
                 "ADB: connected, peerMaxData=%{public}u, localMaxData=%{public}u, effectiveMaxData=%{public}u",
@@ -560,20 +536,49 @@ int Adb::connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth) {
                 maxData_);
 
     // 启动后台消息处理
-    handleInRunning_.store(true);
-    handleInThread_ = std::thread(&Adb::handleInLoop, this);
+    startIo();
 
     return 0;
 }
 
+void Adb::startIo() {
+    if (AdbReactor::enabled()) {
+        reactorConnection_ = AdbReactor::instance().attach(this);
+        if (reactorConnection_) {
+            return;
+        }
+        OH_LOG_INFO(LOG_APP, "[ADB] Channel does not support reactor mode, using I/O threads");
+    }
+    if (UringChannel::enabled()) {
+        // 明文 TCP 换成 io_uring 通道；不支持时保留 TcpChannel
+        auto* tcpChannel = dynamic_cast<TcpChannel*>(channel_);
+        UringChannel* uringChannel = tcpChannel ? UringChannel::create(tcpChannel->reactorFd()) : nullptr;
+        if (uringChannel) {
+            std::vector<uint8_t> pending = tcpChannel->takeBufferedBytes();
+            tcpChannel->releaseFd();
+            delete channel_;
+            channel_ = uringChannel;
+            uringChannel->start(std::move(pending));
+        }
+    }
+    sendRunning_.store(true);
+    sendThread_ = std::thread(&Adb::sendLoop, this);
+    handleInRunning_.store(true);
+    handleInThread_ = std::thread(&Adb::handleInLoop, this);
+}
+
 void Adb::handleInLoop() {
     try {
+        StallWatchdog::ThreadScope watchdogScope("adb-recv");
+        ThreadCpuMonitor::Scope cpuScope("demux", "adb-recv");
+        AllocTracker::StageScope allocScope(AllocStage::Demux);
         const size_t HEADER_SIZE = 24;
         uint8_t headerBuf[24];
         std::vector<uint8_t> tempPayload;
         while (handleInRunning_.load() && !isClosed_.load()) {
             // 1. Read Header (24 bytes)
             try {
+                StallWatchdog::WaitScope waitScope("adb_read", -1, StallWatchdog::WaitKind::Idle);
                 channel_->readWithTimeout(headerBuf, HEADER_SIZE, -1);
             } catch (...) {
                 if (isClosed_.load()) break;
@@ -595,6 +600,8 @@ void Adb::handleInLoop() {
             uint32_t arg1 = readU32LE(8);
             uint32_t payloadLen = readU32LE(12);
             // checksum (16) and magic (20) ignored for now
+            FlightRecorder::instance().record(FlightEvent::AdbIn, cmd, arg0, arg1, payloadLen);
+            StallWatchdog::heartbeat();
 
             // OH_LOG_INFO(LOG_APP, "[ADB] Recv Header: cmd=0x%{public}x len=%{public}u", cmd, payloadLen);
 
@@ -606,65 +613,32 @@ void Adb::handleInLoop() {
                 } else {
                     tempPayload.clear();
                 }
-
-                if (arg0 != 0 && arg1 == 0) {
-                    if (!handleIncomingOpen(arg0, tempPayload)) {
-                        auto closeMsg = AdbProtocol::generateClose(0, static_cast<int32_t>(arg0));
-                        writeToChannel(std::move(closeMsg));
-                    }
-                }
+                handleIncomingOpenMessage(arg0, arg1, tempPayload);
                 continue;
             }
 
             // 3. Handle Payload
-            AdbStream* stream = nullptr;
-            if (lastStream_ != nullptr && lastStream_->localId == static_cast<int32_t>(arg1) && !lastStream_->closed) {
-                 stream = lastStream_;
-            } else {
-                std::lock_guard<std::mutex> lock(streamsMutex_);
-                auto it = connectionStreams_.find(static_cast<int32_t>(arg1));
-                if (it != connectionStreams_.end()) {
-                    stream = it->second;
-                    lastStream_ = stream; // Update cache
-                } else {
-                    // connectionStreams_ may no longer contain closed streams (streamClose removes them),
-                    // but openStreams_ keeps ownership for lifecycle safety. Reuse it first to avoid
-                    // creating phantom streams on late CLSE/OKAY packets during shutdown.
-                    auto openIt = openStreams_.find(static_cast<int32_t>(arg1));
-                    if (openIt != openStreams_.end() && !openIt->second->closed.load()) {
-                        stream = openIt->second;
-                        lastStream_ = stream;
-                    } else if (openIt != openStreams_.end()) {
-                        // Known stream already closed; ignore late packets without recreating it.
-                        stream = nullptr;
-                    } else {
-                        std::string streamKind = "other";
-                        auto pendingKindIt = pendingOpenStreamKinds_.find(static_cast<int32_t>(arg1));
-                        if (pendingKindIt != pendingOpenStreamKinds_.end()) {
-                            streamKind = pendingKindIt->second;
-                        }
-                        OH_LOG_DEBUG(LOG_APP, "[ADB] New connection: localId=%{public}u, remoteId=%{public}u",
-                                     arg1, arg0);
-                        stream = createNewStream(static_cast<int32_t>(arg1),
-                                                 static_cast<int32_t>(arg0),
-                                                 static_cast<int32_t>(arg1) > 0,
-                                                 streamKind);
-                        lastStream_ = stream; // Update cache
-                        // notifyAll(); // Moved to after command processing to avoid race condition (e.g. notify before CLSE handled)
-                    }
-                }
-            }
+            AdbStream* stream = resolveIncomingStream(arg0, arg1);
 
             if (cmd == AdbProtocol::CMD_WRTE && stream && payloadLen > 0) {
                 // *** ZERO-COPY PATH ***
                 // Read directly into Stream's RingBuffer.
                 // Do not drop bytes here: ADB must remain a reliable byte stream.
                 // Overload is handled later at the decoded-packet queue layer.
+                if (stream->arrivals.enabled()) {
+                    stream->arrivals.record(stream->readBuffer.totalWritten(),
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch()).count());
+                }
                 size_t remaining = payloadLen;
                 while (remaining > 0) {
                     auto writeInfo = stream->readBuffer.getWritePtr();
                     if (writeInfo.second == 0) {
-                        bool hasSpace = stream->readBuffer.waitForSpace(1, -1);
+                        bool hasSpace = false;
+                        {
+                            StallWatchdog::WaitScope waitScope("ring_space", stream->localId);
+                            hasSpace = stream->readBuffer.waitForSpace(1, -1);
+                        }
                         if (!hasSpace) {
                             // The stream is closing while this payload is already in-flight.
                             // Drain the remaining bytes to keep the ADB connection framed correctly.
@@ -682,12 +656,7 @@ void Adb::handleInLoop() {
                     stream->readBuffer.commitWrite(toRead);
                     remaining -= toRead;
                 }
-
-                if (!stream->closed.load() && !isClosed_.load()) {
-                    auto okayMsg = AdbProtocol::generateOkay(static_cast<int32_t>(arg1),
-                                                             static_cast<int32_t>(arg0));
-                    writeToChannel(std::move(okayMsg));
-                }
+                acknowledgeWrite(stream, arg0, arg1);
 
             } else {
                 // *** NORMAL PATH ***
@@ -696,62 +665,7 @@ void Adb::handleInLoop() {
                      if (tempPayload.size() < payloadLen) tempPayload.resize(payloadLen);
                      channel_->readWithTimeout(tempPayload.data(), payloadLen, -1);
                 }
-                
-                // Process non-WRTE or new-stream messages
-                if (!stream && cmd == AdbProtocol::CMD_WRTE) {
-                     // Maybe new stream (OPEN? No, Device never sends OPEN usually, it sends WRTE to localId)
-                     // If stream not found, we ignore data (already read to temp)
-                     // Respond with CLSE?
-                     // Verify if it is a new connection request?
-                     // Device initiates connection via OPEN?
-                     if (arg0 == 0) { // Should check command, but OPEN is 0x4e45504f
-                        // Logic for new stream...
-                     }
-                }
-
-                // Handle other commands
-                if (cmd == AdbProtocol::CMD_OKAY) {
-                    if (stream) {
-                         {
-                             std::lock_guard<std::mutex> streamWriteLock(stream->writeMutex);
-                             stream->canWrite.store(true);
-                             flushPendingWritesLocked(stream);
-                         }
-                         notifyAll(); // Notify open() or any waiters that stream is ready
-                    }
-                } else if (cmd == AdbProtocol::CMD_CLSE) {
-                    bool firstClose = true;
-                    bool shouldLog = false;
-                    if (stream) {
-                        firstClose = !stream->closed.exchange(true);
-                        stream->readBuffer.close();
-                        {
-                            std::lock_guard<std::mutex> streamWriteLock(stream->writeMutex);
-                            stream->pendingWriteBuffer.clear();
-                            stream->pendingWriteOffset = 0;
-                        }
-                        notifyAll();
-
-                        if (firstClose) {
-                            std::lock_guard<std::mutex> lock(streamsMutex_);
-                            auto it = connectionStreams_.find(static_cast<int32_t>(arg1));
-                            if (it != connectionStreams_.end() && it->second == stream) {
-                                connectionStreams_.erase(it);
-                            }
-                            if (lastStream_ == stream) {
-                                lastStream_ = nullptr;
-                            }
-                            shouldLog = true;
-                        }
-                    }
-
-                    if (shouldLog) {
-                        OH_LOG_DEBUG(LOG_APP, "[ADB] Connection closed: localId=%{public}u", arg1);
-                    }
-                    notifyAll(); // Notify open() or read() that stream is closed
-                } else if (cmd == AdbProtocol::CMD_WRTE && !stream) {
-                     // ...
-                }
+                handleIncomingControl(cmd, arg1, stream);
             }
         }
         OH_LOG_INFO(LOG_APP, "[ADB] handleIn loop exited normally");
@@ -765,13 +679,168 @@ void Adb::handleInLoop() {
     }
 }
 
+void Adb::handleIncomingOpenMessage(uint32_t arg0, uint32_t arg1, const std::vector<uint8_t>& payload) {
+    if (arg0 != 0 && arg1 == 0) {
+        if (!handleIncomingOpen(arg0, payload)) {
+            auto closeMsg = AdbProtocol::generateClose(0, static_cast<int32_t>(arg0));
+            writeToChannel(std::move(closeMsg));
+        }
+    }
+}
+
+AdbStream* Adb::resolveIncomingStream(uint32_t arg0, uint32_t arg1) {
+    if (hasRetiredStreams_.load(std::memory_order_acquire)) {
+        reapRetiredStreams();
+    }
+    AdbStream* stream = nullptr;
+    if (lastStream_ != nullptr && lastStream_->localId == static_cast<int32_t>(arg1) && !lastStream_->closed) {
+         stream = lastStream_;
+    } else {
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
+        auto it = connectionStreams_.find(static_cast<int32_t>(arg1));
+        if (it != connectionStreams_.end()) {
+            stream = it->second;
+            lastStream_ = stream; // Update cache
+        } else {
+            // connectionStreams_ may no longer contain closed streams (streamClose removes them),
+            // but openStreams_ keeps ownership for lifecycle safety. Reuse it first to avoid
+            // creating phantom streams on late CLSE/OKAY packets during shutdown.
+            auto openIt = openStreams_.find(static_cast<int32_t>(arg1));
+            if (openIt != openStreams_.end() && !openIt->second->closed.load()) {
+                stream = openIt->second;
+                lastStream_ = stream;
+            } else if (openIt != openStreams_.end()) {
+                // Known stream already closed; ignore late packets without recreating it.
+                stream = nullptr;
+            } else {
+                std::string streamKind = "other";
+                auto pendingKindIt = pendingOpenStreamKinds_.find(static_cast<int32_t>(arg1));
+                if (pendingKindIt != pendingOpenStreamKinds_.end()) {
+                    streamKind = pendingKindIt->second;
+                }
+                OH_LOG_DEBUG(LOG_APP, "[ADB] New connection: localId=%{public}u, remoteId=%{public}u",
+                             arg1, arg0);
+                stream = createNewStream(static_cast<int32_t>(arg1),
+                                         static_cast<int32_t>(arg0),
+                                         static_cast<int32_t>(arg1) > 0,
+                                         streamKind);
+                lastStream_ = stream; // Update cache
+                // notifyAll(); // Moved to after command processing to avoid race condition (e.g. notify before CLSE handled)
+            }
+        }
+    }
+    return stream;
+}
+
+void Adb::acknowledgeWrite(AdbStream* stream, uint32_t arg0, uint32_t arg1) {
+    recordReadHighWater(stream);
+    notifyStreamEvent(stream);
+
+    if (!stream->closed.load() && !isClosed_.load()) {
+        auto okayMsg = AdbProtocol::generateOkay(static_cast<int32_t>(arg1),
+                                                 static_cast<int32_t>(arg0));
+        writeToChannel(std::move(okayMsg));
+    }
+}
+
+void Adb::completeAsyncOpen(int32_t localId, AdbStream* stream) {
+    if (pendingOpenCallbackCount_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    OpenCallback callback;
+    {
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
+        auto it = pendingOpenCallbacks_.find(localId);
+        if (it == pendingOpenCallbacks_.end()) {
+            return;
+        }
+        callback = std::move(it->second);
+        pendingOpenCallbacks_.erase(it);
+        pendingOpenCallbackCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (stream && (stream->remoteId == 0 || stream->closed.load())) {
+        // 被拒绝时收包线程仍为 CLSE 建了流对象；回调拿不到它，没有持有方，直接交还回收
+        releaseStream(localId);
+        stream = nullptr;
+    }
+    callback(stream);
+}
+
+void Adb::notifyStreamEvent(AdbStream* stream) {
+    std::lock_guard<std::mutex> lock(stream->eventListenerMutex);
+    if (stream->eventListener) {
+        stream->eventListener();
+    }
+}
+
+void Adb::handleIncomingControl(uint32_t cmd, uint32_t arg1, AdbStream* stream) {
+    if (cmd == AdbProtocol::CMD_OKAY) {
+        if (stream) {
+             {
+                 std::lock_guard<ProfiledMutex> streamWriteLock(stream->writeMutex);
+                 stream->canWrite.store(true);
+                 flushPendingWritesLocked(stream);
+             }
+             notifyStreamEvent(stream);
+             notifyAll(); // Notify open() or any waiters that stream is ready
+             completeAsyncOpen(stream->localId, stream);
+        }
+    } else if (cmd == AdbProtocol::CMD_CLSE) {
+        bool firstClose = true;
+        bool shouldLog = false;
+        if (stream) {
+            firstClose = !stream->closed.exchange(true);
+            stream->readBuffer.close();
+            notifyStreamEvent(stream);
+            {
+                std::lock_guard<ProfiledMutex> streamWriteLock(stream->writeMutex);
+                stream->pendingWriteBuffer.clear();
+                stream->pendingWriteOffset = 0;
+            }
+            releaseStreamBudget(stream);
+            notifyAll();
+
+            if (firstClose) {
+                FlightRecorder::instance().record(
+                    FlightEvent::StreamClose, static_cast<uint32_t>(stream->localId),
+                    static_cast<uint32_t>(stream->remoteId),
+                    static_cast<uint32_t>(FlightRecorder::kindCode(stream->streamKind)), 1);
+            }
+            std::lock_guard<ProfiledMutex> lock(streamsMutex_);
+            if (firstClose) {
+                auto it = connectionStreams_.find(static_cast<int32_t>(arg1));
+                if (it != connectionStreams_.end() && it->second == stream) {
+                    connectionStreams_.erase(it);
+                }
+                if (lastStream_ == stream) {
+                    lastStream_ = nullptr;
+                }
+                shouldLog = true;
+            }
+            // 对端 CLSE 之后不会再有该流的消息，持有方也已释放时即可回收
+            stream->remoteClosed = true;
+            if (stream->released) {
+                retireStreamLocked(stream);
+            }
+        }
+
+        if (shouldLog) {
+            OH_LOG_DEBUG(LOG_APP, "[ADB] Connection closed: localId=%{public}u", arg1);
+        }
+        notifyAll(); // Notify open() or read() that stream is closed
+        // OPEN 被拒绝时设备直接回 CLSE
+        completeAsyncOpen(static_cast<int32_t>(arg1), stream);
+    }
+}
+
 int32_t Adb::open(const std::string& destination, bool canMultipleSend, bool allowImmediateClose,
                   const std::string& streamKind) {
     int32_t localId = localIdPool_++;
     if (!canMultipleSend) localId = -localId;
+    const auto openStart = std::chrono::steady_clock::now();
 
     {
-        std::lock_guard<std::mutex> slock(streamsMutex_);
+        std::lock_guard<ProfiledMutex> slock(streamsMutex_);
         pendingOpenStreamKinds_[localId] = normalizeStreamKind(streamKind);
     }
 
@@ -783,10 +852,11 @@ int32_t Adb::open(const std::string& destination, bool canMultipleSend, bool all
     // 等待流建立
     AdbStream* stream = nullptr;
     {
-        std::unique_lock<std::mutex> lock(waitMutex_);
+        StallWatchdog::WaitScope waitScope("stream_open", localId);
+        auto lock = waitMutex_.uniqueLock();
         while (!isClosed_.load()) {
             {
-                std::lock_guard<std::mutex> slock(streamsMutex_);
+                std::lock_guard<ProfiledMutex> slock(streamsMutex_);
                 auto it = openStreams_.find(localId);
                 if (it != openStreams_.end()) {
                     stream = it->second;
@@ -798,7 +868,7 @@ int32_t Adb::open(const std::string& destination, bool canMultipleSend, bool all
     }
 
     if (!stream) {
-        std::lock_guard<std::mutex> slock(streamsMutex_);
+        std::lock_guard<ProfiledMutex> slock(streamsMutex_);
         pendingOpenStreamKinds_.erase(localId);
         throw std::runtime_error("Failed to open stream");
     }
@@ -815,7 +885,7 @@ int32_t Adb::open(const std::string& destination, bool canMultipleSend, bool all
                          stream->remoteId, stream->closed.load(), localId);
             // Cleanup
             {
-                std::lock_guard<std::mutex> slock(streamsMutex_);
+                std::lock_guard<ProfiledMutex> slock(streamsMutex_);
                 pendingOpenStreamKinds_.erase(localId);
                 auto it = connectionStreams_.find(localId);
                 if (it != connectionStreams_.end()) {
@@ -834,15 +904,48 @@ int32_t Adb::open(const std::string& destination, bool canMultipleSend, bool all
         }
     }
 
+    recordStartupOpen(normalizeStreamKind(streamKind), destination, openStart);
     return localId;
 }
 
+void Adb::recordReadHighWater(AdbStream* stream) {
+    const size_t used = stream->readBuffer.size();
+    if (used <= stream->readHighWater) {
+        return;
+    }
+    // 每越过容量的 1/16 记一次，避免逐包刷屏
+    const size_t capacity = stream->readBuffer.capacity();
+    const size_t step = std::max<size_t>(capacity / 16, 1);
+    if (used / step > stream->readHighWater / step) {
+        FlightRecorder::instance().record(FlightEvent::RingHighWater, static_cast<uint32_t>(stream->localId),
+                                          static_cast<uint32_t>(used), static_cast<uint32_t>(capacity),
+                                          static_cast<uint32_t>(FlightRecorder::kindCode(stream->streamKind)));
+    }
+    stream->readHighWater = used;
+}
+
+void Adb::recordStartupOpen(const std::string& streamKind, const std::string& destination,
+                            std::chrono::steady_clock::time_point start) {
+    if (!startupTimeline_.active()) {
+        return;
+    }
+    if (destination == "shell:") {
+        startupTimeline_.addSpan("open:shell", start);
+        return;
+    }
+    if (streamKind == "video" || streamKind == "audio" || streamKind == "control") {
+        // 第一个媒体流可以建立时，说明 server 已经启动并开始监听
+        startupTimeline_.addSpanSinceMark("server_launch", "open:shell");
+        startupTimeline_.addSpan("open:" + streamKind, start);
+    }
+}
+
 std::string Adb::restartOnTcpip(int port) {
     int32_t streamId = open("tcpip:" + std::to_string(port), false);
 
     // 等待流关闭
     {
-        std::unique_lock<std::mutex> lock(waitMutex_);
+        auto lock = waitMutex_.uniqueLock();
         while (!isStreamClosed(streamId) && !isClosed_.load()) {
             waitCv_.wait_for(lock, std::chrono::milliseconds(100));
         }
@@ -856,7 +959,7 @@ std::string Adb::runServiceCommand(const std::string& destination) {
     int32_t streamId = open(destination, true, true);
 
     {
-        std::unique_lock<std::mutex> lock(waitMutex_);
+        auto lock = waitMutex_.uniqueLock();
         while (!isStreamClosed(streamId) && !isClosed_.load()) {
             waitCv_.wait_for(lock, std::chrono::milliseconds(100));
         }
@@ -889,6 +992,7 @@ bool Adb::reverseRemove(const std::string& remote) {
 
 void Adb::pushFile(const uint8_t* fileData, size_t fileLen,
                    const std::string& remotePath, ProcessCallback callback) {
+    const auto pushStart = std::chrono::steady_clock::now();
     int32_t streamId = startPushFile(remotePath);
     try {
         constexpr size_t chunkSize = 64 * 1024;
@@ -909,6 +1013,7 @@ void Adb::pushFile(const uint8_t* fileData, size_t fileLen,
             offset += len;
         }
         finishPushFile(streamId);
+        startupTimeline_.addSpan("server_push", pushStart);
     } catch (...) {
         abortPushFile(streamId);
         throw;
@@ -924,6 +1029,7 @@ void Adb::pushFileFromFd(int fd, uint64_t fileLen,
     constexpr size_t kChunkSize = 64 * 1024;
     constexpr int32_t kDefaultFileMode = 0644;
 
+    const auto pushStart = std::chrono::steady_clock::now();
     int32_t streamId = open("sync:", true);
     AdbStream* stream = getStreamHandle(streamId);
     if (!stream) {
@@ -1037,6 +1143,7 @@ void Adb::pushFileFromFd(int fd, uint64_t fileLen,
         auto quitHeader = AdbProtocol::generateSyncHeader("QUIT", 0);
         streamWriteRaw(stream, quitHeader.data(), quitHeader.size());
         streamClose(streamId);
+        startupTimeline_.addSpan("server_push", pushStart);
     } catch (...) {
         abortPushFile(streamId);
         throw;
@@ -1047,7 +1154,7 @@ int32_t Adb::startPushFile(const std::string& remotePath) {
     int32_t streamId = open("sync:", true);
     AdbStream* stream = nullptr;
     {
-        std::lock_guard<std::mutex> lock(streamsMutex_);
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
         auto it = connectionStreams_.find(streamId);
         if (it != connectionStreams_.end()) {
             stream = it->second;
@@ -1127,7 +1234,7 @@ std::string Adb::runAdbCmd(const std::string& cmd) {
     int32_t streamId = open("shell:" + cmd, true, true);
 
     {
-        std::unique_lock<std::mutex> lock(waitMutex_);
+        auto lock = waitMutex_.uniqueLock();
         while (!isStreamClosed(streamId) && !isClosed_.load()) {
             waitCv_.wait_for(lock, std::chrono::milliseconds(100));
         }
@@ -1142,7 +1249,7 @@ AdbShellCommandResult Adb::execShellCommand(const std::string& cmd) {
         int32_t streamId = open("shell,v2,raw:" + cmd, true, true);
 
         {
-            std::unique_lock<std::mutex> lock(waitMutex_);
+            auto lock = waitMutex_.uniqueLock();
             while (!isStreamClosed(streamId) && !isClosed_.load()) {
                 waitCv_.wait_for(lock, std::chrono::milliseconds(100));
             }
@@ -1172,6 +1279,34 @@ int32_t Adb::tcpForward(int port) {
     return streamId;
 }
 
+void Adb::openAsync(const std::string& destination, OpenCallback callback, const std::string& streamKind) {
+    int32_t localId = localIdPool_++;
+    {
+        std::lock_guard<ProfiledMutex> slock(streamsMutex_);
+        if (isClosed_.load()) {
+            throw std::runtime_error("adb closed");
+        }
+        pendingOpenStreamKinds_[localId] = normalizeStreamKind(streamKind);
+        pendingOpenCallbacks_[localId] = std::move(callback);
+        pendingOpenCallbackCount_.fetch_add(1, std::memory_order_release);
+    }
+    auto openMsg = AdbProtocol::generateOpen(localId, destination);
+    writeToChannel(std::move(openMsg));
+    OH_LOG_DEBUG(LOG_APP, "[ADB] OPEN sent (async): localId=%{public}d dest=%{public}s",
+                 localId, destination.c_str());
+}
+
+uint16_t Adb::forwardListen(uint16_t localPort, const std::string& remote) {
+    if (remote.empty()) {
+        throw std::runtime_error("forward remote is empty");
+    }
+    return ReverseBridgeLoop::instance().addForwardListener(this, localPort, remote);
+}
+
+bool Adb::forwardRemove(uint16_t localPort) {
+    return ReverseBridgeLoop::instance().removeForwardListener(this, localPort);
+}
+
 int32_t Adb::localSocketForward(const std::string& socketName, const std::string& streamKind) {
     int32_t streamId = open("localabstract:" + socketName, true, false, streamKind);
     if (isStreamClosed(streamId)) {
@@ -1181,7 +1316,7 @@ int32_t Adb::localSocketForward(const std::string& socketName, const std::string
 }
 
 AdbStream* Adb::getStreamHandle(int32_t streamId) {
-    std::lock_guard<std::mutex> lock(streamsMutex_);
+    std::lock_guard<ProfiledMutex> lock(streamsMutex_);
     auto it = connectionStreams_.find(streamId);
     if (it != connectionStreams_.end()) {
         AdbStream* stream = it->second;
@@ -1224,7 +1359,11 @@ std::vector<uint8_t> Adb::streamRead(int32_t streamId, size_t size, int32_t time
         // If timeoutMs < 0, wait indefinitely.
         // If timeoutMs == 0, check immediately (non-blocking).
         // If timeoutMs > 0, wait for given duration.
-        bool hasData = stream->readBuffer.waitForData(waitTarget, waitTimeout);
+        bool hasData = false;
+        {
+            StallWatchdog::WaitScope waitScope("ring_data", stream->localId, StallWatchdog::WaitKind::Idle);
+            hasData = stream->readBuffer.waitForData(waitTarget, waitTimeout);
+        }
         
         if (!hasData) {
              if (stream->readBuffer.isClosed()) {
@@ -1301,7 +1440,11 @@ size_t Adb::streamReadToBuffer(AdbStream* stream, uint8_t* dest, size_t destSize
             waitTimeout = remainingTimeoutMs(deadline);
         }
         
-        bool hasData = stream->readBuffer.waitForData(waitTarget, waitTimeout);
+        bool hasData = false;
+        {
+            StallWatchdog::WaitScope waitScope("ring_data", stream->localId, StallWatchdog::WaitKind::Idle);
+            hasData = stream->readBuffer.waitForData(waitTarget, waitTimeout);
+        }
         
         if (!hasData) {
              if (stream->readBuffer.isClosed()) {
@@ -1351,7 +1494,8 @@ void Adb::streamWrite(AdbStream* stream, const uint8_t* data, size_t len) {
     if (!data && len > 0) throw std::runtime_error("Invalid write buffer");
     if (len == 0) return;
 
-    std::unique_lock<std::mutex> streamWriteLock(stream->writeMutex);
+    AllocTracker::StageScope allocScope(AllocStage::StreamWrite);
+    std::unique_lock<ProfiledMutex> streamWriteLock(stream->writeMutex);
     if (stream->closed.load()) throw std::runtime_error("Stream closed");
 
     size_t offset = 0;
@@ -1360,19 +1504,20 @@ void Adb::streamWrite(AdbStream* stream, const uint8_t* data, size_t len) {
             compactPendingWritesLocked(stream);
             flushPendingWritesLocked(stream);
 
-            if (pendingWriteBytesLocked(stream) < MAX_PENDING_WRITE_BYTES) {
+            if (pendingWriteBytesLocked(stream) < pendingWriteLimitLocked(stream)) {
                 break;
             }
 
             streamWriteLock.unlock();
             {
-                std::unique_lock<std::mutex> waitLock(waitMutex_);
+                StallWatchdog::WaitScope waitScope("write_buffer", stream->localId);
+                auto waitLock = waitMutex_.uniqueLock();
                 waitCv_.wait_for(waitLock, std::chrono::milliseconds(100), [this, stream]() {
                     if (isClosed_.load() || stream->closed.load()) {
                         return true;
                     }
-                    std::lock_guard<std::mutex> streamLock(stream->writeMutex);
-                    return pendingWriteBytesLocked(stream) < MAX_PENDING_WRITE_BYTES ||
+                    std::lock_guard<ProfiledMutex> streamLock(stream->writeMutex);
+                    return pendingWriteBytesLocked(stream) < pendingWriteLimitLocked(stream) ||
                            stream->canWrite.load();
                 });
             }
@@ -1384,15 +1529,19 @@ void Adb::streamWrite(AdbStream* stream, const uint8_t* data, size_t len) {
 
         compactPendingWritesLocked(stream);
         const size_t pendingBytes = pendingWriteBytesLocked(stream);
-        if (pendingBytes >= MAX_PENDING_WRITE_BYTES) {
+        const size_t pendingLimit = pendingWriteLimitLocked(stream);
+        if (pendingBytes >= pendingLimit) {
             continue;
         }
 
-        const size_t availableBytes = MAX_PENDING_WRITE_BYTES - pendingBytes;
+        const size_t availableBytes = pendingLimit - pendingBytes;
         const size_t chunkSize = std::min(availableBytes, len - offset);
         stream->pendingWriteBuffer.insert(stream->pendingWriteBuffer.end(),
                                           data + offset,
                                           data + offset + chunkSize);
+        if (stream->writeBudget) {
+            stream->writeBudget->setAllocated(stream->pendingWriteBuffer.capacity());
+        }
         offset += chunkSize;
         flushPendingWritesLocked(stream);
     }
@@ -1433,11 +1582,40 @@ void Adb::flushPendingWritesLocked(AdbStream* stream) {
     }
 }
 
+size_t Adb::streamTryWrite(AdbStream* stream, const uint8_t* data, size_t len) {
+    if (!stream) throw std::runtime_error("Stream not found");
+    if (stream->closed.load()) throw std::runtime_error("Stream closed");
+    if (!data && len > 0) throw std::runtime_error("Invalid write buffer");
+    if (len == 0) return 0;
+
+    AllocTracker::StageScope allocScope(AllocStage::StreamWrite);
+    std::lock_guard<ProfiledMutex> streamWriteLock(stream->writeMutex);
+    if (isClosed_.load()) throw std::runtime_error("ADB closed");
+    if (stream->closed.load()) throw std::runtime_error("Stream closed");
+
+    compactPendingWritesLocked(stream);
+    flushPendingWritesLocked(stream);
+    const size_t pendingBytes = pendingWriteBytesLocked(stream);
+    const size_t pendingLimit = pendingWriteLimitLocked(stream);
+    if (pendingBytes >= pendingLimit) {
+        return 0;
+    }
+
+    const size_t chunkSize = std::min(pendingLimit - pendingBytes, len);
+    stream->pendingWriteBuffer.insert(stream->pendingWriteBuffer.end(), data, data + chunkSize);
+    if (stream->writeBudget) {
+        stream->writeBudget->setAllocated(stream->pendingWriteBuffer.capacity());
+    }
+    flushPendingWritesLocked(stream);
+    return chunkSize;
+}
+
 void Adb::streamWriteRaw(AdbStream* stream, const uint8_t* data, size_t len) {
     size_t offset = 0;
     while (offset < len) {
         {
-            std::unique_lock<std::mutex> lock(waitMutex_);
+            StallWatchdog::WaitScope waitScope("write_credit", stream->localId);
+            auto lock = waitMutex_.uniqueLock();
             waitCv_.wait(lock, [this, stream]() {
                 return isClosed_.load() || stream->closed.load() || stream->canWrite.load();
             });
@@ -1452,7 +1630,7 @@ void Adb::streamWriteRaw(AdbStream* stream, const uint8_t* data, size_t len) {
 
         size_t chunkSize = std::min(static_cast<size_t>(maxData_ - 128), len - offset);
         {
-            std::lock_guard<std::mutex> streamWriteLock(stream->writeMutex);
+            std::lock_guard<ProfiledMutex> streamWriteLock(stream->writeMutex);
             if (stream->closed.load()) {
                 throw std::runtime_error("Stream closed");
             }
@@ -1471,7 +1649,7 @@ void Adb::streamWriteRaw(AdbStream* stream, const uint8_t* data, size_t len) {
 void Adb::streamClose(int32_t streamId) {
     AdbStream* stream = nullptr;
     {
-        std::lock_guard<std::mutex> lock(streamsMutex_);
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
         auto it = connectionStreams_.find(streamId);
         if (it != connectionStreams_.end()) {
             stream = it->second;
@@ -1479,22 +1657,67 @@ void Adb::streamClose(int32_t streamId) {
         }
     }
     if (stream) {
+        FlightRecorder::instance().record(FlightEvent::StreamClose, static_cast<uint32_t>(stream->localId),
+                                          static_cast<uint32_t>(stream->remoteId),
+                                          static_cast<uint32_t>(FlightRecorder::kindCode(stream->streamKind)), 0);
         auto closeMsg = AdbProtocol::generateClose(stream->localId, stream->remoteId);
         writeToChannel(std::move(closeMsg));
 
         stream->closed = true;
         stream->readBuffer.close();
+        notifyStreamEvent(stream);
         {
-            std::lock_guard<std::mutex> streamWriteLock(stream->writeMutex);
+            std::lock_guard<ProfiledMutex> streamWriteLock(stream->writeMutex);
             stream->pendingWriteBuffer.clear();
             stream->pendingWriteOffset = 0;
         }
+        releaseStreamBudget(stream);
         notifyAll();
     }
 }
 
+void Adb::releaseStream(int32_t streamId) {
+    std::lock_guard<ProfiledMutex> lock(streamsMutex_);
+    auto it = openStreams_.find(streamId);
+    if (it == openStreams_.end() || it->second->released) {
+        return;
+    }
+    it->second->released = true;
+    if (it->second->remoteClosed) {
+        retireStreamLocked(it->second);
+    }
+}
+
+void Adb::retireStreamLocked(AdbStream* stream) {
+    openStreams_.erase(stream->localId);
+    auto it = connectionStreams_.find(stream->localId);
+    if (it != connectionStreams_.end() && it->second == stream) {
+        connectionStreams_.erase(it);
+    }
+    retiredStreams_.push_back(stream);
+    hasRetiredStreams_.store(true, std::memory_order_release);
+}
+
+void Adb::reapRetiredStreams() {
+    std::vector<AdbStream*> retired;
+    {
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
+        retired.swap(retiredStreams_);
+        hasRetiredStreams_.store(false, std::memory_order_relaxed);
+        for (AdbStream* stream : retired) {
+            // lastStream_ 只由收包线程读写，在这里清掉而不是在摘除时
+            if (lastStream_ == stream) {
+                lastStream_ = nullptr;
+            }
+        }
+    }
+    for (AdbStream* stream : retired) {
+        delete stream;
+    }
+}
+
 bool Adb::isStreamClosed(int32_t streamId) {
-    std::lock_guard<std::mutex> lock(streamsMutex_);
+    std::lock_guard<ProfiledMutex> lock(streamsMutex_);
     auto it = connectionStreams_.find(streamId);
     if (it == connectionStreams_.end()) return true;
     return it->second->closed;
@@ -1503,7 +1726,7 @@ bool Adb::isStreamClosed(int32_t streamId) {
 std::vector<uint8_t> Adb::streamReadAllBeforeClose(int32_t streamId) {
     AdbStream* stream = nullptr;
     {
-        std::lock_guard<std::mutex> lock(streamsMutex_);
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
         auto it = connectionStreams_.find(streamId);
         if (it != connectionStreams_.end()) {
             stream = it->second;
@@ -1530,6 +1753,10 @@ void Adb::close() {
 
     handleInRunning_.store(false);
 
+    if (reactorConnection_) {
+        AdbReactor::instance().detach(reactorConnection_);
+    }
+
     sendRunning_.store(false);
     if (channel_) {
         // Close the socket before joining worker threads so any blocking read/write
@@ -1546,24 +1773,13 @@ void Adb::close() {
         }
     }
 
-    std::vector<std::shared_ptr<ReverseBridge>> reverseBridges;
-    {
-        std::lock_guard<std::mutex> lock(reverseBridgesMutex_);
-        reverseBridges = reverseBridges_;
-    }
-    for (const auto& bridge : reverseBridges) {
-        if (!bridge) {
-            continue;
-        }
-        bridge->closed.store(true);
-        closeFdIfNeeded(bridge->fd);
-    }
+    ReverseBridgeLoop::instance().closeAll(this);
 
     // Mark all streams closed and wake blocking readers.
     // Stream objects are not deleted here to avoid use-after-free while
     // external consumer threads are still unwinding.
     {
-        std::lock_guard<std::mutex> lock(streamsMutex_);
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
         for (auto& pair : openStreams_) {
             if (pair.second) {
                 pair.second->closed = true;
@@ -1577,6 +1793,8 @@ void Adb::close() {
             }
         }
         lastStream_ = nullptr;
+        pendingOpenCallbacks_.clear();
+        pendingOpenCallbackCount_.store(0, std::memory_order_relaxed);
     }
 
     notifyAll();
@@ -1590,18 +1808,6 @@ void Adb::close() {
         }
     }
 
-    for (const auto& bridge : reverseBridges) {
-        if (!bridge) {
-            continue;
-        }
-        joinThreadIfNeeded(bridge->socketToAdbThread);
-        joinThreadIfNeeded(bridge->adbToSocketThread);
-    }
-    {
-        std::lock_guard<std::mutex> lock(reverseBridgesMutex_);
-        reverseBridges_.clear();
-    }
-
     // 清理流
     // Stream objects are released in ~Adb().
 }
@@ -1630,6 +1836,9 @@ void Adb::writeToChannel(const std::vector<uint8_t>& data) {
          return;
     }
     sendQueue_.enqueue(data);
+    if (reactorConnection_) {
+        AdbReactor::instance().wakeForWrite(reactorConnection_);
+    }
 }
 
 void Adb::writeToChannel(std::vector<uint8_t>&& data) {
@@ -1640,29 +1849,45 @@ void Adb::writeToChannel(std::vector<uint8_t>&& data) {
          return;
     }
     sendQueue_.enqueue(std::move(data));
+    if (reactorConnection_) {
+        AdbReactor::instance().wakeForWrite(reactorConnection_);
+    }
 }
 
 void Adb::sendLoop() {
     OH_LOG_INFO(LOG_APP, "[ADB] Send thread started");
+    StallWatchdog::ThreadScope watchdogScope("adb-send");
+    ThreadCpuMonitor::Scope cpuScope("send", "adb-send");
+    AllocTracker::StageScope allocScope(AllocStage::Send);
     while (sendRunning_.load()) {
         std::vector<uint8_t> data;
         
         // Blocking wait for data
         // Uses internal semaphore for efficient sleep/wake
-        sendQueue_.wait_dequeue(data);
+        {
+            StallWatchdog::WaitScope waitScope("send_queue", -1, StallWatchdog::WaitKind::Idle);
+            sendQueue_.wait_dequeue(data);
+        }
 
         // Check for Poison Pill (empty data) or stopped flag
         if (!sendRunning_.load()) break;
         if (data.empty()) continue; // Should not happen usually unless used as wake-up signal
 
         try {
-            // Blocking Write
-            channel_->write(data.data(), data.size());
+            // 把已排队的消息一起交给 channel 合并（TLS 下合成一条记录），队列清空立即 flush，不额外增加延迟
+            StallWatchdog::WaitScope waitScope("socket_write");
+            do {
+                if (data.empty()) continue;
+                FlightRecorder::instance().recordAdbHeader(FlightEvent::AdbOut, data.data(), data.size());
+                channel_->writeBuffered(data.data(), data.size());
+            } while (sendRunning_.load() && sendQueue_.try_dequeue(data));
+            channel_->flush();
         } catch (const std::exception& e) {
             OH_LOG_ERROR(LOG_APP, "[ADB] Send error: %{public}s", e.what());
             close();
             break;
         }
+        if (!sendRunning_.load()) break;
     }
     OH_LOG_INFO(LOG_APP, "[ADB] Send thread exited");
 }
@@ -1677,10 +1902,18 @@ Adb* Adb::create(int fd) {
     }
 }
 
-Adb* Adb::create(const std::string& ip, int port) {
+Adb* Adb::create(const std::string& ip, int port, int connectTimeoutMs) {
     try {
-        AdbChannel* channel = new TcpChannel(ip, port);
-        return new Adb(channel);
+        const auto connectStart = std::chrono::steady_clock::now();
+        AdbChannel* channel = new TcpChannel(ip, port, connectTimeoutMs);
+        const auto connectEnd = std::chrono::steady_clock::now();
+        Adb* adb = new Adb(channel);
+        adb->remoteHost_ = ip;
+        adb->remotePort_ = port;
+        adb->connectTimeoutMs_ = connectTimeoutMs;
+        adb->startupTimeline_.begin(connectStart);
+        adb->startupTimeline_.addSpan("tcp_connect", connectStart, connectEnd);
+        return adb;
     } catch (const std::exception& e) {
         OH_LOG_ERROR(LOG_APP, "Adb::create(ip, port) failed: %{public}s", e.what());
         return nullptr;
@@ -1690,11 +1923,21 @@ Adb* Adb::create(const std::string& ip, int port) {
 AdbStream* Adb::createNewStream(int32_t localId, int32_t remoteId, bool canMultipleSend,
                                 const std::string& streamKind) {
     const std::string normalizedKind = normalizeStreamKind(streamKind);
-    auto* stream = new AdbStream(getReadBufferCapacityForKind(normalizedKind), normalizedKind);
+    const std::string budgetName = normalizedKind + "#" + std::to_string(localId);
+    auto readBudget = MemoryBudget::instance().acquire(BudgetCategory::StreamRing, budgetName,
+                                                       getReadBufferCapacityForKind(normalizedKind),
+                                                       getReadBufferMinimumForKind(normalizedKind));
+    auto* stream = new AdbStream(RingBuffer::floorCapacity(readBudget->limit()), normalizedKind);
+    stream->readBuffer.attachBudget(std::move(readBudget));
+    stream->writeBudget = MemoryBudget::instance().acquire(BudgetCategory::PendingWrite, budgetName,
+                                                           MAX_PENDING_WRITE_BYTES, MIN_PENDING_WRITE_BYTES);
     stream->localId = localId;
     stream->remoteId = remoteId;
     stream->canMultipleSend = canMultipleSend;
     pendingOpenStreamKinds_.erase(localId);
+    FlightRecorder::instance().record(FlightEvent::StreamOpen, static_cast<uint32_t>(localId),
+                                      static_cast<uint32_t>(remoteId),
+                                      static_cast<uint32_t>(FlightRecorder::kindCode(normalizedKind)));
 
     connectionStreams_[localId] = stream;
     openStreams_[localId] = stream;
@@ -1703,7 +1946,7 @@ AdbStream* Adb::createNewStream(int32_t localId, int32_t remoteId, bool canMulti
 }
 
 void Adb::prepareIncomingStreamKinds(const std::vector<std::string>& streamKinds) {
-    std::lock_guard<std::mutex> lock(streamsMutex_);
+    std::lock_guard<ProfiledMutex> lock(streamsMutex_);
     pendingIncomingStreamKinds_.clear();
     for (const auto& streamKind : streamKinds) {
         pendingIncomingStreamKinds_.push_back(normalizeStreamKind(streamKind));
@@ -1714,6 +1957,13 @@ void Adb::notifyAll() {
     waitCv_.notify_all();
 }
 
+size_t Adb::pendingWriteLimitLocked(const AdbStream* stream) const {
+    if (!stream || !stream->writeBudget) {
+        return MAX_PENDING_WRITE_BYTES;
+    }
+    return stream->writeBudget->limit();
+}
+
 size_t Adb::pendingWriteBytesLocked(const AdbStream* stream) const {
     if (!stream || stream->pendingWriteOffset >= stream->pendingWriteBuffer.size()) {
         return 0;
@@ -1728,10 +1978,17 @@ void Adb::compactPendingWritesLocked(AdbStream* stream) {
     if (stream->pendingWriteOffset >= stream->pendingWriteBuffer.size()) {
         stream->pendingWriteBuffer.clear();
         stream->pendingWriteOffset = 0;
+        // 预算收紧后释放超出上限的空闲容量
+        if (stream->pendingWriteBuffer.capacity() > pendingWriteLimitLocked(stream)) {
+            stream->pendingWriteBuffer.shrink_to_fit();
+        }
+        if (stream->writeBudget) {
+            stream->writeBudget->setAllocated(stream->pendingWriteBuffer.capacity());
+        }
         return;
     }
     if (stream->pendingWriteOffset >= stream->pendingWriteBuffer.size() / 2 ||
-        stream->pendingWriteBuffer.size() > MAX_PENDING_WRITE_BYTES) {
+        stream->pendingWriteBuffer.size() > pendingWriteLimitLocked(stream)) {
         stream->pendingWriteBuffer.erase(stream->pendingWriteBuffer.begin(),
                                          stream->pendingWriteBuffer.begin() + stream->pendingWriteOffset);
         stream->pendingWriteOffset = 0;
@@ -1765,10 +2022,8 @@ int Adb::connectLocalTcpPort(uint16_t port) {
             continue;
         }
 
-        int flag = 1;
-        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&flag), sizeof(flag));
-
         if (::connect(fd, p->ai_addr, p->ai_addrlen) == 0) {
+            SocketTuning::apply(fd, SocketProfile::Bulk, "reverse-bridge");
             break;
         }
 
@@ -1783,71 +2038,8 @@ int Adb::connectLocalTcpPort(uint16_t port) {
     return fd;
 }
 
-void Adb::startReverseBridge(AdbStream* stream, int fd) {
-    auto bridge = std::make_shared<ReverseBridge>();
-    bridge->fd = fd;
-    bridge->stream = stream;
-
-    auto closeBridge = [bridge]() {
-        bool expected = false;
-        if (!bridge->closed.compare_exchange_strong(expected, true)) {
-            return;
-        }
-        closeFdIfNeeded(bridge->fd);
-    };
-
-    bridge->socketToAdbThread = std::thread([this, stream, bridge, closeBridge]() {
-        std::vector<uint8_t> buffer(64 * 1024);
-        try {
-            while (!bridge->closed.load() && !isClosed_.load()) {
-                ssize_t n = ::recv(bridge->fd, buffer.data(), buffer.size(), 0);
-                if (n < 0 && errno == EINTR) {
-                    continue;
-                }
-                if (n <= 0) {
-                    break;
-                }
-                streamWrite(stream, buffer.data(), static_cast<size_t>(n));
-            }
-        } catch (const std::exception& e) {
-            if (!isClosed_.load() && !bridge->closed.load()) {
-                OH_LOG_WARN(LOG_APP, "[ADB] reverse socket->adb exit: %{public}s", e.what());
-            }
-        }
-
-        closeBridge();
-        if (stream && !stream->closed.load()) {
-            streamClose(stream->localId);
-        }
-    });
-
-    bridge->adbToSocketThread = std::thread([this, stream, bridge, closeBridge]() {
-        std::vector<uint8_t> buffer(64 * 1024);
-        try {
-            while (!bridge->closed.load() && !isClosed_.load()) {
-                size_t n = streamReadToBuffer(stream, buffer.data(), buffer.size(), -1, false);
-                if (n == 0) {
-                    if (stream->closed.load()) {
-                        break;
-                    }
-                    continue;
-                }
-                writeAllToFd(bridge->fd, buffer.data(), n);
-            }
-        } catch (const std::exception& e) {
-            if (!isClosed_.load() && !bridge->closed.load()) {
-                OH_LOG_WARN(LOG_APP, "[ADB] reverse adb->socket exit: %{public}s", e.what());
-            }
-        }
-
-        closeBridge();
-        if (stream && !stream->closed.load()) {
-            streamClose(stream->localId);
-        }
-    });
-
-    std::lock_guard<std::mutex> lock(reverseBridgesMutex_);
-    reverseBridges_.push_back(std::move(bridge));
+bool Adb::startReverseBridge(AdbStream* stream, int fd) {
+    return ReverseBridgeLoop::instance().add(this, stream, fd);
 }
 
 bool Adb::handleIncomingOpen(uint32_t remoteId, const std::vector<uint8_t>& payload) {
@@ -1876,30 +2068,70 @@ bool Adb::handleIncomingOpen(uint32_t remoteId, const std::vector<uint8_t>& payl
         return false;
     }
 
+    bool localTarget = false;
+    {
+        std::lock_guard<std::mutex> lock(localReverseTargetsMutex_);
+        localTarget = localReverseTargets_.count(static_cast<uint16_t>(port)) > 0;
+    }
+
     int fd = -1;
-    try {
-        fd = connectLocalTcpPort(static_cast<uint16_t>(port));
-    } catch (const std::exception& e) {
-        OH_LOG_WARN(LOG_APP, "[ADB] Incoming OPEN connect failed: %{public}s", e.what());
-        return false;
+    if (!localTarget) {
+        try {
+            fd = connectLocalTcpPort(static_cast<uint16_t>(port));
+        } catch (const std::exception& e) {
+            OH_LOG_WARN(LOG_APP, "[ADB] Incoming OPEN connect failed: %{public}s", e.what());
+            return false;
+        }
     }
 
     AdbStream* stream = nullptr;
     int32_t localId = localIdPool_++;
     {
-        std::lock_guard<std::mutex> lock(streamsMutex_);
-        std::string streamKind = "other";
+        std::lock_guard<ProfiledMutex> lock(streamsMutex_);
+        // 转发到本机 socket 的连接由 ReverseBridgeLoop 即时搬运，用小缓冲
+        std::string streamKind = localTarget ? "other" : "bridge";
         if (!pendingIncomingStreamKinds_.empty()) {
             streamKind = pendingIncomingStreamKinds_.front();
             pendingIncomingStreamKinds_.pop_front();
         }
         stream = createNewStream(localId, static_cast<int32_t>(remoteId), true, streamKind);
+        if (streamKind == "video" || streamKind == "audio" || streamKind == "control") {
+            // reverse 模式下 server 主动连回来即视为启动完成
+            startupTimeline_.addSpanSinceMark("server_launch", "open:shell");
+            startupTimeline_.mark("accept:" + streamKind);
+        }
         stream->canWrite.store(true);
         lastStream_ = stream;
     }
 
     auto okayMsg = AdbProtocol::generateOkay(localId, static_cast<int32_t>(remoteId));
     writeToChannel(std::move(okayMsg));
-    startReverseBridge(stream, fd);
+    if (localTarget) {
+        bool accepted = false;
+        {
+            // 持锁调用，保证 unregister 返回后不会再有回调
+            std::lock_guard<std::mutex> lock(localReverseTargetsMutex_);
+            auto it = localReverseTargets_.find(static_cast<uint16_t>(port));
+            accepted = it != localReverseTargets_.end() && it->second(stream);
+        }
+        if (!accepted) {
+            streamClose(localId);
+        }
+        return true;
+    }
+    if (!startReverseBridge(stream, fd)) {
+        streamClose(localId);
+        releaseStream(localId);
+    }
     return true;
 }
+
+void Adb::registerLocalReverseTarget(uint16_t port, LocalReverseHandler handler) {
+    std::lock_guard<std::mutex> lock(localReverseTargetsMutex_);
+    localReverseTargets_[port] = std::move(handler);
+}
+
+void Adb::unregisterLocalReverseTarget(uint16_t port) {
+    std::lock_guard<std::mutex> lock(localReverseTargetsMutex_);
+    localReverseTargets_.erase(port);
+}
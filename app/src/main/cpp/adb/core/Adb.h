@@ -5,9 +5,16 @@
 #define ADB_H
 
 #include "adb/core/AdbChannel.h"
+#include "adb/channel/TcpChannel.h"
 #include "adb/core/AdbProtocol.h"
 #include "adb/crypto/AdbKeyPair.h"
 #include "adb/util/RingBuffer.h"
+#include "util/ProfiledMutex.h"
+#include "diag/FlightRecorder.h"
+#include "diag/StallWatchdog.h"
+#include "diag/ThreadCpuMonitor.h"
+#include "util/AllocTracker.h"
+#include "diag/StartupTimeline.h"
 
 #include <cstdint>
 #include <string>
@@ -21,6 +28,8 @@
 #include <functional>
 #include <queue> 
 #include <deque>
+
+struct AdbReactorConnection;
 #include "concurrentqueue/blockingconcurrentqueue.h"
 
 // 进度回调函数类型
@@ -28,6 +37,47 @@
     using ProcessCallback = std::function<void(int progress)>;
     using AuthCallback = std::function<void()>;
 
+// WRTE 到达时刻记录：按读缓冲的写入位置登记每个 WRTE 消息头到达的时刻（steady_clock ns），
+// 读端据此查出某个字节随哪个 WRTE 到达，时钟估计不受读线程调度和缓冲排队延迟影响。
+// 只对调用过 enable() 的流记录；收包线程写，读流线程查。
+class AdbStreamArrivals {
+public:
+    void enable() { enabled_.store(true, std::memory_order_release); }
+    bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    void record(uint64_t position, int64_t arrivalNs) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.size() >= MAX_ENTRIES) {
+            entries_.pop_front();
+        }
+        entries_.push_back({position, arrivalNs});
+    }
+
+    // position 处的字节所在 WRTE 的到达时刻，未知时返回 0；更早的记录随之丢弃
+    int64_t arrivalAt(uint64_t position) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (entries_.size() > 1 && entries_[1].position <= position) {
+            entries_.pop_front();
+        }
+        if (entries_.empty() || entries_.front().position > position) {
+            return 0;
+        }
+        return entries_.front().arrivalNs;
+    }
+
+private:
+    struct Entry {
+        uint64_t position;
+        int64_t arrivalNs;
+    };
+    // 读端长时间不查询时只保留最近的记录
+    static constexpr size_t MAX_ENTRIES = 4096;
+
+    std::atomic<bool> enabled_{false};
+    std::mutex mutex_;
+    std::deque<Entry> entries_;
+};
+
 // 内部流数据结构 (替代ArkTS的BufferStream)
 struct AdbStream {
     int32_t localId = 0;
@@ -36,14 +86,28 @@ struct AdbStream {
     std::string streamKind = "other";
     std::atomic<bool> closed{false};
     std::atomic<bool> canWrite{false};
-    std::mutex writeMutex;
+    ProfiledMutex writeMutex{"AdbStream::writeMutex"};
     std::vector<uint8_t> pendingWriteBuffer;
     size_t pendingWriteOffset = 0;
+    // 待发送缓冲上限由 MemoryBudget 分配（默认 256 KB）
+    std::shared_ptr<BudgetLease> writeBudget;
 
     // 读缓冲区 - 使用 RingBuffer 实现零拷贝。
-    // 容量按流类型区分：
-    // video=64 MiB, audio=16 MiB, other=10 MiB
+    // 期望容量按流类型区分：video=64 MiB, audio=16 MiB, other=10 MiB, bridge=1 MiB，
+    // 实际容量和占用上限由 MemoryBudget 在活跃流之间分配。
     RingBuffer readBuffer;
+    // 读缓冲占用的历史最高值，仅由 handleIn 线程更新，用于飞行记录
+    size_t readHighWater = 0;
+    AdbStreamArrivals arrivals;
+
+    // 流事件监听（reverse 连接事件循环用）：新数据到达、发送额度恢复或流关闭时在收包线程上回调，回调不能阻塞
+    std::mutex eventListenerMutex;
+    std::function<void()> eventListener;
+
+    // 由 Adb::streamsMutex_ 保护：已收到对端 CLSE / 持有方已调用 releaseStream。
+    // 两者都成立后流从表中摘除，由收包线程在处理下一条消息前释放
+    bool remoteClosed = false;
+    bool released = false;
     
     explicit AdbStream(size_t readBufferCapacity, std::string kind = "other")
         : streamKind(std::move(kind)), readBuffer(readBufferCapacity) {}
@@ -66,7 +130,9 @@ public:
     static Adb* create(int fd);
 
     // 通过IP和端口创建并连接ADB实例 (C++直接创建Socket)
-    static Adb* create(const std::string& ip, int port);    // ADB认证连接
+    // connectTimeoutMs 为 TCP 连接的整体截止时间（多地址并行尝试共用）
+    static Adb* create(const std::string& ip, int port,
+                       int connectTimeoutMs = TcpChannel::DEFAULT_CONNECT_TIMEOUT_MS);    // ADB认证连接
     // 如果需要认证，needAuth会被设置为true，此时需要ArkTS弹出授权对话框
     // 返回值: 0=成功, 1=需要用户授权(已发送公钥), -1=失败
     int connect(AdbKeyPair& keyPair, AuthCallback onWaitAuth = nullptr);
@@ -100,6 +166,12 @@ public:
     // TCP端口转发 - 返回stream id
     int32_t tcpForward(int port);
 
+    // 本地端口转发监听（adb forward）：在本机 localPort 上监听（0 表示随机端口），每个接入的连接
+    // 打开一条 remote（如 "tcp:8700"、"localabstract:foo"）流，由共享桥接循环转发；返回实际监听端口
+    uint16_t forwardListen(uint16_t localPort, const std::string& remote);
+    // 停止监听，已建立的连接不受影响
+    bool forwardRemove(uint16_t localPort);
+
     // 本地Socket转发 - 返回stream id
     int32_t localSocketForward(const std::string& socketName, const std::string& streamKind = "other");
 
@@ -119,9 +191,14 @@ public:
     // 向流中写入数据
     void streamWrite(int32_t streamId, const uint8_t* data, size_t len);
     void streamWrite(AdbStream* stream, const uint8_t* data, size_t len);
+    // 非阻塞写：只写入待发送缓冲放得下的部分，返回接受的字节数（可能为 0）
+    size_t streamTryWrite(AdbStream* stream, const uint8_t* data, size_t len);
 
     // 关闭流
     void streamClose(int32_t streamId);
+    // 持有方（reverse/forward 桥接等）关闭流后不再访问它时调用；对端 CLSE 到达后流对象随即回收，
+    // 否则一直留到 ~Adb（对端 CLSE 之前的迟到消息还要靠它识别）
+    void releaseStream(int32_t streamId);
 
     // 流是否已关闭
     bool isStreamClosed(int32_t streamId);
@@ -147,22 +224,52 @@ public:
     std::string getLastConnectError() const;
     void prepareIncomingStreamKinds(const std::vector<std::string>& streamKinds);
 
+    // 进程内 reverse 直通：设备 OPEN tcp:<port> 命中已登记的端口时，不再连本机回环 socket，
+    // 直接把 AdbStream 交给 handler（在收包线程上调用，不能阻塞）；handler 返回 false 时关闭该流
+    using LocalReverseHandler = std::function<bool(AdbStream* stream)>;
+    void registerLocalReverseTarget(uint16_t port, LocalReverseHandler handler);
+    // 返回后 handler 不会再被调用
+    void unregisterLocalReverseTarget(uint16_t port);
+
+    // 非阻塞打开流：发出 OPEN 后立即返回，设备应答时在收包线程上回调（不能阻塞）；
+    // stream 为 nullptr 表示被拒绝。连接关闭时未应答的回调不再调用
+    using OpenCallback = std::function<void(AdbStream* stream)>;
+    void openAsync(const std::string& destination, OpenCallback callback, const std::string& streamKind = "other");
+
+    // 本次连接的启动时间线，create(ip, port) 时以 TCP 连接开始计时
+    StartupTimeline& startupTimeline() { return startupTimeline_; }
+
+    // create(ip, port) 时记录的远端地址，连接池据此打开额外连接；create(fd) 时为空
+    const std::string& remoteHost() const { return remoteHost_; }
+    int remotePort() const { return remotePort_; }
+    int connectTimeoutMs() const { return connectTimeoutMs_; }
+
 private:
     Adb(AdbChannel* channel);
     void setLastConnectError(std::string error);
     void clearLastConnectError();
 
-    struct ReverseBridge {
-        int fd = -1;
-        AdbStream* stream = nullptr;
-        std::thread socketToAdbThread;
-        std::thread adbToSocketThread;
-        std::atomic<bool> closed{false};
-    };
-
     // 后台消息处理线程
     void handleInLoop();
 
+    // 下行消息分发：线程模式（handleInLoop）与反应器模式（AdbReactor）共用
+    void handleIncomingOpenMessage(uint32_t arg0, uint32_t arg1, const std::vector<uint8_t>& payload);
+    AdbStream* resolveIncomingStream(uint32_t arg0, uint32_t arg1);
+    // WRTE 负载已全部写入流缓冲后回 OKAY
+    void acknowledgeWrite(AdbStream* stream, uint32_t arg0, uint32_t arg1);
+    void handleIncomingControl(uint32_t cmd, uint32_t arg1, AdbStream* stream);
+    void notifyStreamEvent(AdbStream* stream);
+    // 取出并调用 openAsync 登记的回调
+    void completeAsyncOpen(int32_t localId, AdbStream* stream);
+    // 需持有 streamsMutex_：从表中摘除，交给收包线程释放
+    void retireStreamLocked(AdbStream* stream);
+    // 收包线程在解析下一条消息前调用，此时没有任何地方再引用已摘除的流
+    void reapRetiredStreams();
+
+    // 认证完成后启动收发：反应器开启且通道支持非阻塞读写时注册到 AdbReactor，否则起 handleIn/send 线程
+    void startIo();
+    friend class AdbReactor;
+
     // 打开一个流
     int32_t open(const std::string& destination, bool canMultipleSend,
                  bool allowImmediateClose = false, const std::string& streamKind = "other");
@@ -180,10 +287,12 @@ private:
 
     bool handleIncomingOpen(uint32_t remoteId, const std::vector<uint8_t>& payload);
     int connectLocalTcpPort(uint16_t port);
-    void startReverseBridge(AdbStream* stream, int fd);
+    bool startReverseBridge(AdbStream* stream, int fd);
     static std::string stripTrailingNulls(const std::vector<uint8_t>& payload);
     static std::string normalizeStreamKind(const std::string& streamKind);
     static size_t getReadBufferCapacityForKind(const std::string& streamKind);
+    static size_t getReadBufferMinimumForKind(const std::string& streamKind);
+    size_t pendingWriteLimitLocked(const AdbStream* stream) const;
 
     // 向流的底层channel写入数据（分块）
     void compactPendingWritesLocked(AdbStream* stream);
@@ -198,11 +307,19 @@ private:
     uint32_t maxData_ = AdbProtocol::CONNECT_MAXDATA;
 
     // 流管理
-    std::mutex streamsMutex_;
+    ProfiledMutex streamsMutex_{"Adb::streamsMutex_"};
     std::unordered_map<int32_t, AdbStream*> connectionStreams_;
     std::unordered_map<int32_t, AdbStream*> openStreams_; // Owner of AdbStream*
+    // 双方都已关闭、持有方也已释放的流，等收包线程回收
+    std::vector<AdbStream*> retiredStreams_;
+    std::atomic<bool> hasRetiredStreams_{false};
     std::unordered_map<int32_t, std::string> pendingOpenStreamKinds_;
+    std::unordered_map<int32_t, OpenCallback> pendingOpenCallbacks_;
+    // pendingOpenCallbacks_ 非空时才查表，OKAY 热路径上不额外加锁
+    std::atomic<uint32_t> pendingOpenCallbackCount_{0};
     std::deque<std::string> pendingIncomingStreamKinds_;
+    std::mutex localReverseTargetsMutex_;
+    std::map<uint16_t, LocalReverseHandler> localReverseTargets_;
 
     // 后台处理线程
     std::thread handleInThread_;
@@ -212,23 +329,32 @@ private:
     std::atomic<bool> sendRunning_{false};
     moodycamel::BlockingConcurrentQueue<std::vector<uint8_t>> sendQueue_;
 
+    // 反应器模式下的连接状态（非空时不使用 handleIn/send 线程，sendQueue_ 由反应器线程排空）
+    std::shared_ptr<AdbReactorConnection> reactorConnection_;
+
     // 等待通知
-    std::mutex waitMutex_;
+    ProfiledMutex waitMutex_{"Adb::waitMutex_"};
     std::condition_variable waitCv_;
 
     // Optimization cache for handleInLoop
     AdbStream* lastStream_ = nullptr;
 
-    std::mutex reverseBridgesMutex_;
-    std::vector<std::shared_ptr<ReverseBridge>> reverseBridges_;
-
     mutable std::mutex lastConnectErrorMutex_;
     std::string lastConnectError_;
 
+    StartupTimeline startupTimeline_;
+
+    std::string remoteHost_;
+    int remotePort_ = 0;
+    int connectTimeoutMs_ = TcpChannel::DEFAULT_CONNECT_TIMEOUT_MS;
+
     // channel写入锁 (由sendLoop管理)
     // std::mutex channelWriteMutex_; // Removed, managed by sendLoop
 
     void sendLoop();
+    void recordReadHighWater(AdbStream* stream);
+    void recordStartupOpen(const std::string& streamKind, const std::string& destination,
+                           std::chrono::steady_clock::time_point start);
 };
 
 #endif // ADB_H
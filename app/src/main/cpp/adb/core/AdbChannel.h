@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <stdexcept>
 
 // ADB通道抽象接口
 class AdbChannel {
@@ -20,9 +21,30 @@ public:
     // 精确读取指定字节数，带超时（阻塞直到读满或超时）
     virtual void readWithTimeout(uint8_t* buf, size_t len, int timeoutMs) = 0;
 
+    // 可合并写入：实现方可以先暂存，直到 flush() 或暂存区满才真正发送
+    // 调用方在发送队列清空时必须调用 flush()，否则数据可能滞留
+    virtual void writeBuffered(const uint8_t* data, size_t len) { write(data, len); }
+
     // 刷新（TCP无需实现）
     virtual void flush() {}
 
+    // 反应器（epoll）模式：返回可注册到 epoll 的 fd，不支持非阻塞读写的通道返回 -1
+    virtual int reactorFd() const { return -1; }
+
+    // 非阻塞读：返回读到的字节数，0 表示暂无数据；对端关闭或出错时抛异常
+    virtual size_t readNonBlocking(uint8_t* buf, size_t len) {
+        (void)buf;
+        (void)len;
+        throw std::runtime_error("AdbChannel: non-blocking read not supported");
+    }
+
+    // 非阻塞写：返回写出的字节数，socket 发送缓冲满时可能为 0；出错时抛异常
+    virtual size_t writeNonBlocking(const uint8_t* data, size_t len) {
+        (void)data;
+        (void)len;
+        throw std::runtime_error("AdbChannel: non-blocking write not supported");
+    }
+
     // 关闭通道
     virtual void close() = 0;
 
@@ -0,0 +1,177 @@
+#include "adb/core/AdbConnectionPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <hilog/log.h>
+#include <sstream>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "AdbConnectionPool"
+#define LOG_DOMAIN 0x3200
+
+AdbConnectionPool::AdbConnectionPool(std::shared_ptr<Adb> primary) : primary_(std::move(primary)) {}
+
+AdbConnectionPool::~AdbConnectionPool() {
+    close();
+}
+
+int AdbConnectionPool::open(int connections, AdbKeyPair& keyPair) {
+    const int target = std::max(1, std::min(connections, MAX_CONNECTIONS));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requested_ = target;
+    }
+    if (!primary_ || primary_->isAdbClosed()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fallbackReason_ = "primary connection closed";
+        return 0;
+    }
+    if (primary_->remoteHost().empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fallbackReason_ = "primary connection has no remote endpoint";
+        assignClassesLocked();
+        return 1;
+    }
+
+    while (connectionCount() < target) {
+        const auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<Adb> extra(
+            Adb::create(primary_->remoteHost(), primary_->remotePort(), primary_->connectTimeoutMs()));
+        std::string failure;
+        if (!extra) {
+            failure = "tcp connect failed";
+        } else {
+            // 不传 onWaitAuth：主连接已授权同一密钥，这里再要求授权说明设备不接受更多传输
+            int ret = extra->connect(keyPair);
+            if (ret != 0) {
+                failure = "connect returned " + std::to_string(ret);
+                const std::string detail = extra->getLastConnectError();
+                if (!detail.empty()) {
+                    failure += " (" + detail + ")";
+                }
+                extra->close();
+            }
+        }
+
+        if (!failure.empty()) {
+            OH_LOG_WARN(LOG_APP, "[AdbPool] Extra connection to %{public}s:%{public}d failed: %{public}s, "
+                        "staying at %{public}d connection(s)",
+                        primary_->remoteHost().c_str(), primary_->remotePort(), failure.c_str(),
+                        connectionCount());
+            std::lock_guard<std::mutex> lock(mutex_);
+            fallbackReason_ = failure;
+            break;
+        }
+
+        const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mutex_);
+        extras_.push_back(std::move(extra));
+        OH_LOG_INFO(LOG_APP, "[AdbPool] Opened extra connection #%{public}zu in %{public}lld ms",
+                    extras_.size(), static_cast<long long>(elapsedMs));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    assignClassesLocked();
+    return static_cast<int>(extras_.size()) + 1;
+}
+
+void AdbConnectionPool::assignClassesLocked() {
+    const size_t video = static_cast<size_t>(AdbTrafficClass::Video);
+    const size_t interactive = static_cast<size_t>(AdbTrafficClass::Interactive);
+    const size_t bulk = static_cast<size_t>(AdbTrafficClass::Bulk);
+    // 0 = 主连接，i = extras_[i - 1]
+    assignment_[video] = extras_.size() >= 1 ? 1 : 0;
+    assignment_[interactive] = extras_.size() >= 2 ? 2 : 0;
+    assignment_[bulk] = 0;
+}
+
+std::shared_ptr<Adb> AdbConnectionPool::connectionFor(AdbTrafficClass trafficClass) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t index = static_cast<size_t>(trafficClass);
+    if (index >= static_cast<size_t>(AdbTrafficClass::Count)) {
+        return primary_;
+    }
+    const int slot = assignment_[index];
+    if (slot <= 0 || static_cast<size_t>(slot) > extras_.size()) {
+        return primary_;
+    }
+    const auto& extra = extras_[static_cast<size_t>(slot) - 1];
+    // 额外连接已断开时回退到主连接，新开的流不受影响
+    if (!extra || extra->isAdbClosed()) {
+        return primary_;
+    }
+    return extra;
+}
+
+std::vector<std::shared_ptr<Adb>> AdbConnectionPool::extraConnections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return extras_;
+}
+
+int AdbConnectionPool::connectionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(extras_.size()) + 1;
+}
+
+void AdbConnectionPool::close() {
+    std::vector<std::shared_ptr<Adb>> extras;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        extras.swap(extras_);
+        assignClassesLocked();
+    }
+    for (auto& extra : extras) {
+        if (extra) {
+            extra->close();
+        }
+    }
+}
+
+AdbTrafficClass AdbConnectionPool::trafficClassForKind(const std::string& kind) {
+    if (kind == "video") {
+        return AdbTrafficClass::Video;
+    }
+    if (kind == "audio" || kind == "control" || kind == "interactive") {
+        return AdbTrafficClass::Interactive;
+    }
+    return AdbTrafficClass::Bulk;
+}
+
+const char* AdbConnectionPool::trafficClassName(AdbTrafficClass trafficClass) {
+    switch (trafficClass) {
+        case AdbTrafficClass::Video:
+            return "video";
+        case AdbTrafficClass::Interactive:
+            return "interactive";
+        default:
+            return "bulk";
+    }
+}
+
+std::string AdbConnectionPool::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+    oss << "{\"requested\":" << requested_
+        << ",\"connections\":" << (extras_.size() + 1)
+        << ",\"assignment\":{";
+    for (size_t i = 0; i < static_cast<size_t>(AdbTrafficClass::Count); ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "\"" << trafficClassName(static_cast<AdbTrafficClass>(i)) << "\":" << assignment_[i];
+    }
+    oss << "},\"closedExtras\":"
+        << std::count_if(extras_.begin(), extras_.end(),
+                         [](const std::shared_ptr<Adb>& adb) { return !adb || adb->isAdbClosed(); })
+        << ",\"fallbackReason\":\"";
+    for (char c : fallbackReason_) {
+        if (c == '"' || c == '\\') {
+            oss << '\\';
+        }
+        oss << c;
+    }
+    oss << "\"}";
+    return oss.str();
+}
@@ -0,0 +1,62 @@
+// AdbConnectionPool - 同一设备的多条 ADB 连接
+// 单连接时所有流共用一个 socket / TLS 会话 / 解复用线程：大文件推送会和视频抢带宽，
+// TLS 解密也只能用到一个核心。连接池对同一 host:port 额外建立认证连接，按流量类型分配：
+//   2 条：视频独占一条，音频/控制与批量传输共用主连接
+//   3 条：视频、音频+控制各一条，批量传输留在主连接
+// 额外连接复用同一密钥对，TLS 凭据和会话缓存都会命中（AdbTlsCredentials / TlsSessionCache），
+// 建连成本主要是一次 TCP + TLS 恢复。任一额外连接失败（设备限制传输数、需要重新授权等）
+// 即停止扩容，未分配到独立连接的类型回退到主连接。
+#ifndef ADB_CONNECTION_POOL_H
+#define ADB_CONNECTION_POOL_H
+
+#include "adb/core/Adb.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class AdbTrafficClass : uint8_t {
+    Video = 0,
+    Interactive,   // 音频 + 控制
+    Bulk,          // 推送 / 安装 / shell 等
+    Count
+};
+
+class AdbConnectionPool {
+public:
+    static constexpr int MAX_CONNECTIONS = 3;
+
+    explicit AdbConnectionPool(std::shared_ptr<Adb> primary);
+    ~AdbConnectionPool();
+
+    // 打开额外连接直到总数达到 connections（含主连接，上限 MAX_CONNECTIONS），返回实际连接数
+    int open(int connections, AdbKeyPair& keyPair);
+
+    std::shared_ptr<Adb> connectionFor(AdbTrafficClass trafficClass) const;
+    std::shared_ptr<Adb> primary() const { return primary_; }
+    // 不含主连接
+    std::vector<std::shared_ptr<Adb>> extraConnections() const;
+    int connectionCount() const;
+
+    // 关闭额外连接（主连接由调用方管理）
+    void close();
+
+    // "video" / "audio" / "control" / "interactive" / "bulk"，其余按 bulk 处理
+    static AdbTrafficClass trafficClassForKind(const std::string& kind);
+    static const char* trafficClassName(AdbTrafficClass trafficClass);
+
+    std::string toJson() const;
+
+private:
+    void assignClassesLocked();
+
+    std::shared_ptr<Adb> primary_;
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<Adb>> extras_;
+    int assignment_[static_cast<size_t>(AdbTrafficClass::Count)] = {0, 0, 0};
+    int requested_ = 1;
+    std::string fallbackReason_;
+};
+
+#endif // ADB_CONNECTION_POOL_H
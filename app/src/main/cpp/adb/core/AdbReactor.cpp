@@ -0,0 +1,569 @@
+#include "adb/core/AdbReactor.h"
+#include "adb/core/Adb.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <hilog/log.h>
+#include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "AdbReactor"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+constexpr int MAX_EVENTS = 64;
+// 单个连接每轮最多处理的字节数，避免一个高码率设备饿死同一线程上的其它连接
+constexpr size_t READ_BUDGET_PER_ROUND = 256 * 1024;
+// 出站合并上限
+constexpr size_t WRITE_COALESCE_BYTES = 64 * 1024;
+constexpr size_t DRAIN_CHUNK = 4096;
+
+std::atomic<bool> g_enabled{false};
+std::atomic<int> g_threads{1};
+
+uint32_t readU32LE(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+}
+
+struct AdbReactorConnection {
+    enum class ReadState { Header, Payload, StreamPayload, Drain };
+
+    Adb* adb = nullptr;
+    AdbChannel* channel = nullptr;
+    int fd = -1;
+    AdbReactor::Loop* loop = nullptr;
+
+    // I/O 线程处理该连接期间持有；detach 通过它等待处理结束
+    std::mutex mutex;
+    std::atomic<bool> dead{false};
+    std::atomic<bool> detached{false};
+    std::atomic<bool> writeScheduled{false};
+
+    // 读状态机（仅 I/O 线程访问）
+    ReadState state = ReadState::Header;
+    uint8_t header[AdbProtocol::ADB_HEADER_LENGTH] = {};
+    size_t headerFill = 0;
+    uint32_t cmd = 0;
+    uint32_t arg0 = 0;
+    uint32_t arg1 = 0;
+    uint32_t payloadLen = 0;
+    size_t remaining = 0;
+    AdbStream* stream = nullptr;
+    std::vector<uint8_t> payload;
+    size_t payloadFill = 0;
+    bool readPaused = false;
+
+    // 写状态（仅 I/O 线程访问）
+    std::vector<uint8_t> outbound;
+    size_t outOffset = 0;
+    bool wantWrite = false;
+    uint32_t interest = 0;
+};
+
+struct AdbReactor::Loop {
+    int index = 0;
+    int epollFd = -1;
+    int wakeFd = -1;
+    std::thread thread;
+    std::thread::id threadId;
+
+    std::mutex mutex;
+    std::unordered_map<int, std::shared_ptr<AdbReactorConnection>> connections;
+    std::vector<std::shared_ptr<AdbReactorConnection>> pending;   // 需要刷写或补一次读取
+    std::vector<std::shared_ptr<AdbReactorConnection>> stalled;   // 流缓冲满，暂停读取，等消费者腾出空间后唤醒
+
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytesIn{0};
+    std::atomic<uint64_t> bytesOut{0};
+    std::atomic<uint64_t> stalls{0};
+
+    void run();
+    void service(const std::shared_ptr<AdbReactorConnection>& conn, bool readable);
+    void readConnection(AdbReactorConnection& conn);
+    void flushWrites(AdbReactorConnection& conn);
+    void updateInterest(AdbReactorConnection& conn);
+    void pauseRead(const std::shared_ptr<AdbReactorConnection>& conn);
+    void resumeRead(const std::shared_ptr<AdbReactorConnection>& conn);
+    void wake();
+};
+
+AdbReactor& AdbReactor::instance() {
+    static AdbReactor* reactor = new AdbReactor();
+    return *reactor;
+}
+
+AdbReactor::~AdbReactor() = default;
+
+void AdbReactor::setEnabled(bool enabled, int threads) {
+    g_threads.store(std::max(1, std::min(threads, MAX_THREADS)));
+    g_enabled.store(enabled);
+}
+
+bool AdbReactor::enabled() {
+    return g_enabled.load();
+}
+
+AdbReactor::Loop* AdbReactor::pickLoop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t wanted = static_cast<size_t>(g_threads.load());
+    while (loops_.size() < wanted) {
+        auto loop = std::make_unique<Loop>();
+        loop->index = static_cast<int>(loops_.size());
+        loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->epollFd < 0 || loop->wakeFd < 0) {
+            OH_LOG_ERROR(LOG_APP, "[AdbReactor] epoll/eventfd setup failed errno=%{public}d", errno);
+            if (loop->epollFd >= 0) ::close(loop->epollFd);
+            if (loop->wakeFd >= 0) ::close(loop->wakeFd);
+            break;
+        }
+        struct epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = loop->wakeFd;
+        epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->wakeFd, &ev);
+        Loop* raw = loop.get();
+        loop->thread = std::thread([raw]() { raw->run(); });
+        loops_.push_back(std::move(loop));
+    }
+    if (loops_.empty()) {
+        return nullptr;
+    }
+
+    // 连接数最少的线程
+    Loop* best = nullptr;
+    size_t bestCount = 0;
+    for (auto& loop : loops_) {
+        std::lock_guard<std::mutex> loopLock(loop->mutex);
+        if (!best || loop->connections.size() < bestCount) {
+            best = loop.get();
+            bestCount = loop->connections.size();
+        }
+    }
+    return best;
+}
+
+std::shared_ptr<AdbReactorConnection> AdbReactor::attach(Adb* adb) {
+    if (!adb || !adb->channel_) {
+        return nullptr;
+    }
+    const int fd = adb->channel_->reactorFd();
+    if (fd < 0) {
+        return nullptr;
+    }
+    Loop* loop = pickLoop();
+    if (!loop) {
+        return nullptr;
+    }
+
+    auto conn = std::make_shared<AdbReactorConnection>();
+    conn->adb = adb;
+    conn->channel = adb->channel_;
+    conn->fd = fd;
+    conn->loop = loop;
+    conn->interest = EPOLLIN;
+
+    {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        struct epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            OH_LOG_ERROR(LOG_APP, "[AdbReactor] epoll add fd=%{public}d failed errno=%{public}d", fd, errno);
+            return nullptr;
+        }
+        loop->connections[fd] = conn;
+        // 握手阶段可能已有数据读进通道缓冲，epoll 不会为它触发，先补一次处理
+        loop->pending.push_back(conn);
+    }
+    loop->wake();
+    OH_LOG_INFO(LOG_APP, "[AdbReactor] Attached fd=%{public}d to loop %{public}d", fd, loop->index);
+    return conn;
+}
+
+void AdbReactor::detach(const std::shared_ptr<AdbReactorConnection>& conn) {
+    if (!conn) {
+        return;
+    }
+    Loop* loop = conn->loop;
+    if (!conn->detached.exchange(true)) {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        epoll_ctl(loop->epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+        auto it = loop->connections.find(conn->fd);
+        if (it != loop->connections.end() && it->second == conn) {
+            loop->connections.erase(it);
+        }
+        loop->stalled.erase(std::remove(loop->stalled.begin(), loop->stalled.end(), conn), loop->stalled.end());
+    }
+    conn->dead.store(true);
+    if (std::this_thread::get_id() != loop->threadId) {
+        // 等 I/O 线程处理完该连接的当前一轮
+        std::lock_guard<std::mutex> wait(conn->mutex);
+    }
+}
+
+void AdbReactor::wakeForWrite(const std::shared_ptr<AdbReactorConnection>& conn) {
+    if (!conn || conn->dead.load()) {
+        return;
+    }
+    if (conn->writeScheduled.exchange(true)) {
+        return;
+    }
+    Loop* loop = conn->loop;
+    {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        loop->pending.push_back(conn);
+    }
+    // I/O 线程自身产生的写（OKAY 回执等）在本轮结束前统一刷出，不必再唤醒
+    if (std::this_thread::get_id() != loop->threadId) {
+        loop->wake();
+    }
+}
+
+void AdbReactor::Loop::wake() {
+    uint64_t one = 1;
+    ssize_t ret = ::write(wakeFd, &one, sizeof(one));
+    (void)ret;
+}
+
+void AdbReactor::Loop::run() {
+    threadId = std::this_thread::get_id();
+    const std::string name = "adb-reactor-" + std::to_string(index);
+    StallWatchdog::ThreadScope watchdogScope(name.c_str());
+    ThreadCpuMonitor::Scope cpuScope("reactor", name.c_str());
+    AllocTracker::StageScope allocScope(AllocStage::Demux);
+
+    struct epoll_event events[MAX_EVENTS];
+    std::vector<std::shared_ptr<AdbReactorConnection>> ready;
+    while (true) {
+        int timeoutMs = -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!pending.empty()) {
+                timeoutMs = 0;
+            }
+        }
+
+        int n = 0;
+        {
+            StallWatchdog::WaitScope waitScope("reactor_wait", -1, StallWatchdog::WaitKind::Idle);
+            n = epoll_wait(epollFd, events, MAX_EVENTS, timeoutMs);
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            OH_LOG_ERROR(LOG_APP, "[AdbReactor] epoll_wait failed errno=%{public}d", errno);
+            break;
+        }
+        StallWatchdog::heartbeat();
+
+        ready.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.fd == wakeFd) {
+                    uint64_t value = 0;
+                    ssize_t ret = ::read(wakeFd, &value, sizeof(value));
+                    (void)ret;
+                    wakeups.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                auto it = connections.find(events[i].data.fd);
+                if (it != connections.end()) {
+                    ready.push_back(it->second);
+                }
+            }
+        }
+        for (const auto& conn : ready) {
+            service(conn, true);
+        }
+
+        // 刷写：包括本轮处理中产生的回执，处理过程中可能继续追加
+        while (true) {
+            std::vector<std::shared_ptr<AdbReactorConnection>> toFlush;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                toFlush.swap(pending);
+            }
+            if (toFlush.empty()) {
+                break;
+            }
+            for (const auto& conn : toFlush) {
+                conn->writeScheduled.store(false);
+                service(conn, true);
+            }
+        }
+    }
+}
+
+void AdbReactor::Loop::service(const std::shared_ptr<AdbReactorConnection>& conn, bool readable) {
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->dead.load()) {
+        return;
+    }
+    try {
+        if (readable || conn->readPaused) {
+            readConnection(*conn);
+            if (conn->readPaused && !conn->dead.load()) {
+                pauseRead(conn);
+            }
+        }
+        if (!conn->dead.load()) {
+            flushWrites(*conn);
+        }
+        if (!conn->dead.load()) {
+            updateInterest(*conn);
+        }
+    } catch (const std::exception& e) {
+        if (!conn->dead.load()) {
+            OH_LOG_ERROR(LOG_APP, "[AdbReactor] ADB connection fd=%{public}d error: %{public}s", conn->fd, e.what());
+            // close() 会在本线程上 detach（不等待），持锁期间调用保证 adb 不会被其它线程析构
+            conn->adb->close();
+        }
+    }
+}
+
+// 流缓冲满：不轮询，由消费线程 consumeRead 腾出空间（或流关闭）时把连接放回 pending 并唤醒本线程
+void AdbReactor::Loop::pauseRead(const std::shared_ptr<AdbReactorConnection>& conn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (conn->detached.load()) {
+            return;
+        }
+        if (std::find(stalled.begin(), stalled.end(), conn) == stalled.end()) {
+            stalled.push_back(conn);
+        }
+    }
+    std::weak_ptr<AdbReactorConnection> weak = conn;
+    const bool armed = conn->stream->readBuffer.notifyWhenWritable([this, weak]() {
+        if (auto target = weak.lock()) {
+            resumeRead(target);
+        }
+    });
+    if (!armed) {
+        // 登记前消费者已经腾出了空间
+        resumeRead(conn);
+    }
+}
+
+void AdbReactor::Loop::resumeRead(const std::shared_ptr<AdbReactorConnection>& conn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::find(stalled.begin(), stalled.end(), conn);
+        if (it == stalled.end()) {
+            return;
+        }
+        stalled.erase(it);
+        pending.push_back(conn);
+    }
+    if (std::this_thread::get_id() != threadId) {
+        wake();
+    }
+}
+
+void AdbReactor::Loop::readConnection(AdbReactorConnection& conn) {
+    Adb* adb = conn.adb;
+    size_t budget = READ_BUDGET_PER_ROUND;
+    conn.readPaused = false;
+
+    while (budget > 0 && !conn.dead.load()) {
+        switch (conn.state) {
+            case AdbReactorConnection::ReadState::Header: {
+                size_t n = conn.channel->readNonBlocking(conn.header + conn.headerFill,
+                                                         sizeof(conn.header) - conn.headerFill);
+                if (n == 0) {
+                    return;
+                }
+                bytesIn.fetch_add(n, std::memory_order_relaxed);
+                budget -= std::min(budget, n);
+                conn.headerFill += n;
+                if (conn.headerFill < sizeof(conn.header)) {
+                    continue;
+                }
+                conn.headerFill = 0;
+                conn.cmd = readU32LE(conn.header);
+                conn.arg0 = readU32LE(conn.header + 4);
+                conn.arg1 = readU32LE(conn.header + 8);
+                conn.payloadLen = readU32LE(conn.header + 12);
+                FlightRecorder::instance().record(FlightEvent::AdbIn, conn.cmd, conn.arg0, conn.arg1,
+                                                  conn.payloadLen);
+                messages.fetch_add(1, std::memory_order_relaxed);
+
+                conn.stream = nullptr;
+                if (conn.cmd != AdbProtocol::CMD_OPEN) {
+                    conn.stream = adb->resolveIncomingStream(conn.arg0, conn.arg1);
+                }
+                if (conn.cmd == AdbProtocol::CMD_WRTE && conn.stream && conn.payloadLen > 0) {
+                    if (conn.stream->arrivals.enabled()) {
+                        conn.stream->arrivals.record(conn.stream->readBuffer.totalWritten(),
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch()).count());
+                    }
+                    conn.remaining = conn.payloadLen;
+                    conn.state = AdbReactorConnection::ReadState::StreamPayload;
+                } else if (conn.payloadLen > 0) {
+                    if (conn.payload.size() < conn.payloadLen) {
+                        conn.payload.resize(conn.payloadLen);
+                    }
+                    conn.payloadFill = 0;
+                    conn.state = AdbReactorConnection::ReadState::Payload;
+                } else if (conn.cmd == AdbProtocol::CMD_OPEN) {
+                    adb->handleIncomingOpenMessage(conn.arg0, conn.arg1, std::vector<uint8_t>());
+                } else {
+                    adb->handleIncomingControl(conn.cmd, conn.arg1, conn.stream);
+                }
+                break;
+            }
+            case AdbReactorConnection::ReadState::Payload: {
+                size_t n = conn.channel->readNonBlocking(conn.payload.data() + conn.payloadFill,
+                                                         conn.payloadLen - conn.payloadFill);
+                if (n == 0) {
+                    return;
+                }
+                bytesIn.fetch_add(n, std::memory_order_relaxed);
+                budget -= std::min(budget, n);
+                conn.payloadFill += n;
+                if (conn.payloadFill < conn.payloadLen) {
+                    continue;
+                }
+                conn.state = AdbReactorConnection::ReadState::Header;
+                if (conn.cmd == AdbProtocol::CMD_OPEN) {
+                    std::vector<uint8_t> openPayload(conn.payload.begin(), conn.payload.begin() + conn.payloadLen);
+                    adb->handleIncomingOpenMessage(conn.arg0, conn.arg1, openPayload);
+                } else {
+                    adb->handleIncomingControl(conn.cmd, conn.arg1, conn.stream);
+                }
+                break;
+            }
+            case AdbReactorConnection::ReadState::StreamPayload: {
+                // 零拷贝：直接读进流的 RingBuffer
+                auto writeInfo = conn.stream->readBuffer.getWritePtr();
+                if (writeInfo.second == 0) {
+                    if (conn.stream->readBuffer.isClosed()) {
+                        // 流已关闭但负载还在路上，丢弃剩余字节保持分帧
+                        conn.state = AdbReactorConnection::ReadState::Drain;
+                        continue;
+                    }
+                    conn.readPaused = true;
+                    stalls.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                size_t n = conn.channel->readNonBlocking(writeInfo.first, std::min(conn.remaining, writeInfo.second));
+                if (n == 0) {
+                    return;
+                }
+                bytesIn.fetch_add(n, std::memory_order_relaxed);
+                budget -= std::min(budget, n);
+                conn.stream->readBuffer.commitWrite(n);
+                conn.remaining -= n;
+                if (conn.remaining == 0) {
+                    conn.state = AdbReactorConnection::ReadState::Header;
+                    adb->acknowledgeWrite(conn.stream, conn.arg0, conn.arg1);
+                }
+                break;
+            }
+            case AdbReactorConnection::ReadState::Drain: {
+                uint8_t scratch[DRAIN_CHUNK];
+                size_t n = conn.channel->readNonBlocking(scratch, std::min(conn.remaining, sizeof(scratch)));
+                if (n == 0) {
+                    return;
+                }
+                bytesIn.fetch_add(n, std::memory_order_relaxed);
+                budget -= std::min(budget, n);
+                conn.remaining -= n;
+                if (conn.remaining == 0) {
+                    conn.state = AdbReactorConnection::ReadState::Header;
+                }
+                break;
+            }
+        }
+    }
+
+    // 预算用完但可能还有数据：水平触发的 epoll 下一轮会再报告
+}
+
+void AdbReactor::Loop::flushWrites(AdbReactorConnection& conn) {
+    Adb* adb = conn.adb;
+    conn.wantWrite = false;
+    while (true) {
+        if (conn.outOffset >= conn.outbound.size()) {
+            conn.outbound.clear();
+            conn.outOffset = 0;
+            std::vector<uint8_t> data;
+            while (conn.outbound.size() < WRITE_COALESCE_BYTES && adb->sendQueue_.try_dequeue(data)) {
+                if (data.empty()) {
+                    continue;
+                }
+                FlightRecorder::instance().recordAdbHeader(FlightEvent::AdbOut, data.data(), data.size());
+                conn.outbound.insert(conn.outbound.end(), data.begin(), data.end());
+            }
+            if (conn.outbound.empty()) {
+                return;
+            }
+        }
+        size_t n = conn.channel->writeNonBlocking(conn.outbound.data() + conn.outOffset,
+                                                  conn.outbound.size() - conn.outOffset);
+        if (n == 0) {
+            // 发送缓冲满，等 EPOLLOUT
+            conn.wantWrite = true;
+            return;
+        }
+        bytesOut.fetch_add(n, std::memory_order_relaxed);
+        conn.outOffset += n;
+    }
+}
+
+void AdbReactor::Loop::updateInterest(AdbReactorConnection& conn) {
+    uint32_t interest = (conn.readPaused ? 0u : static_cast<uint32_t>(EPOLLIN)) |
+                        (conn.wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (interest == conn.interest) {
+        return;
+    }
+    struct epoll_event ev {};
+    ev.events = interest;
+    ev.data.fd = conn.fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &ev) == 0) {
+        conn.interest = interest;
+    }
+}
+
+std::string AdbReactor::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+    oss << "{\"enabled\":" << (g_enabled.load() ? "true" : "false")
+        << ",\"threads\":" << g_threads.load()
+        << ",\"loops\":[";
+    for (size_t i = 0; i < loops_.size(); ++i) {
+        Loop& loop = *loops_[i];
+        size_t connections = 0;
+        size_t stalled = 0;
+        {
+            std::lock_guard<std::mutex> loopLock(loop.mutex);
+            connections = loop.connections.size();
+            stalled = loop.stalled.size();
+        }
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "{\"connections\":" << connections
+            << ",\"stalledNow\":" << stalled
+            << ",\"messages\":" << loop.messages.load(std::memory_order_relaxed)
+            << ",\"bytesIn\":" << loop.bytesIn.load(std::memory_order_relaxed)
+            << ",\"bytesOut\":" << loop.bytesOut.load(std::memory_order_relaxed)
+            << ",\"wakeups\":" << loop.wakeups.load(std::memory_order_relaxed)
+            << ",\"stalls\":" << loop.stalls.load(std::memory_order_relaxed) << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
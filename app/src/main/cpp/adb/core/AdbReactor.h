@@ -0,0 +1,53 @@
+// AdbReactor - 多个 ADB 连接共用的 epoll I/O 线程
+// 线程模式下每个 Adb 各有一个 handleIn 线程和一个 send 线程，同时监控几十台设备时大部分线程都在空等。
+// 反应器模式下少量 I/O 线程（默认 1 个）用 epoll 复用所有连接的读写：
+//   读：每个连接一个状态机（消息头 -> 负载），WRTE 负载直接读进流的 RingBuffer，
+//       流缓冲满时暂停该连接的 EPOLLIN，消费者腾出空间后经 eventfd 唤醒恢复，不阻塞其它连接
+//   写：sendQueue_ 由 I/O 线程排空并合并写出，发送缓冲满时挂 EPOLLOUT
+// 流的阻塞读写接口（streamRead / streamWrite 等）不变，仍基于 RingBuffer 和条件变量。
+// 只有支持非阻塞读写的通道（AdbChannel::reactorFd() >= 0，目前为明文 TcpChannel）才会注册，
+// TLS 通道继续使用线程模式。
+#ifndef ADB_REACTOR_H
+#define ADB_REACTOR_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Adb;
+struct AdbReactorConnection;
+
+class AdbReactor {
+public:
+    static constexpr int MAX_THREADS = 4;
+
+    static AdbReactor& instance();
+
+    // 只影响之后完成认证的连接；threads 为 I/O 线程数（1..MAX_THREADS）
+    static void setEnabled(bool enabled, int threads = 1);
+    static bool enabled();
+
+    // 通道不支持非阻塞读写时返回 nullptr，调用方应回退到线程模式
+    std::shared_ptr<AdbReactorConnection> attach(Adb* adb);
+    // 幂等；不在 I/O 线程上调用时会等待该连接正在进行的处理结束，返回后 I/O 线程不再访问 adb
+    void detach(const std::shared_ptr<AdbReactorConnection>& connection);
+    // sendQueue_ 有新数据
+    void wakeForWrite(const std::shared_ptr<AdbReactorConnection>& connection);
+
+    std::string toJson() const;
+
+    struct Loop;
+
+private:
+    AdbReactor() = default;
+    ~AdbReactor();
+
+    Loop* pickLoop();
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Loop>> loops_;
+};
+
+#endif // ADB_REACTOR_H
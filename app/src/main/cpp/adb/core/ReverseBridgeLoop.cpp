@@ -0,0 +1,808 @@
+#include "adb/core/ReverseBridgeLoop.h"
+#include "adb/core/Adb.h"
+#include "util/SocketTuning.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <ctime>
+#include <hilog/log.h>
+#include <linux/errqueue.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sstream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "ReverseBridge"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+constexpr int MAX_EVENTS = 64;
+// 单个连接每轮最多搬运的字节数，避免一条大流饿死其它连接
+constexpr size_t PUMP_BUDGET_PER_ROUND = 256 * 1024;
+// 小块数据走零拷贝得不偿失（页引用 + 完成通知的开销比拷贝还大），直接拷贝发送
+constexpr size_t ZEROCOPY_MIN_BYTES = 16 * 1024;
+// 有零拷贝发送在途时的兜底轮询间隔
+constexpr int ZEROCOPY_POLL_MS = 1;
+
+std::atomic<ReverseBridgeMode> g_mode{ReverseBridgeMode::Copy};
+
+uint64_t threadCpuNs() {
+    struct timespec ts {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+// 回环投递时内核总会把 MSG_ZEROCOPY 退化为拷贝，白付页引用和完成通知的开销
+bool isLoopbackPeer(int fd) {
+    struct sockaddr_storage peer {};
+    socklen_t len = sizeof(peer);
+    if (getpeername(fd, reinterpret_cast<struct sockaddr*>(&peer), &len) != 0) {
+        return false;
+    }
+    if (peer.ss_family == AF_INET) {
+        const auto* sin = reinterpret_cast<const struct sockaddr_in*>(&peer);
+        return (ntohl(sin->sin_addr.s_addr) >> 24) == 127;
+    }
+    if (peer.ss_family == AF_INET6) {
+        const auto* sin6 = reinterpret_cast<const struct sockaddr_in6*>(&peer);
+        if (IN6_IS_ADDR_LOOPBACK(&sin6->sin6_addr)) {
+            return true;
+        }
+        return IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr) && sin6->sin6_addr.s6_addr[12] == 127;
+    }
+    return false;
+}
+
+void appendModeStats(std::ostringstream& oss, uint64_t bytes, uint64_t cpuNs) {
+    oss << "{\"bytes\":" << bytes << ",\"cpuMs\":" << cpuNs / 1000000
+        << ",\"bytesPerCpuSecond\":" << (cpuNs > 0 ? bytes * 1000000000ULL / cpuNs : 0);
+}
+}
+
+void ReverseBridgeLoop::setMode(ReverseBridgeMode mode) {
+    g_mode.store(mode, std::memory_order_relaxed);
+    OH_LOG_INFO(LOG_APP, "[ReverseBridge] mode=%{public}s",
+                mode == ReverseBridgeMode::ZeroCopy ? "zerocopy" : "copy");
+}
+
+ReverseBridgeMode ReverseBridgeLoop::mode() {
+    return g_mode.load(std::memory_order_relaxed);
+}
+
+ReverseBridgeLoop& ReverseBridgeLoop::instance() {
+    static ReverseBridgeLoop* loop = new ReverseBridgeLoop();
+    return *loop;
+}
+
+void ReverseBridgeLoop::ensureStartedLocked() {
+    if (epollFd_ >= 0) {
+        return;
+    }
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd_ < 0 || wakeFd_ < 0) {
+        int err = errno;
+        if (epollFd_ >= 0) ::close(epollFd_);
+        if (wakeFd_ >= 0) ::close(wakeFd_);
+        epollFd_ = -1;
+        wakeFd_ = -1;
+        throw std::runtime_error("reverse bridge loop setup failed: " + std::string(strerror(err)));
+    }
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = 0;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+    scratch_.resize(BUFFER_SIZE);
+    thread_ = std::thread(&ReverseBridgeLoop::run, this);
+}
+
+bool ReverseBridgeLoop::add(Adb* adb, AdbStream* stream, int fd) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 与 closeAll 同锁检查，保证不会在 Adb 关闭后再挂上新连接
+    if (adb->isAdbClosed()) {
+        ::close(fd);
+        return false;
+    }
+    try {
+        ensureStartedLocked();
+    } catch (const std::exception& e) {
+        OH_LOG_ERROR(LOG_APP, "[ReverseBridge] %{public}s", e.what());
+        ::close(fd);
+        return false;
+    }
+    return addLocked(adb, stream, fd, nullptr) != 0;
+}
+
+uint64_t ReverseBridgeLoop::addLocked(Adb* adb, AdbStream* stream, int fd, std::shared_ptr<ForwardStats> forward) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags >= 0) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+    auto bridge = std::make_unique<Bridge>();
+    bridge->id = nextId_++;
+    bridge->adb = adb;
+    bridge->stream = stream;
+    bridge->fd = fd;
+    bridge->interest = EPOLLIN;
+    bridge->forward = std::move(forward);
+    if (mode() == ReverseBridgeMode::ZeroCopy && isLoopbackPeer(fd)) {
+        zeroCopyLoopbackSkipped_.fetch_add(1, std::memory_order_relaxed);
+        OH_LOG_DEBUG(LOG_APP, "[ReverseBridge] loopback peer, zerocopy would always copy, using copy");
+    } else if (mode() == ReverseBridgeMode::ZeroCopy) {
+        int one = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0) {
+            bridge->mode = ReverseBridgeMode::ZeroCopy;
+        } else {
+            OH_LOG_WARN(LOG_APP, "[ReverseBridge] SO_ZEROCOPY unsupported errno=%{public}d, using copy", errno);
+        }
+    }
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = bridge->id;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        OH_LOG_WARN(LOG_APP, "[ReverseBridge] epoll add failed errno=%{public}d", errno);
+        ::close(fd);
+        return 0;
+    }
+    const uint64_t id = bridge->id;
+    if (bridge->forward) {
+        bridge->forward->active.fetch_add(1, std::memory_order_relaxed);
+    }
+    bridges_[id] = std::move(bridge);
+    {
+        std::lock_guard<std::mutex> listenerLock(stream->eventListenerMutex);
+        stream->eventListener = [this, id]() { markReady(id); };
+    }
+    opened_.fetch_add(1, std::memory_order_relaxed);
+    // 流里可能已有数据
+    markReady(id);
+    return id;
+}
+
+uint16_t ReverseBridgeLoop::addForwardListener(Adb* adb, uint16_t localPort, const std::string& remote) {
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("forward socket failed: " + std::string(strerror(errno)));
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    SocketTuning::apply(fd, SocketProfile::Bulk, "forward");
+
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(localPort);
+    socklen_t addrLen = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0 ||
+        getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error("forward listen on " + std::to_string(localPort) + " failed: " +
+                                 std::string(strerror(err)));
+    }
+    const uint16_t boundPort = ntohs(addr.sin_port);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (adb->isAdbClosed()) {
+        ::close(fd);
+        throw std::runtime_error("adb closed");
+    }
+    try {
+        ensureStartedLocked();
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ForwardListener listener;
+    listener.adb = adb;
+    listener.fd = fd;
+    listener.stats = std::make_shared<ForwardStats>();
+    listener.stats->port = boundPort;
+    listener.stats->remote = remote;
+    listener.stats->since = std::chrono::steady_clock::now();
+    const uint64_t id = nextId_++;
+    struct epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = id;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error("forward epoll add failed: " + std::string(strerror(err)));
+    }
+    listeners_[id] = std::move(listener);
+    OH_LOG_INFO(LOG_APP, "[ReverseBridge] forward listen 127.0.0.1:%{public}u -> %{public}s",
+                boundPort, remote.c_str());
+    return boundPort;
+}
+
+bool ReverseBridgeLoop::removeForwardListener(Adb* adb, uint16_t localPort) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = listeners_.begin(); it != listeners_.end(); ++it) {
+        if (it->second.adb == adb && it->second.stats->port == localPort) {
+            epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+            ::close(it->second.fd);
+            listeners_.erase(it);
+            OH_LOG_INFO(LOG_APP, "[ReverseBridge] forward removed port=%{public}u", localPort);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReverseBridgeLoop::acceptForwardLocked(ForwardListener& listener) {
+    while (true) {
+        int fd = ::accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                OH_LOG_WARN(LOG_APP, "[ReverseBridge] forward accept failed errno=%{public}d", errno);
+            }
+            return;
+        }
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        listener.stats->accepted.fetch_add(1, std::memory_order_relaxed);
+
+        const uint64_t pendingId = nextId_++;
+        PendingForward pending;
+        pending.adb = listener.adb;
+        pending.fd = fd;
+        pending.stats = listener.stats;
+        pendingForwards_[pendingId] = std::move(pending);
+        try {
+            // 设备应答前 socket 不挂到 epoll，客户端先发的数据留在内核接收缓冲里
+            listener.adb->openAsync(listener.stats->remote,
+                                    [this, pendingId](AdbStream* stream) { onForwardOpened(pendingId, stream); },
+                                    "bridge");
+        } catch (const std::exception& e) {
+            OH_LOG_WARN(LOG_APP, "[ReverseBridge] forward open failed: %{public}s", e.what());
+            pendingForwards_.erase(pendingId);
+            listener.stats->refused.fetch_add(1, std::memory_order_relaxed);
+            ::close(fd);
+        }
+    }
+}
+
+void ReverseBridgeLoop::onForwardOpened(uint64_t pendingId, AdbStream* stream) {
+    bool needWake = false;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        needWake = ready_.empty() && openedForwards_.empty();
+        openedForwards_.emplace_back(pendingId, stream);
+    }
+    if (needWake) {
+        wake();
+    }
+}
+
+void ReverseBridgeLoop::handleOpenedForwardsLocked(const std::vector<std::pair<uint64_t, AdbStream*>>& opened) {
+    for (const auto& entry : opened) {
+        auto it = pendingForwards_.find(entry.first);
+        if (it == pendingForwards_.end()) {
+            // Adb 已关闭，连接已由 closeAll 回收
+            continue;
+        }
+        PendingForward pending = std::move(it->second);
+        pendingForwards_.erase(it);
+        AdbStream* stream = entry.second;
+        if (!stream) {
+            pending.stats->refused.fetch_add(1, std::memory_order_relaxed);
+            ::close(pending.fd);
+            continue;
+        }
+        if (addLocked(pending.adb, stream, pending.fd, pending.stats) == 0 && !pending.adb->isAdbClosed()) {
+            pending.adb->streamClose(stream->localId);
+            pending.adb->releaseStream(stream->localId);
+        }
+    }
+}
+
+void ReverseBridgeLoop::closeAll(Adb* adb) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint64_t> ids;
+    for (const auto& entry : bridges_) {
+        if (entry.second->adb == adb) {
+            ids.push_back(entry.first);
+        }
+    }
+    for (uint64_t id : ids) {
+        // Adb::close() 会统一关闭流
+        finishLocked(id, false);
+    }
+    for (auto it = listeners_.begin(); it != listeners_.end();) {
+        if (it->second.adb == adb) {
+            epoll_ctl(epollFd_, EPOLL_CTL_DEL, it->second.fd, nullptr);
+            ::close(it->second.fd);
+            it = listeners_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = pendingForwards_.begin(); it != pendingForwards_.end();) {
+        if (it->second.adb == adb) {
+            ::close(it->second.fd);
+            it = pendingForwards_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ReverseBridgeLoop::markReady(uint64_t id) {
+    bool needWake = false;
+    {
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        needWake = ready_.empty();
+        ready_.push_back(id);
+    }
+    if (needWake) {
+        wake();
+    }
+}
+
+void ReverseBridgeLoop::wake() {
+    uint64_t one = 1;
+    ssize_t ret = ::write(wakeFd_, &one, sizeof(one));
+    (void)ret;
+}
+
+void ReverseBridgeLoop::run() {
+    StallWatchdog::ThreadScope watchdogScope("reverse-bridge");
+    ThreadCpuMonitor::Scope cpuScope("bridge", "reverse-bridge");
+
+    struct epoll_event events[MAX_EVENTS];
+    std::vector<uint64_t> ids;
+    std::vector<uint64_t> hungUp;
+    std::vector<uint64_t> errored;
+    std::vector<std::pair<uint64_t, AdbStream*>> opened;
+    while (true) {
+        int n = 0;
+        const int timeoutMs = !moreWork_.empty() ? 0 : (awaitingCompletion_.empty() ? -1 : ZEROCOPY_POLL_MS);
+        {
+            StallWatchdog::WaitScope waitScope("bridge_wait", -1, StallWatchdog::WaitKind::Idle);
+            n = epoll_wait(epollFd_, events, MAX_EVENTS, timeoutMs);
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            OH_LOG_ERROR(LOG_APP, "[ReverseBridge] epoll_wait failed errno=%{public}d", errno);
+            break;
+        }
+        StallWatchdog::heartbeat();
+
+        ids.clear();
+        hungUp.clear();
+        errored.clear();
+        opened.clear();
+        ids.swap(awaitingCompletion_);
+        ids.insert(ids.end(), moreWork_.begin(), moreWork_.end());
+        moreWork_.clear();
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.u64 == 0) {
+                uint64_t value = 0;
+                ssize_t ret = ::read(wakeFd_, &value, sizeof(value));
+                (void)ret;
+                std::lock_guard<std::mutex> readyLock(readyMutex_);
+                ids.insert(ids.end(), ready_.begin(), ready_.end());
+                ready_.clear();
+                opened.swap(openedForwards_);
+            } else {
+                ids.push_back(events[i].data.u64);
+                if (events[i].events & EPOLLHUP) {
+                    hungUp.push_back(events[i].data.u64);
+                } else if (events[i].events & EPOLLERR) {
+                    errored.push_back(events[i].data.u64);
+                }
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!opened.empty()) {
+            handleOpenedForwardsLocked(opened);
+        }
+        for (uint64_t id : ids) {
+            auto it = bridges_.find(id);
+            if (it == bridges_.end()) {
+                auto listenerIt = listeners_.find(id);
+                if (listenerIt != listeners_.end()) {
+                    acceptForwardLocked(listenerIt->second);
+                }
+                continue;
+            }
+            Bridge& bridge = *it->second;
+            const bool zeroCopy = bridge.mode == ReverseBridgeMode::ZeroCopy;
+            const uint64_t toAdbBefore = bytesToAdb_.load(std::memory_order_relaxed);
+            const uint64_t toSocketBefore = bytesToSocket_.load(std::memory_order_relaxed);
+            const uint64_t cpuBefore = threadCpuNs();
+            const bool hasError = std::find(errored.begin(), errored.end(), id) != errored.end();
+            bool alive = true;
+            if (hasError && zeroCopy) {
+                // 零拷贝的完成通知也以 EPOLLERR 报告，先读走通知；错误队列为空时才是真的出错
+                alive = reapZeroCopyCompletions(bridge, true);
+            }
+            alive = alive && service(bridge);
+            ModeStats& stats = zeroCopy ? zeroCopyStats_ : copyStats_;
+            stats.cpuNs.fetch_add(threadCpuNs() - cpuBefore, std::memory_order_relaxed);
+            const uint64_t toAdb = bytesToAdb_.load(std::memory_order_relaxed) - toAdbBefore;
+            const uint64_t toSocket = bytesToSocket_.load(std::memory_order_relaxed) - toSocketBefore;
+            stats.bytes.fetch_add(toAdb + toSocket, std::memory_order_relaxed);
+            if (bridge.forward) {
+                bridge.forward->bytesToDevice.fetch_add(toAdb, std::memory_order_relaxed);
+                bridge.forward->bytesFromDevice.fetch_add(toSocket, std::memory_order_relaxed);
+            }
+            const bool hangUp = std::find(hungUp.begin(), hungUp.end(), id) != hungUp.end() ||
+                                (hasError && !zeroCopy);
+            // 挂断后水平触发会一直报告，搬运完能搬的就结束，避免暂停读取时空转
+            if (!alive || hangUp) {
+                finishLocked(id, true);
+                continue;
+            }
+            if (bridge.moreWork) {
+                moreWork_.push_back(id);
+            } else if (!bridge.zeroCopyInflight.empty()) {
+                awaitingCompletion_.push_back(id);
+            }
+        }
+    }
+}
+
+bool ReverseBridgeLoop::service(Bridge& bridge) {
+    try {
+        bool toSocket = bridge.mode == ReverseBridgeMode::ZeroCopy ? pumpAdbToSocketZeroCopy(bridge)
+                                                                   : pumpAdbToSocket(bridge);
+        if (!toSocket || !pumpSocketToAdb(bridge)) {
+            return false;
+        }
+    } catch (const std::exception& e) {
+        if (!bridge.adb->isAdbClosed() && !bridge.stream->closed.load()) {
+            OH_LOG_WARN(LOG_APP, "[ReverseBridge] bridge exit: %{public}s", e.what());
+        }
+        return false;
+    }
+    updateInterest(bridge);
+    return true;
+}
+
+bool ReverseBridgeLoop::pumpAdbToSocket(Bridge& bridge) {
+    RingBuffer& ring = bridge.stream->readBuffer;
+    size_t budget = PUMP_BUDGET_PER_ROUND;
+    bridge.wantWrite = false;
+    bridge.moreWork = false;
+    while (budget > 0) {
+        auto readInfo = ring.getReadPtr();
+        if (readInfo.second == 0) {
+            // 流关闭且数据已全部转发
+            return !ring.isClosed();
+        }
+        ssize_t n = ::send(bridge.fd, readInfo.first, std::min(readInfo.second, budget),
+                           MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                bridge.wantWrite = true;
+                return true;
+            }
+            return false;
+        }
+        ring.consumeRead(static_cast<size_t>(n));
+        bytesToSocket_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        budget -= std::min(budget, static_cast<size_t>(n));
+    }
+    // 额度用完时 ring 里剩下的数据不会再触发任何事件
+    bridge.moreWork = ring.size() > 0;
+    return true;
+}
+
+bool ReverseBridgeLoop::pumpAdbToSocketZeroCopy(Bridge& bridge) {
+    RingBuffer& ring = bridge.stream->readBuffer;
+    if (!reapZeroCopyCompletions(bridge, false)) {
+        return false;
+    }
+    size_t budget = PUMP_BUDGET_PER_ROUND;
+    bridge.wantWrite = false;
+    bridge.moreWork = false;
+    while (budget > 0 && bridge.zeroCopyInflight.size() < MAX_ZEROCOPY_INFLIGHT) {
+        auto readInfo = ring.getReadPtr(bridge.borrowed);
+        if (readInfo.second == 0) {
+            // 流关闭、数据已全部转发且内核不再引用 ring 时才结束
+            return !(ring.isClosed() && bridge.zeroCopyInflight.empty());
+        }
+        const size_t length = std::min(readInfo.second, budget);
+        bool zeroCopy = length >= ZEROCOPY_MIN_BYTES;
+        ssize_t n = ::send(bridge.fd, readInfo.first, length,
+                           MSG_DONTWAIT | MSG_NOSIGNAL | (zeroCopy ? MSG_ZEROCOPY : 0));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                bridge.wantWrite = true;
+                return true;
+            }
+            if (errno == ENOBUFS && zeroCopy) {
+                // optmem 用完（在途通知太多），等完成通知释放；没有在途发送时这一块退回拷贝
+                if (!bridge.zeroCopyInflight.empty()) {
+                    return true;
+                }
+                zeroCopy = false;
+                n = ::send(bridge.fd, readInfo.first, length, MSG_DONTWAIT | MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        bridge.wantWrite = true;
+                        return true;
+                    }
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        const size_t sent = static_cast<size_t>(n);
+        Bridge::ZeroCopySend entry;
+        entry.bytes = sent;
+        if (zeroCopy) {
+            entry.seq = bridge.nextZeroCopySeq++;
+        } else {
+            // 拷贝发送的数据内核已复制走，但必须按顺序 consumeRead，所以同样排队
+            entry.done = true;
+        }
+        bridge.zeroCopyInflight.push_back(entry);
+        bridge.borrowed += sent;
+        bytesToSocket_.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+        budget -= std::min(budget, sent);
+        releaseCompletedZeroCopy(bridge);
+    }
+    // 额度用完且还有未发送的数据：下一轮继续；在途发送占满时由完成通知推进
+    bridge.moreWork = budget == 0 && ring.size() > bridge.borrowed;
+    return true;
+}
+
+bool ReverseBridgeLoop::reapZeroCopyCompletions(Bridge& bridge, bool checkError) {
+    bool reaped = false;
+    while (true) {
+        char control[CMSG_SPACE(sizeof(struct sock_extended_err)) + 64];
+        struct msghdr msg {};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t ret = ::recvmsg(bridge.fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            bool ipLevel = (cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                           (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR);
+            if (!ipLevel) {
+                continue;
+            }
+            struct sock_extended_err err {};
+            std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+            if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY || err.ee_errno != 0) {
+                continue;
+            }
+            // [ee_info, ee_data] 是一段连续完成的发送序号（可能回绕）
+            const uint32_t lo = err.ee_info;
+            const uint32_t span = err.ee_data - lo;
+            for (auto& entry : bridge.zeroCopyInflight) {
+                if (!entry.done && entry.seq - lo <= span) {
+                    entry.done = true;
+                }
+            }
+            zeroCopyCompletions_.fetch_add(static_cast<uint64_t>(span) + 1, std::memory_order_relaxed);
+            if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                zeroCopyCopied_.fetch_add(static_cast<uint64_t>(span) + 1, std::memory_order_relaxed);
+            }
+            reaped = true;
+        }
+    }
+    releaseCompletedZeroCopy(bridge);
+    if (checkError && !reaped) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if (getsockopt(bridge.fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReverseBridgeLoop::releaseCompletedZeroCopy(Bridge& bridge) {
+    RingBuffer& ring = bridge.stream->readBuffer;
+    while (!bridge.zeroCopyInflight.empty() && bridge.zeroCopyInflight.front().done) {
+        const size_t bytes = bridge.zeroCopyInflight.front().bytes;
+        bridge.zeroCopyInflight.pop_front();
+        ring.consumeRead(bytes);
+        bridge.borrowed -= bytes;
+    }
+}
+
+bool ReverseBridgeLoop::pumpSocketToAdb(Bridge& bridge) {
+    Adb* adb = bridge.adb;
+    if (bridge.leftover) {
+        size_t accepted = adb->streamTryWrite(bridge.stream, bridge.leftover->data() + bridge.leftoverOffset,
+                                              bridge.leftoverSize - bridge.leftoverOffset);
+        bridge.leftoverOffset += accepted;
+        bytesToAdb_.fetch_add(accepted, std::memory_order_relaxed);
+        if (bridge.leftoverOffset < bridge.leftoverSize) {
+            // 等 OKAY 腾出发送额度后由 eventListener 再唤醒
+            return true;
+        }
+        releaseBuffer(std::move(bridge.leftover));
+        bridge.leftoverOffset = 0;
+        bridge.leftoverSize = 0;
+    }
+
+    size_t budget = PUMP_BUDGET_PER_ROUND;
+    while (budget > 0) {
+        ssize_t n = ::recv(bridge.fd, scratch_.data(), scratch_.size(), MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (n == 0) {
+            return false;
+        }
+        const size_t received = static_cast<size_t>(n);
+        size_t accepted = adb->streamTryWrite(bridge.stream, scratch_.data(), received);
+        bytesToAdb_.fetch_add(accepted, std::memory_order_relaxed);
+        if (accepted < received) {
+            bridge.leftover = acquireBuffer();
+            std::memcpy(bridge.leftover->data(), scratch_.data() + accepted, received - accepted);
+            bridge.leftoverOffset = 0;
+            bridge.leftoverSize = received - accepted;
+            backpressureStalls_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        budget -= std::min(budget, received);
+    }
+    return true;
+}
+
+void ReverseBridgeLoop::updateInterest(Bridge& bridge) {
+    uint32_t interest = (bridge.leftover ? 0u : static_cast<uint32_t>(EPOLLIN)) |
+                        (bridge.wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    if (interest == bridge.interest) {
+        return;
+    }
+    struct epoll_event ev {};
+    ev.events = interest;
+    ev.data.u64 = bridge.id;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_MOD, bridge.fd, &ev) == 0) {
+        bridge.interest = interest;
+    }
+}
+
+void ReverseBridgeLoop::finishLocked(uint64_t id, bool closeStream) {
+    auto it = bridges_.find(id);
+    if (it == bridges_.end()) {
+        return;
+    }
+    std::unique_ptr<Bridge> bridge = std::move(it->second);
+    bridges_.erase(it);
+
+    {
+        std::lock_guard<std::mutex> listenerLock(bridge->stream->eventListenerMutex);
+        bridge->stream->eventListener = nullptr;
+    }
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, bridge->fd, nullptr);
+    ::shutdown(bridge->fd, SHUT_RDWR);
+    ::close(bridge->fd);
+    if (bridge->leftover) {
+        releaseBuffer(std::move(bridge->leftover));
+    }
+    if (bridge->forward) {
+        bridge->forward->active.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (closeStream && !bridge->adb->isAdbClosed()) {
+        if (!bridge->stream->closed.load()) {
+            bridge->adb->streamClose(bridge->stream->localId);
+        }
+        // 循环不再访问该流，对端 CLSE 到达后由 Adb 回收流对象和缓冲
+        bridge->adb->releaseStream(bridge->stream->localId);
+    }
+    reaped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::unique_ptr<std::vector<uint8_t>> ReverseBridgeLoop::acquireBuffer() {
+    buffersInUse_.fetch_add(1, std::memory_order_relaxed);
+    if (!pool_.empty()) {
+        auto buffer = std::move(pool_.back());
+        pool_.pop_back();
+        return buffer;
+    }
+    return std::make_unique<std::vector<uint8_t>>(BUFFER_SIZE);
+}
+
+void ReverseBridgeLoop::releaseBuffer(std::unique_ptr<std::vector<uint8_t>> buffer) {
+    buffersInUse_.fetch_sub(1, std::memory_order_relaxed);
+    if (buffer && pool_.size() < MAX_POOLED_BUFFERS) {
+        pool_.push_back(std::move(buffer));
+    }
+}
+
+std::string ReverseBridgeLoop::toJson() const {
+    size_t active = 0;
+    size_t pooled = 0;
+    size_t pendingForwards = 0;
+    std::vector<std::shared_ptr<ForwardStats>> forwards;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        active = bridges_.size();
+        pooled = pool_.size();
+        pendingForwards = pendingForwards_.size();
+        for (const auto& entry : listeners_) {
+            forwards.push_back(entry.second.stats);
+        }
+    }
+    std::ostringstream oss;
+    oss << "{\"mode\":\"" << (mode() == ReverseBridgeMode::ZeroCopy ? "zerocopy" : "copy") << "\""
+        << ",\"active\":" << active
+        << ",\"opened\":" << opened_.load(std::memory_order_relaxed)
+        << ",\"reaped\":" << reaped_.load(std::memory_order_relaxed)
+        << ",\"bytesToAdb\":" << bytesToAdb_.load(std::memory_order_relaxed)
+        << ",\"bytesToSocket\":" << bytesToSocket_.load(std::memory_order_relaxed)
+        << ",\"backpressureStalls\":" << backpressureStalls_.load(std::memory_order_relaxed)
+        << ",\"buffersInUse\":" << buffersInUse_.load(std::memory_order_relaxed)
+        << ",\"buffersPooled\":" << pooled << ",\"copy\":";
+    appendModeStats(oss, copyStats_.bytes.load(std::memory_order_relaxed),
+                    copyStats_.cpuNs.load(std::memory_order_relaxed));
+    oss << "},\"zeroCopy\":";
+    appendModeStats(oss, zeroCopyStats_.bytes.load(std::memory_order_relaxed),
+                    zeroCopyStats_.cpuNs.load(std::memory_order_relaxed));
+    oss << ",\"completions\":" << zeroCopyCompletions_.load(std::memory_order_relaxed)
+        << ",\"copiedCompletions\":" << zeroCopyCopied_.load(std::memory_order_relaxed)
+        << ",\"loopbackSkipped\":" << zeroCopyLoopbackSkipped_.load(std::memory_order_relaxed) << "}";
+    oss << ",\"forwardPendingOpens\":" << pendingForwards << ",\"forwards\":[";
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < forwards.size(); ++i) {
+        const ForwardStats& stats = *forwards[i];
+        const int64_t ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - stats.since).count();
+        const uint64_t bytes = stats.bytesToDevice.load(std::memory_order_relaxed) +
+                               stats.bytesFromDevice.load(std::memory_order_relaxed);
+        std::string remote = stats.remote;
+        std::replace(remote.begin(), remote.end(), '"', '\'');
+        oss << (i == 0 ? "" : ",") << "{\"port\":" << stats.port
+            << ",\"remote\":\"" << remote << "\""
+            << ",\"accepted\":" << stats.accepted.load(std::memory_order_relaxed)
+            << ",\"refused\":" << stats.refused.load(std::memory_order_relaxed)
+            << ",\"active\":" << stats.active.load(std::memory_order_relaxed)
+            << ",\"bytesToDevice\":" << stats.bytesToDevice.load(std::memory_order_relaxed)
+            << ",\"bytesFromDevice\":" << stats.bytesFromDevice.load(std::memory_order_relaxed)
+            << ",\"bytesPerSecond\":" << (ageMs > 0 ? bytes * 1000 / static_cast<uint64_t>(ageMs) : 0) << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
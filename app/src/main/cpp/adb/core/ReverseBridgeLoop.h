@@ -0,0 +1,191 @@
+// ReverseBridgeLoop - reverse 连接（设备 OPEN tcp:xxx）的共享事件循环
+// 每条 reverse 连接原本各起两个线程、各带 64 KB 缓冲，短连接多的工具会不停创建线程。
+// 现在所有 Adb 的 reverse 连接共用一个 epoll 线程：
+//   adb -> socket：直接从流的 RingBuffer 取数据 send()，不经中间缓冲
+//   socket -> adb：recv 到循环共用的暂存区，交给 Adb::streamTryWrite；
+//                  ADB 发送缓冲满时剩余部分放进池化缓冲并暂停该 socket 的 EPOLLIN
+// 流上有新数据、发送额度恢复或流关闭时，AdbStream::eventListener 唤醒循环。
+// 连接结束立即回收（关闭 fd、归还缓冲、清掉监听），流交还 Adb 在对端 CLSE 后释放，线程数和内存不随连接数增长。
+// reverse/forward 连接的流都用 1 MiB 的 bridge 读缓冲。
+//
+// 零拷贝模式（adb -> socket 方向）：直接用 MSG_ZEROCOPY 从 RingBuffer 发送，内核引用 ring 的页而不拷贝，
+// 完成通知（socket 错误队列）确认内核不再引用后才 consumeRead 归还给 ring。
+// 不用 vmsplice：ring 的页会被复用，而本机回环的接收端在 ACK 之后仍可能引用 splice 进去的页。
+// 对端是回环地址时内核总会退化为拷贝，这类连接不开零拷贝（reverse/forward 目前都是回环，只有统计仍有意义）。
+// socket -> adb 方向需要按 ADB 消息分帧，两种模式都走拷贝。
+//
+// forward 监听（adb forward）也挂在这个循环上：监听 fd 可读时 accept，为每个连接 Adb::openAsync
+// 打开 remote 流，设备应答后按上面的方式转发。每条连接各自的流缓冲和发送额度就是它的窗口，
+// 一条慢连接只会暂停自己的 socket。
+#ifndef REVERSE_BRIDGE_LOOP_H
+#define REVERSE_BRIDGE_LOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Adb;
+struct AdbStream;
+
+enum class ReverseBridgeMode {
+    Copy,
+    ZeroCopy,
+};
+
+class ReverseBridgeLoop {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+    // 空闲缓冲最多保留的数量，多余的直接释放
+    static constexpr size_t MAX_POOLED_BUFFERS = 8;
+
+    // 同一连接同时在途的零拷贝发送次数上限
+    static constexpr size_t MAX_ZEROCOPY_INFLIGHT = 64;
+
+    static ReverseBridgeLoop& instance();
+
+    // 只影响之后建立的连接；对端是回环地址或 socket 不支持 SO_ZEROCOPY 时该连接回退到拷贝
+    static void setMode(ReverseBridgeMode mode);
+    static ReverseBridgeMode mode();
+
+    // 接管 fd；adb 已关闭时直接关闭 fd 并返回 false
+    bool add(Adb* adb, AdbStream* stream, int fd);
+    // Adb::close() 调用：同步关闭该实例的全部连接和监听，返回后循环不再访问 adb
+    void closeAll(Adb* adb);
+
+    // 在 127.0.0.1:localPort 上监听（0 表示随机端口），返回实际端口；失败抛 std::runtime_error
+    uint16_t addForwardListener(Adb* adb, uint16_t localPort, const std::string& remote);
+    // 只关闭监听，已建立的连接继续转发
+    bool removeForwardListener(Adb* adb, uint16_t localPort);
+
+    std::string toJson() const;
+
+private:
+    // 单个 forward 监听的统计；连接持有引用，监听移除后仍可计数
+    struct ForwardStats {
+        uint16_t port = 0;
+        std::string remote;
+        std::chrono::steady_clock::time_point since;
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint64_t> refused{0};
+        std::atomic<uint32_t> active{0};
+        std::atomic<uint64_t> bytesToDevice{0};
+        std::atomic<uint64_t> bytesFromDevice{0};
+    };
+
+    struct ForwardListener {
+        Adb* adb = nullptr;
+        int fd = -1;
+        std::shared_ptr<ForwardStats> stats;
+    };
+
+    // 已 accept、等待设备应答 OPEN 的连接
+    struct PendingForward {
+        Adb* adb = nullptr;
+        int fd = -1;
+        std::shared_ptr<ForwardStats> stats;
+    };
+
+    struct Bridge {
+        uint64_t id = 0;
+        Adb* adb = nullptr;
+        AdbStream* stream = nullptr;
+        int fd = -1;
+        // socket -> adb 方向 ADB 尚未收下的数据
+        std::unique_ptr<std::vector<uint8_t>> leftover;
+        size_t leftoverOffset = 0;
+        size_t leftoverSize = 0;
+        bool wantWrite = false;
+        // 本轮额度用完但流缓冲里还有数据；ring 不是 fd，需循环自己再处理一轮
+        bool moreWork = false;
+        uint32_t interest = 0;
+        // 零拷贝模式
+        struct ZeroCopySend {
+            uint32_t seq = 0;
+            size_t bytes = 0;
+            bool done = false;
+        };
+        ReverseBridgeMode mode = ReverseBridgeMode::Copy;
+        uint32_t nextZeroCopySeq = 0;
+        std::deque<ZeroCopySend> zeroCopyInflight;
+        size_t borrowed = 0;    // 已发送但内核可能仍在引用、尚未 consumeRead 的字节
+        // forward 连接所属监听的统计，reverse 连接为空
+        std::shared_ptr<ForwardStats> forward;
+    };
+
+    struct ModeStats {
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> cpuNs{0};
+    };
+
+    ReverseBridgeLoop() = default;
+
+    void ensureStartedLocked();
+    void run();
+    void wake();
+    void markReady(uint64_t id);
+    // 需持有 mutex_；返回新连接 id，失败返回 0（fd 已关闭）
+    uint64_t addLocked(Adb* adb, AdbStream* stream, int fd, std::shared_ptr<ForwardStats> forward);
+    void acceptForwardLocked(ForwardListener& listener);
+    // 收包线程回调：OPEN 已应答，交给循环线程处理
+    void onForwardOpened(uint64_t pendingId, AdbStream* stream);
+    void handleOpenedForwardsLocked(const std::vector<std::pair<uint64_t, AdbStream*>>& opened);
+    // 返回 false 表示该连接已结束
+    bool service(Bridge& bridge);
+    bool pumpAdbToSocket(Bridge& bridge);
+    bool pumpAdbToSocketZeroCopy(Bridge& bridge);
+    // 读取错误队列里的完成通知；checkError 时错误队列为空视为 socket 出错，返回 false
+    bool reapZeroCopyCompletions(Bridge& bridge, bool checkError);
+    // 按发送顺序把内核已不再引用的数据 consumeRead 归还给 ring
+    void releaseCompletedZeroCopy(Bridge& bridge);
+    bool pumpSocketToAdb(Bridge& bridge);
+    void updateInterest(Bridge& bridge);
+    void finishLocked(uint64_t id, bool closeStream);
+
+    std::unique_ptr<std::vector<uint8_t>> acquireBuffer();
+    void releaseBuffer(std::unique_ptr<std::vector<uint8_t>> buffer);
+
+    // 保护 bridges_ 与连接处理；循环线程处理期间持有，closeAll 借此等待处理结束
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, std::unique_ptr<Bridge>> bridges_;
+    std::unordered_map<uint64_t, ForwardListener> listeners_;
+    std::unordered_map<uint64_t, PendingForward> pendingForwards_;
+    uint64_t nextId_ = 1;
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    std::thread thread_;
+
+    std::mutex readyMutex_;
+    std::vector<uint64_t> ready_;
+    std::vector<std::pair<uint64_t, AdbStream*>> openedForwards_;
+
+    // 还有零拷贝发送未完成的连接；完成通知会触发 EPOLLERR，这里只兜底定时检查（仅循环线程访问）
+    std::vector<uint64_t> awaitingCompletion_;
+    // 额度用完、下一轮立即继续处理的连接（仅循环线程访问）
+    std::vector<uint64_t> moreWork_;
+
+    std::vector<uint8_t> scratch_;
+    std::vector<std::unique_ptr<std::vector<uint8_t>>> pool_;
+
+    std::atomic<uint64_t> opened_{0};
+    std::atomic<uint64_t> reaped_{0};
+    std::atomic<uint64_t> bytesToAdb_{0};
+    std::atomic<uint64_t> bytesToSocket_{0};
+    std::atomic<uint64_t> backpressureStalls_{0};
+    std::atomic<uint32_t> buffersInUse_{0};
+    std::atomic<uint64_t> zeroCopyCompletions_{0};
+    // 内核实际做了拷贝的完成次数（本机回环投递时内核会拷贝）
+    std::atomic<uint64_t> zeroCopyCopied_{0};
+    // 零拷贝模式下因对端是回环地址而按拷贝处理的连接数
+    std::atomic<uint64_t> zeroCopyLoopbackSkipped_{0};
+    ModeStats copyStats_;
+    ModeStats zeroCopyStats_;
+};
+
+#endif // REVERSE_BRIDGE_LOOP_H
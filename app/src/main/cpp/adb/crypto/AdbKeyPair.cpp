@@ -3,6 +3,7 @@
 // 使用 CryptoArchitectureKit 进行RSA密钥生成和签名
 #include "adb/crypto/AdbKeyPair.h"
 #include "adb/crypto/AdbBase64.h"
+#include "adb/crypto/AdbTlsCredentials.h"
 #include <CryptoArchitectureKit/crypto_asym_cipher.h>
 #include <cstring>
 #include <fstream>
@@ -41,6 +42,10 @@ static_assert(sizeof(AdbKeyPair::SIGNATURE_PADDING) == AdbKeyPair::SIGNATURE_PAD
 
 AdbKeyPair::AdbKeyPair() {}
 
+std::shared_ptr<const AdbTlsCredentials> AdbKeyPair::getTlsCredentials() const {
+    return AdbTlsCredentials::forPrivateKeyPem(privateKeyPem_);
+}
+
 AdbKeyPair::~AdbKeyPair() {
     if (keyPair_) {
         OH_CryptoKeyPair_Destroy(keyPair_);
@@ -5,11 +5,14 @@
 #define ADB_KEY_PAIR_H
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <CryptoArchitectureKit/crypto_common.h>
 #include <CryptoArchitectureKit/crypto_asym_key.h>
 
+struct AdbTlsCredentials;
+
 class AdbKeyPair {
 public:
     static constexpr int KEY_LENGTH_BITS = 2048;
@@ -36,6 +39,9 @@ public:
     const std::vector<uint8_t>& getPublicKeyBytes() const { return publicKeyBytes_; }
     const std::string& getPrivateKeyPem() const { return privateKeyPem_; }
 
+    // STLS 用的 TLS 客户端凭据（证书、SSL_CTX 等），同一私钥在进程内只生成一次
+    std::shared_ptr<const AdbTlsCredentials> getTlsCredentials() const;
+
 private:
     std::vector<uint8_t> publicKeyBytes_;  // ADB格式的公钥字符串
     std::string privateKeyPem_;
@@ -0,0 +1,182 @@
+#include "adb/crypto/AdbTlsCredentials.h"
+#include "adb/pairing/TlsConnection.h"
+
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <openssl/pem.h>
+#include <openssl/sha.h>
+#include <openssl/x509v3.h>
+
+#include <hilog/log.h>
+
+#undef LOG_TAG
+#define LOG_TAG "AdbTlsCredentials"
+
+namespace {
+constexpr int kCertLifetimeSeconds = 10 * 365 * 24 * 60 * 60;
+const char kBasicConstraints[] = "critical,CA:TRUE";
+const char kKeyUsage[] = "critical,keyCertSign,cRLSign,digitalSignature";
+const char kSubjectKeyIdentifier[] = "hash";
+// 实际只会有一两把密钥，超过时整体清空即可
+constexpr size_t kMaxCachedKeys = 4;
+
+bssl::UniquePtr<EVP_PKEY> LoadPrivateKey(std::string_view pem) {
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())));
+    if (!bio) {
+        return nullptr;
+    }
+    return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+}
+
+bool AddExtension(X509* cert, int nid, const char* value) {
+    size_t len = std::strlen(value) + 1;
+    std::vector<char> mutableValue(value, value + len);
+    X509V3_CTX context;
+
+    X509V3_set_ctx_nodb(&context);
+    X509V3_set_ctx(&context, cert, cert, nullptr, nullptr, 0);
+    X509_EXTENSION* ext = X509V3_EXT_nconf_nid(nullptr, &context, nid, mutableValue.data());
+    if (!ext) {
+        return false;
+    }
+
+    X509_add_ext(cert, ext, -1);
+    X509_EXTENSION_free(ext);
+    return true;
+}
+
+std::string BioToString(BIO* bio) {
+    BUF_MEM* mem = nullptr;
+    BIO_get_mem_ptr(bio, &mem);
+    if (!mem || !mem->data || mem->length == 0) {
+        throw std::runtime_error("BIO_get_mem_ptr failed");
+    }
+    return std::string(mem->data, mem->length);
+}
+
+std::string PrivateKeyToPem(EVP_PKEY* pkey) {
+    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+    if (!bio) {
+        throw std::runtime_error("Failed to allocate PEM BIO");
+    }
+    if (PEM_write_bio_PKCS8PrivateKey(bio.get(), pkey, nullptr, nullptr, 0, nullptr, nullptr) != 1) {
+        throw std::runtime_error("PEM_write_bio_PKCS8PrivateKey failed");
+    }
+    return BioToString(bio.get());
+}
+
+std::string GenerateCertificatePem(EVP_PKEY* pkey) {
+    bssl::UniquePtr<X509> x509(X509_new());
+    if (!x509) {
+        throw std::runtime_error("Unable to allocate X509");
+    }
+
+    X509_set_version(x509.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(x509.get()), 1);
+    X509_gmtime_adj(X509_get_notBefore(x509.get()), 0);
+    X509_gmtime_adj(X509_get_notAfter(x509.get()), kCertLifetimeSeconds);
+
+    if (!X509_set_pubkey(x509.get(), pkey)) {
+        throw std::runtime_error("Unable to set X509 public key");
+    }
+
+    X509_NAME* name = X509_get_subject_name(x509.get());
+    if (!name) {
+        throw std::runtime_error("Unable to get X509 subject name");
+    }
+
+    X509_NAME_add_entry_by_txt(name, "C", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("US"), -1, -1, 0);
+    X509_NAME_add_entry_by_txt(name, "O", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("Android"), -1, -1, 0);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("Adb"), -1, -1, 0);
+
+    if (!X509_set_issuer_name(x509.get(), name)) {
+        throw std::runtime_error("Unable to set X509 issuer name");
+    }
+
+    if (!AddExtension(x509.get(), NID_basic_constraints, kBasicConstraints) ||
+        !AddExtension(x509.get(), NID_key_usage, kKeyUsage) ||
+        !AddExtension(x509.get(), NID_subject_key_identifier, kSubjectKeyIdentifier)) {
+        throw std::runtime_error("Unable to create X509 extensions");
+    }
+
+    if (X509_sign(x509.get(), pkey, EVP_sha256()) <= 0) {
+        throw std::runtime_error("Unable to sign X509 certificate");
+    }
+
+    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
+    if (!bio) {
+        throw std::runtime_error("Failed to allocate X509 PEM BIO");
+    }
+    if (PEM_write_bio_X509(bio.get(), x509.get()) != 1) {
+        throw std::runtime_error("PEM_write_bio_X509 failed");
+    }
+    return BioToString(bio.get());
+}
+
+std::string HexPrefix(const uint8_t* data, size_t len) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < len; ++i) {
+        out.push_back(kDigits[data[i] >> 4]);
+        out.push_back(kDigits[data[i] & 0x0f]);
+    }
+    return out;
+}
+
+std::string PublicKeyFingerprint(EVP_PKEY* pkey) {
+    uint8_t* der = nullptr;
+    int derLen = i2d_PUBKEY(pkey, &der);
+    if (derLen <= 0) {
+        throw std::runtime_error("i2d_PUBKEY failed");
+    }
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(der, static_cast<size_t>(derLen), digest);
+    OPENSSL_free(der);
+    return HexPrefix(digest, 8);
+}
+
+std::shared_ptr<const AdbTlsCredentials> Build(const std::string& pem) {
+    auto credentials = std::make_shared<AdbTlsCredentials>();
+    credentials->privateKey = LoadPrivateKey(pem);
+    if (!credentials->privateKey) {
+        throw std::runtime_error("Failed to load ADB private key for TLS");
+    }
+    credentials->certificatePem = GenerateCertificatePem(credentials->privateKey.get());
+    credentials->privateKeyPem = PrivateKeyToPem(credentials->privateKey.get());
+    credentials->publicKeyFingerprint = PublicKeyFingerprint(credentials->privateKey.get());
+    credentials->sslCtx = scrcpy::pairing::TlsConnection::CreateClientContext(credentials->certificatePem,
+                                                                               credentials->privateKey.get());
+    if (!credentials->sslCtx) {
+        throw std::runtime_error("Failed to create TLS client context");
+    }
+    return credentials;
+}
+}
+
+std::shared_ptr<const AdbTlsCredentials> AdbTlsCredentials::forPrivateKeyPem(const std::string& pem) {
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const AdbTlsCredentials>> cache;
+
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const uint8_t*>(pem.data()), pem.size(), digest);
+    const std::string key = HexPrefix(digest, sizeof(digest));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    if (cache.size() >= kMaxCachedKeys) {
+        cache.clear();
+    }
+    auto credentials = Build(pem);
+    cache.emplace(key, credentials);
+    OH_LOG_INFO(LOG_APP, "[AdbTlsCredentials] Generated TLS certificate for key %{public}s",
+                credentials->publicKeyFingerprint.c_str());
+    return credentials;
+}
@@ -0,0 +1,24 @@
+// AdbTlsCredentials - 由 ADB 私钥派生的 TLS 客户端凭据
+// 包含解析后的私钥、自签名证书、规范化的 PKCS#8 私钥与预配置好的 SSL_CTX。
+// 证书生成需要一次 RSA 签名，按私钥在进程内缓存，STLS 连接与无线配对共用。
+#ifndef ADB_TLS_CREDENTIALS_H
+#define ADB_TLS_CREDENTIALS_H
+
+#include <memory>
+#include <string>
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+
+struct AdbTlsCredentials {
+    bssl::UniquePtr<EVP_PKEY> privateKey;
+    std::string certificatePem;
+    std::string privateKeyPem;          // PKCS#8
+    std::string publicKeyFingerprint;   // SHA-256(SubjectPublicKeyInfo) 前 8 字节的 hex
+    bssl::UniquePtr<SSL_CTX> sslCtx;    // 各连接共享，连接级回调通过 SSL app data 分派
+
+    // 按私钥 PEM 取缓存的凭据，首次使用时生成；私钥无法解析时抛出 std::runtime_error
+    static std::shared_ptr<const AdbTlsCredentials> forPrivateKeyPem(const std::string& pem);
+};
+
+#endif // ADB_TLS_CREDENTIALS_H
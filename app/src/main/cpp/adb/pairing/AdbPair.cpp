@@ -1,5 +1,6 @@
 #include "adb/pairing/AdbPair.h"
 
+#include "adb/crypto/AdbTlsCredentials.h"
 #include "adb/pairing/PairingAuth.h"
 #include "adb/pairing/TlsConnection.h"
 
@@ -21,8 +22,6 @@
 #include <vector>
 
 #include <openssl/evp.h>
-#include <openssl/pem.h>
-#include <openssl/x509v3.h>
 
 #include <hilog/log.h>
 
@@ -108,10 +107,6 @@ struct PairingAuthDeleter {
 };
 
 using PairingAuthPtr = std::unique_ptr<PairingAuthCtx, PairingAuthDeleter>;
-constexpr int kCertLifetimeSeconds = 10 * 365 * 24 * 60 * 60;
-const char kBasicConstraints[] = "critical,CA:TRUE";
-const char kKeyUsage[] = "critical,keyCertSign,cRLSign,digitalSignature";
-const char kSubjectKeyIdentifier[] = "hash";
 
 std::string ReadFileToString(const std::string& path) {
     std::ifstream file(path, std::ios::binary);
@@ -133,102 +128,6 @@ std::string ReadPublicKeyString(const std::string& path) {
     return raw;
 }
 
-bssl::UniquePtr<EVP_PKEY> LoadPrivateKey(std::string_view pem) {
-    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())));
-    if (!bio) {
-        return nullptr;
-    }
-    return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
-}
-
-bool AddExtension(X509* cert, int nid, const char* value) {
-    size_t len = std::strlen(value) + 1;
-    std::vector<char> mutableValue(value, value + len);
-    X509V3_CTX context;
-
-    X509V3_set_ctx_nodb(&context);
-    X509V3_set_ctx(&context, cert, cert, nullptr, nullptr, 0);
-    X509_EXTENSION* ext = X509V3_EXT_nconf_nid(nullptr, &context, nid, mutableValue.data());
-    if (!ext) {
-        return false;
-    }
-
-    X509_add_ext(cert, ext, -1);
-    X509_EXTENSION_free(ext);
-    return true;
-}
-
-std::string PrivateKeyToPem(EVP_PKEY* pkey) {
-    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
-    if (!bio) {
-        throw std::runtime_error("Failed to allocate PEM BIO");
-    }
-    if (PEM_write_bio_PKCS8PrivateKey(bio.get(), pkey, nullptr, nullptr, 0, nullptr, nullptr) != 1) {
-        throw std::runtime_error("PEM_write_bio_PKCS8PrivateKey failed");
-    }
-
-    BUF_MEM* mem = nullptr;
-    BIO_get_mem_ptr(bio.get(), &mem);
-    if (!mem || !mem->data || mem->length == 0) {
-        throw std::runtime_error("BIO_get_mem_ptr failed");
-    }
-    return std::string(mem->data, mem->length);
-}
-
-std::string GenerateCertificatePem(EVP_PKEY* pkey) {
-    bssl::UniquePtr<X509> x509(X509_new());
-    if (!x509) {
-        throw std::runtime_error("Unable to allocate X509");
-    }
-
-    X509_set_version(x509.get(), 2);
-    ASN1_INTEGER_set(X509_get_serialNumber(x509.get()), 1);
-    X509_gmtime_adj(X509_get_notBefore(x509.get()), 0);
-    X509_gmtime_adj(X509_get_notAfter(x509.get()), kCertLifetimeSeconds);
-
-    if (!X509_set_pubkey(x509.get(), pkey)) {
-        throw std::runtime_error("Unable to set X509 public key");
-    }
-
-    X509_NAME* name = X509_get_subject_name(x509.get());
-    if (!name) {
-        throw std::runtime_error("Unable to get X509 subject name");
-    }
-
-    X509_NAME_add_entry_by_txt(name, "C", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("US"), -1, -1, 0);
-    X509_NAME_add_entry_by_txt(name, "O", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("Android"), -1, -1, 0);
-    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("Adb"), -1, -1, 0);
-
-    if (!X509_set_issuer_name(x509.get(), name)) {
-        throw std::runtime_error("Unable to set X509 issuer name");
-    }
-
-    if (!AddExtension(x509.get(), NID_basic_constraints, kBasicConstraints) ||
-        !AddExtension(x509.get(), NID_key_usage, kKeyUsage) ||
-        !AddExtension(x509.get(), NID_subject_key_identifier, kSubjectKeyIdentifier)) {
-        throw std::runtime_error("Unable to create X509 extensions");
-    }
-
-    if (X509_sign(x509.get(), pkey, EVP_sha256()) <= 0) {
-        throw std::runtime_error("Unable to sign X509 certificate");
-    }
-
-    bssl::UniquePtr<BIO> bio(BIO_new(BIO_s_mem()));
-    if (!bio) {
-        throw std::runtime_error("Failed to allocate X509 PEM BIO");
-    }
-    if (PEM_write_bio_X509(bio.get(), x509.get()) != 1) {
-        throw std::runtime_error("PEM_write_bio_X509 failed");
-    }
-
-    BUF_MEM* mem = nullptr;
-    BIO_get_mem_ptr(bio.get(), &mem);
-    if (!mem || !mem->data || mem->length == 0) {
-        throw std::runtime_error("BIO_get_mem_ptr failed");
-    }
-    return std::string(mem->data, mem->length);
-}
-
 void ParseHostPort(const std::string& hostPort, std::string& host, std::string& port) {
     if (hostPort.empty()) {
         throw std::runtime_error("Pairing address is empty");
@@ -390,13 +289,7 @@ std::string AdbPair(const std::string& hostPort, const std::string& pairingCode,
     }
 
     const std::string privateKeyPem = ReadFileToString(privateKeyPath);
-    bssl::UniquePtr<EVP_PKEY> privateKey = LoadPrivateKey(privateKeyPem);
-    if (!privateKey) {
-        throw std::runtime_error("Failed to load ADB private key");
-    }
-
-    const std::string certPem = GenerateCertificatePem(privateKey.get());
-    const std::string normalizedPrivateKeyPem = PrivateKeyToPem(privateKey.get());
+    auto credentials = AdbTlsCredentials::forPrivateKeyPem(privateKeyPem);
 
     PeerInfo myInfo {};
     myInfo.type = ADB_RSA_PUB_KEY;
@@ -406,8 +299,8 @@ std::string AdbPair(const std::string& hostPort, const std::string& pairingCode,
     std::memcpy(myInfo.data, pubKey.data(), pubKey.size());
 
     UniqueFd fd = ConnectTcp(host, port);
-    std::unique_ptr<TlsConnection> tls = TlsConnection::Create(TlsConnection::Role::Client, certPem,
-                                                               normalizedPrivateKeyPem, fd.get());
+    std::unique_ptr<TlsConnection> tls = TlsConnection::Create(TlsConnection::Role::Client,
+                                                               credentials->sslCtx.get(), fd.get());
     if (!tls) {
         throw std::runtime_error("Failed to create pairing TLS connection");
     }
@@ -24,12 +24,29 @@ public:
         privKey_ = EvpPkeyFromPEM(privKey);
     }
 
+    TlsConnectionImpl(Role role, SSL_CTX* sharedCtx, int fd) : role_(role), fd_(fd) {
+        SSL_CTX_up_ref(sharedCtx);
+        sslCtx_.reset(sharedCtx);
+    }
+
     ~TlsConnectionImpl() override = default;
 
     void SetCertVerifyCallback(CertVerifyCb cb) override {
         certVerifyCb_ = std::move(cb);
     }
 
+    void SetResumptionSession(std::vector<uint8_t> session) override {
+        resumptionSession_ = std::move(session);
+    }
+
+    void SetNewSessionCallback(NewSessionCb cb) override {
+        newSessionCb_ = std::move(cb);
+    }
+
+    bool SessionReused() const override {
+        return ssl_ && SSL_session_reused(ssl_.get());
+    }
+
     std::vector<uint8_t> ExportKeyingMaterial(size_t length) override {
         if (!ssl_) {
             return {};
@@ -43,31 +60,29 @@ public:
     }
 
     TlsError DoHandshake() override {
-        if (!cert_ || !privKey_) {
-            return TlsError::UnknownFailure;
-        }
-
-        sslCtx_.reset(SSL_CTX_new(TLS_method()));
-        if (!sslCtx_ || !SSL_CTX_set_min_proto_version(sslCtx_.get(), TLS1_3_VERSION) ||
-            !SSL_CTX_set_max_proto_version(sslCtx_.get(), TLS1_3_VERSION)) {
-            return TlsError::UnknownFailure;
-        }
-
-        if (certVerifyCb_) {
-            SSL_CTX_set_cert_verify_callback(sslCtx_.get(), SSLSetCertVerifyCb, this);
-        }
-
-        std::vector<CRYPTO_BUFFER*> certChain = {cert_.get()};
-        if (!SSL_CTX_set_chain_and_key(sslCtx_.get(), certChain.data(), certChain.size(), privKey_.get(), nullptr)) {
-            return TlsError::UnknownFailure;
+        if (!sslCtx_) {
+            if (!cert_ || !privKey_) {
+                return TlsError::UnknownFailure;
+            }
+            sslCtx_ = CreateContext(cert_.get(), privKey_.get());
+            if (!sslCtx_) {
+                return TlsError::UnknownFailure;
+            }
         }
 
-        SSL_CTX_set_verify(sslCtx_.get(), SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
-
         ssl_.reset(SSL_new(sslCtx_.get()));
         if (!ssl_ || !SSL_set_fd(ssl_.get(), fd_)) {
             return TlsError::UnknownFailure;
         }
+        SSL_set_app_data(ssl_.get(), this);
+
+        if (!resumptionSession_.empty()) {
+            bssl::UniquePtr<SSL_SESSION> session(
+                SSL_SESSION_from_bytes(resumptionSession_.data(), resumptionSession_.size(), sslCtx_.get()));
+            if (!session || !SSL_set_session(ssl_.get(), session.get())) {
+                OH_LOG_WARN(LOG_APP, "TLS: cached session unusable, doing full handshake");
+            }
+        }
 
         SSL_set_connect_state(ssl_.get());
         if (SSL_do_handshake(ssl_.get()) != 1) {
@@ -79,6 +94,44 @@ public:
         return TlsError::Success;
     }
 
+    static bssl::UniquePtr<SSL_CTX> CreateContext(CRYPTO_BUFFER* cert, EVP_PKEY* privKey) {
+        bssl::UniquePtr<SSL_CTX> ctx(SSL_CTX_new(TLS_method()));
+        if (!ctx || !SSL_CTX_set_min_proto_version(ctx.get(), TLS1_3_VERSION) ||
+            !SSL_CTX_set_max_proto_version(ctx.get(), TLS1_3_VERSION)) {
+            return nullptr;
+        }
+
+        SSL_CTX_set_cert_verify_callback(ctx.get(), SSLSetCertVerifyCb, nullptr);
+
+        std::vector<CRYPTO_BUFFER*> certChain = {cert};
+        if (!SSL_CTX_set_chain_and_key(ctx.get(), certChain.data(), certChain.size(), privKey, nullptr)) {
+            return nullptr;
+        }
+
+        SSL_CTX_set_verify(ctx.get(), SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+
+        // 票据交给连接的 NewSessionCb 保存，不使用 SSL_CTX 内部缓存
+        SSL_CTX_set_session_cache_mode(ctx.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+        SSL_CTX_sess_set_new_cb(ctx.get(), SSLNewSessionCb);
+        return ctx;
+    }
+
+    static bssl::UniquePtr<CRYPTO_BUFFER> BufferFromPEM(std::string_view pem) {
+        bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())));
+        char* name = nullptr;
+        char* header = nullptr;
+        uint8_t* data = nullptr;
+        long dataLen = 0;
+        if (!PEM_read_bio(bio.get(), &name, &header, &data, &dataLen)) {
+            return nullptr;
+        }
+        OPENSSL_free(name);
+        OPENSSL_free(header);
+        auto ret = bssl::UniquePtr<CRYPTO_BUFFER>(CRYPTO_BUFFER_new(data, dataLen, nullptr));
+        OPENSSL_free(data);
+        return ret;
+    }
+
     std::vector<uint8_t> ReadFully(size_t size) override {
         std::vector<uint8_t> buffer(size);
         size_t offset = 0;
@@ -123,25 +176,29 @@ private:
         return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
     }
 
-    static bssl::UniquePtr<CRYPTO_BUFFER> BufferFromPEM(std::string_view pem) {
-        bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())));
-        char* name = nullptr;
-        char* header = nullptr;
+
+    static int SSLNewSessionCb(SSL* ssl, SSL_SESSION* session) {
+        auto* self = static_cast<TlsConnectionImpl*>(SSL_get_app_data(ssl));
+        if (!self || !self->newSessionCb_) {
+            return 0;
+        }
         uint8_t* data = nullptr;
-        long dataLen = 0;
-        if (!PEM_read_bio(bio.get(), &name, &header, &data, &dataLen)) {
-            return nullptr;
+        size_t len = 0;
+        if (SSL_SESSION_to_bytes(session, &data, &len)) {
+            self->newSessionCb_(std::vector<uint8_t>(data, data + len));
+            OPENSSL_free(data);
         }
-        OPENSSL_free(name);
-        OPENSSL_free(header);
-        auto ret = bssl::UniquePtr<CRYPTO_BUFFER>(CRYPTO_BUFFER_new(data, dataLen, nullptr));
-        OPENSSL_free(data);
-        return ret;
+        // 返回 0 表示未接管 session 的引用
+        return 0;
     }
 
-    static int SSLSetCertVerifyCb(X509_STORE_CTX* ctx, void* opaque) {
-        auto* self = static_cast<TlsConnectionImpl*>(opaque);
-        return self->certVerifyCb_ ? self->certVerifyCb_(ctx) : 0;
+    static int SSLSetCertVerifyCb(X509_STORE_CTX* ctx, void*) {
+        auto* ssl = static_cast<SSL*>(X509_STORE_CTX_get_ex_data(ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
+        auto* self = ssl ? static_cast<TlsConnectionImpl*>(SSL_get_app_data(ssl)) : nullptr;
+        if (self && self->certVerifyCb_) {
+            return self->certVerifyCb_(ctx);
+        }
+        return X509_verify_cert(ctx);
     }
 
     static TlsError GetFailureReason(unsigned long err) {
@@ -170,6 +227,8 @@ private:
     Role role_;
     int fd_;
     CertVerifyCb certVerifyCb_;
+    NewSessionCb newSessionCb_;
+    std::vector<uint8_t> resumptionSession_;
     bssl::UniquePtr<EVP_PKEY> privKey_;
     bssl::UniquePtr<CRYPTO_BUFFER> cert_;
     bssl::UniquePtr<SSL_CTX> sslCtx_;
@@ -186,4 +245,19 @@ std::unique_ptr<TlsConnection> TlsConnection::Create(Role role, std::string_view
     return std::make_unique<TlsConnectionImpl>(role, cert, privKey, fd);
 }
 
+std::unique_ptr<TlsConnection> TlsConnection::Create(Role role, SSL_CTX* sharedCtx, int fd) {
+    if (!sharedCtx || fd < 0) {
+        return nullptr;
+    }
+    return std::make_unique<TlsConnectionImpl>(role, sharedCtx, fd);
+}
+
+bssl::UniquePtr<SSL_CTX> TlsConnection::CreateClientContext(std::string_view certPem, EVP_PKEY* privKey) {
+    bssl::UniquePtr<CRYPTO_BUFFER> cert = TlsConnectionImpl::BufferFromPEM(certPem);
+    if (!cert || !privKey) {
+        return nullptr;
+    }
+    return TlsConnectionImpl::CreateContext(cert.get(), privKey);
+}
+
 }  // namespace scrcpy::pairing
@@ -27,10 +27,16 @@ public:
     };
 
     using CertVerifyCb = std::function<int(X509_STORE_CTX*)>;
+    // 收到服务端下发的会话票据时回调（序列化后的 SSL_SESSION），TLS 1.3 下发生在握手之后的读取中
+    using NewSessionCb = std::function<void(std::vector<uint8_t>)>;
 
     virtual ~TlsConnection() = default;
 
     virtual void SetCertVerifyCallback(CertVerifyCb cb) = 0;
+    // 握手前设置：尝试用之前保存的会话恢复；会话无效或服务端拒绝时自动退回完整握手
+    virtual void SetResumptionSession(std::vector<uint8_t> session) = 0;
+    virtual void SetNewSessionCallback(NewSessionCb cb) = 0;
+    virtual bool SessionReused() const = 0;
     virtual std::vector<uint8_t> ExportKeyingMaterial(size_t length) = 0;
     virtual TlsError DoHandshake() = 0;
     virtual std::vector<uint8_t> ReadFully(size_t size) = 0;
@@ -39,6 +45,11 @@ public:
     virtual bool WriteFully(std::string_view data) = 0;
 
     static std::unique_ptr<TlsConnection> Create(Role role, std::string_view cert, std::string_view privKey, int fd);
+    // 复用预先配置好的 SSL_CTX（见 CreateClientContext），省去每次连接解析证书与私钥
+    static std::unique_ptr<TlsConnection> Create(Role role, SSL_CTX* sharedCtx, int fd);
+
+    // 仅 TLS 1.3、带客户端证书的 SSL_CTX；证书校验与会话票据回调按连接分派，可在多个连接间共享
+    static bssl::UniquePtr<SSL_CTX> CreateClientContext(std::string_view certPem, EVP_PKEY* privKey);
 };
 
 }  // namespace scrcpy::pairing
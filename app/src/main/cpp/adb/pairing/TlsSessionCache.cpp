@@ -0,0 +1,220 @@
+#include "adb/pairing/TlsSessionCache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <hilog/log.h>
+
+#ifndef LOG_TAG
+#define LOG_TAG "AdbTlsSession"
+#endif
+
+namespace scrcpy::pairing {
+namespace {
+
+constexpr char kCacheFileName[] = "tls_sessions.cache";
+
+int64_t NowSec() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string ToHex(const std::vector<uint8_t>& data) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(data.size() * 2);
+    for (uint8_t byte : data) {
+        out.push_back(kDigits[byte >> 4]);
+        out.push_back(kDigits[byte & 0x0f]);
+    }
+    return out;
+}
+
+bool FromHex(const std::string& hex, std::vector<uint8_t>& out) {
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    out.resize(hex.size() / 2);
+    for (size_t i = 0; i < out.size(); ++i) {
+        int hi = nibble(hex[i * 2]);
+        int lo = nibble(hex[i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+}  // namespace
+
+TlsSessionCache& TlsSessionCache::Instance() {
+    static TlsSessionCache cache;
+    return cache;
+}
+
+TlsSessionCache::~TlsSessionCache() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shuttingDown_ = true;
+    }
+    saveCv_.notify_all();
+    if (saveThread_.joinable()) {
+        saveThread_.join();
+    }
+}
+
+void TlsSessionCache::SetPersistDirectory(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    persistPath_ = dir.empty() ? std::string() : dir + "/" + kCacheFileName;
+    if (!persistPath_.empty()) {
+        LoadLocked();
+    }
+}
+
+std::vector<uint8_t> TlsSessionCache::Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return {};
+    }
+    if (NowSec() - it->second.storedAtSec > kMaxAgeSec) {
+        entries_.erase(it);
+        SaveLocked();
+        return {};
+    }
+    return it->second.session;
+}
+
+void TlsSessionCache::Put(const std::string& key, std::vector<uint8_t> session) {
+    if (session.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[key];
+    entry.session = std::move(session);
+    entry.storedAtSec = NowSec();
+    while (entries_.size() > kMaxEntries) {
+        auto oldest = entries_.begin();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->second.storedAtSec < oldest->second.storedAtSec) {
+                oldest = it;
+            }
+        }
+        entries_.erase(oldest);
+    }
+    SaveLocked();
+}
+
+void TlsSessionCache::Remove(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.erase(key) > 0) {
+        SaveLocked();
+    }
+}
+
+void TlsSessionCache::RecordHandshake(bool resumed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (resumed) {
+        ++resumed_;
+    } else {
+        ++fullHandshakes_;
+    }
+}
+
+std::string TlsSessionCache::ToJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+    oss << "{\"cached\":" << entries_.size()
+        << ",\"persistent\":" << (persistPath_.empty() ? "false" : "true")
+        << ",\"resumed\":" << resumed_
+        << ",\"full\":" << fullHandshakes_ << "}";
+    return oss.str();
+}
+
+// 文件格式：每行 "key\tstoredAtSec\thex(session)"
+void TlsSessionCache::LoadLocked() {
+    std::ifstream in(persistPath_);
+    if (!in) {
+        return;
+    }
+    const int64_t now = NowSec();
+    size_t loaded = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        std::string storedAt;
+        std::string hex;
+        if (!std::getline(fields, key, '\t') || !std::getline(fields, storedAt, '\t') ||
+            !std::getline(fields, hex)) {
+            continue;
+        }
+        Entry entry;
+        entry.storedAtSec = std::strtoll(storedAt.c_str(), nullptr, 10);
+        if (now - entry.storedAtSec > kMaxAgeSec || !FromHex(hex, entry.session) || entry.session.empty()) {
+            continue;
+        }
+        entries_[key] = std::move(entry);
+        ++loaded;
+    }
+    OH_LOG_INFO(LOG_APP, "[TlsSession] Loaded %{public}zu cached sessions", loaded);
+}
+
+void TlsSessionCache::SaveLocked() {
+    if (persistPath_.empty()) {
+        return;
+    }
+    saveDirty_ = true;
+    if (!saveThread_.joinable()) {
+        saveThread_ = std::thread(&TlsSessionCache::SaveThreadFunc, this);
+    }
+    saveCv_.notify_all();
+}
+
+void TlsSessionCache::SaveThreadFunc() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        saveCv_.wait(lock, [this]() { return saveDirty_ || shuttingDown_; });
+        if (!saveDirty_) {
+            return;
+        }
+        // 去抖：窗口内的后续修改并入这次写盘；退出时不再等待，直接把最后的状态写出
+        saveCv_.wait_for(lock, std::chrono::milliseconds(kSaveDebounceMs), [this]() { return shuttingDown_; });
+        saveDirty_ = false;
+        const std::string path = persistPath_;
+        const std::map<std::string, Entry> snapshot = entries_;
+        lock.unlock();
+        if (!path.empty()) {
+            WriteFile(path, snapshot);
+        }
+        lock.lock();
+    }
+}
+
+void TlsSessionCache::WriteFile(const std::string& path, const std::map<std::string, Entry>& entries) {
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::trunc);
+        if (!out) {
+            OH_LOG_WARN(LOG_APP, "[TlsSession] Failed to write %{public}s", tmpPath.c_str());
+            return;
+        }
+        for (const auto& item : entries) {
+            out << item.first << '\t' << item.second.storedAtSec << '\t' << ToHex(item.second.session) << '\n';
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        OH_LOG_WARN(LOG_APP, "[TlsSession] Failed to replace %{public}s", path.c_str());
+    }
+}
+
+}  // namespace scrcpy::pairing
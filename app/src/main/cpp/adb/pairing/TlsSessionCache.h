@@ -0,0 +1,66 @@
+#pragma once
+
+// TLS 会话缓存：按 "对端地址|客户端公钥指纹" 保存 TLS 1.3 会话票据，STLS 重连时用于恢复会话，
+// 跳过完整握手与证书交换。可选持久化到应用目录，进程重启后仍可恢复。
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace scrcpy::pairing {
+
+class TlsSessionCache {
+public:
+    static TlsSessionCache& Instance();
+
+    // 设置持久化目录并加载已有缓存；空串表示仅内存缓存
+    void SetPersistDirectory(const std::string& dir);
+
+    std::vector<uint8_t> Get(const std::string& key);
+    void Put(const std::string& key, std::vector<uint8_t> session);
+    void Remove(const std::string& key);
+
+    // 统计每次 STLS 握手是否为会话恢复
+    void RecordHandshake(bool resumed);
+    std::string ToJson() const;
+
+private:
+    TlsSessionCache() = default;
+    ~TlsSessionCache();
+
+    struct Entry {
+        std::vector<uint8_t> session;
+        int64_t storedAtSec = 0;
+    };
+
+    void LoadLocked();
+    // 只标记脏并唤醒写盘线程：Put/Get 在 TLS 读线程上调用，不在这里做文件 I/O
+    void SaveLocked();
+    void SaveThreadFunc();
+    static void WriteFile(const std::string& path, const std::map<std::string, Entry>& entries);
+
+    static constexpr size_t kMaxEntries = 32;
+    // 票据自身有效期由服务端决定，这里再设一个上限，避免长期保留过期票据
+    static constexpr int64_t kMaxAgeSec = 7 * 24 * 3600;
+    // 连续的票据更新（TLS 1.3 一次握手常下发多张）合并成一次写盘
+    static constexpr int kSaveDebounceMs = 500;
+
+    mutable std::mutex mutex_;
+    std::string persistPath_;
+    std::map<std::string, Entry> entries_;
+    uint64_t resumed_ = 0;
+    uint64_t fullHandshakes_ = 0;
+
+    std::thread saveThread_;
+    std::condition_variable saveCv_;
+    bool saveDirty_ = false;
+    bool shuttingDown_ = false;
+};
+
+}  // namespace scrcpy::pairing
@@ -9,6 +9,11 @@
 #include <condition_variable>
 #include <chrono>
 #include <cstring>
+#include <functional>
+#include <memory>
+
+#include "util/MemoryBudget.h"
+#include "util/ProfiledMutex.h"
 
 /**
  * RingBuffer - SPSC (Single-Producer Single-Consumer) Lock-Free Hybrid Buffer.
@@ -31,16 +36,45 @@ public:
         buffer_.resize(capacity_);
     }
 
+    // Largest power-of-2 capacity not above `bytes`, so a budget grant is never exceeded by rounding up.
+    // Masked indexing needs a power of 2, so a grant just below one is halved (a 63.9 MiB grant
+    // yields a 32 MiB ring). Uncontested grants are the per-kind requested sizes, which are powers
+    // of 2 and map 1:1; the halving only happens while the budget is being shared or under pressure.
+    static size_t floorCapacity(size_t bytes) {
+        size_t cap = 4096;
+        while (cap <= bytes / 2) cap <<= 1;
+        return cap;
+    }
+
+    // Budget-managed soft limit: occupancy never exceeds lease->limit(), which may shrink
+    // under memory pressure or when more streams share the budget. Must be called before use.
+    void attachBudget(std::shared_ptr<BudgetLease> lease) {
+        budget_ = std::move(lease);
+        if (budget_) budget_->setAllocated(capacity_);
+    }
+
+    // Hands the budget share back once the stream is closed. The lease stays attached, so
+    // effectiveCapacity() keeps its last value while the reader drains what is left.
+    void releaseBudget() {
+        if (budget_) budget_->release();
+    }
+
+    size_t effectiveCapacity() const {
+        if (!budget_) return capacity_;
+        return std::min(capacity_, std::max<size_t>(budget_->limit(), 4096));
+    }
+
     // Producer: Get write pointer and available contiguous size
     std::pair<uint8_t*, size_t> getWritePtr() {
         uint64_t h = head_.load(std::memory_order_relaxed);
         uint64_t t = tail_.load(std::memory_order_acquire);
         
         uint64_t size = h - t;
-        if (size >= capacity_) return {nullptr, 0}; // Full
+        const size_t limit = effectiveCapacity();
+        if (size >= limit) return {nullptr, 0}; // Full
 
         uint64_t writeIdx = h & mask_;
-        size_t available = capacity_ - size;
+        size_t available = limit - size;
         size_t contiguous = capacity_ - writeIdx;
         
         return {&buffer_[writeIdx], std::min(available, contiguous)};
@@ -68,12 +102,46 @@ public:
         return {&buffer_[readIdx], std::min(static_cast<size_t>(size), contiguous)};
     }
 
+    // Consumer: 跳过已借出但尚未 consumeRead 的 skip 字节，返回其后的连续可读区（零拷贝发送用）
+    std::pair<const uint8_t*, size_t> getReadPtr(size_t skip) {
+        uint64_t t = tail_.load(std::memory_order_relaxed) + skip;
+        uint64_t h = head_.load(std::memory_order_acquire);
+        if (h <= t) return {nullptr, 0};
+
+        uint64_t readIdx = t & mask_;
+        size_t contiguous = capacity_ - readIdx;
+        return {&buffer_[readIdx], std::min(static_cast<size_t>(h - t), contiguous)};
+    }
+
     // Consumer: Consume bytes
     void consumeRead(size_t consumed) {
         uint64_t t = tail_.load(std::memory_order_relaxed);
-        // Release ordering ensures data read completion is theoretically ordered (though for SPSC read it's more about tail update visibility)
-        tail_.store(t + consumed, std::memory_order_release);
+        // seq_cst pairs with notifyWhenWritable(): either the producer sees the new tail, or we see its waiter
+        tail_.store(t + consumed, std::memory_order_seq_cst);
         cv_.notify_all();
+        if (spaceWaiterArmed_.load(std::memory_order_seq_cst)) {
+            fireSpaceWaiter();
+        }
+    }
+
+    // Producer (non-blocking): register a one-shot callback run by the consumer once space is freed
+    // or the buffer is closed. Returns false without registering if space is already available,
+    // in which case the caller should retry the write directly.
+    bool notifyWhenWritable(std::function<void()> callback) {
+        {
+            auto lock = mutex_.uniqueLock();
+            spaceWaiter_ = std::move(callback);
+            spaceWaiterArmed_.store(true, std::memory_order_seq_cst);
+        }
+        if (closed_.load(std::memory_order_seq_cst) || writableSeqCst()) {
+            auto lock = mutex_.uniqueLock();
+            if (spaceWaiterArmed_.exchange(false)) {
+                spaceWaiter_ = nullptr;
+                return false;
+            }
+            // 消费者已经抢先触发了回调
+        }
+        return true;
     }
 
     // Consumer: Blocking wait for data
@@ -89,7 +157,7 @@ public:
         // Timeout 0 = Non-blocking
         if (timeoutMs == 0) return false;
 
-        std::unique_lock<std::mutex> lock(mutex_);
+        auto lock = mutex_.uniqueLock();
 
         bool result = false;
         if (timeoutMs < 0) {
@@ -114,7 +182,7 @@ public:
         if (closed_.load(std::memory_order_acquire)) return false;
         if (timeoutMs == 0) return false;
 
-        std::unique_lock<std::mutex> lock(mutex_);
+        auto lock = mutex_.uniqueLock();
         bool result = false;
         if (timeoutMs < 0) {
             cv_.wait(lock, [this, needed] {
@@ -131,9 +199,14 @@ public:
     }
 
     void close() {
-        closed_.store(true, std::memory_order_release);
-        std::unique_lock<std::mutex> lock(mutex_);
-        cv_.notify_all();
+        closed_.store(true, std::memory_order_seq_cst);
+        {
+            auto lock = mutex_.uniqueLock();
+            cv_.notify_all();
+        }
+        if (spaceWaiterArmed_.load(std::memory_order_seq_cst)) {
+            fireSpaceWaiter();
+        }
     }
 
     bool isClosed() const {
@@ -163,8 +236,24 @@ public:
         return static_cast<size_t>(h - t);
     }
 
+    // Monotonic byte positions: total bytes ever committed / consumed.
+    // totalWritten() is only meaningful on the producer thread.
+    uint64_t totalWritten() const {
+        return head_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t totalRead() const {
+        return tail_.load(std::memory_order_acquire);
+    }
+
     size_t freeSpace() const {
-        return capacity_ - size();
+        const size_t used = size();
+        const size_t limit = effectiveCapacity();
+        return used >= limit ? 0 : limit - used;
+    }
+
+    size_t capacity() const {
+        return capacity_;
     }
 
     bool empty() const {
@@ -172,6 +261,26 @@ public:
     }
 
 private:
+    bool writableSeqCst() const {
+        uint64_t h = head_.load(std::memory_order_relaxed);
+        uint64_t t = tail_.load(std::memory_order_seq_cst);
+        return h - t < effectiveCapacity();
+    }
+
+    void fireSpaceWaiter() {
+        std::function<void()> callback;
+        {
+            auto lock = mutex_.uniqueLock();
+            if (!spaceWaiterArmed_.exchange(false)) {
+                return;
+            }
+            callback.swap(spaceWaiter_);
+        }
+        if (callback) {
+            callback();
+        }
+    }
+
     std::vector<uint8_t> buffer_;
     size_t capacity_;
     size_t mask_;
@@ -183,9 +292,13 @@ private:
     std::atomic<uint64_t> tail_; // Written by Consumer
     
     // Synchronization for blocking wait
-    std::mutex mutex_;
+    ProfiledMutex mutex_{"RingBuffer::mutex_"};
     std::condition_variable cv_;
     std::atomic<bool> closed_;
+    std::shared_ptr<BudgetLease> budget_;
+    // notifyWhenWritable() 登记的一次性回调，由 spaceWaiterArmed_ 在快路径上判断是否需要加锁触发
+    std::atomic<bool> spaceWaiterArmed_{false};
+    std::function<void()> spaceWaiter_;
 };
 
 #endif // RING_BUFFER_H
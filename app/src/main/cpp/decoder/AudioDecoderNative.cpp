@@ -1,4 +1,5 @@
 #include "decoder/AudioDecoderNative.h"
+#include "diag/FlightRecorder.h"
 
 #include <hilog/log.h>
 #include <cstring>
@@ -30,10 +31,42 @@ AudioDecoderNative::AudioDecoderNative()
       sampleRate_(48000), channelCount_(2),
       codecType_("opus"), context_(nullptr), currentFrame_(nullptr) {
     
+    pcmBudget_ = MemoryBudget::instance().acquire(BudgetCategory::PcmPool, "pcm",
+                                                  PCM_POOL_SIZE * 2 * sizeof(PcmFrame),
+                                                  PCM_POOL_SIZE / 2 * sizeof(PcmFrame));
+
     // Fill pool with initial frames
     for (size_t i = 0; i < PCM_POOL_SIZE; ++i) {
         freePcmFrames_.enqueue(new PcmFrame());
     }
+    pcmFrameCount_.store(PCM_POOL_SIZE);
+    pcmBudget_->setAllocated(PCM_POOL_SIZE * sizeof(PcmFrame));
+}
+
+PcmFrame* AudioDecoderNative::AcquirePcmFrame() {
+    PcmFrame* frame = nullptr;
+    if (freePcmFrames_.try_dequeue(frame)) {
+        return frame;
+    }
+    frame = new PcmFrame();
+    size_t count = pcmFrameCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    pcmBudget_->setAllocated(count * sizeof(PcmFrame));
+    return frame;
+}
+
+void AudioDecoderNative::RecyclePcmFrame(PcmFrame* frame) {
+    if (frame == nullptr) return;
+    if (pcmFrameCount_.load(std::memory_order_relaxed) * sizeof(PcmFrame) > pcmBudget_->limit()) {
+        DeletePcmFrame(frame);
+        return;
+    }
+    freePcmFrames_.enqueue(frame);
+}
+
+void AudioDecoderNative::DeletePcmFrame(PcmFrame* frame) {
+    delete frame;
+    size_t count = pcmFrameCount_.fetch_sub(1, std::memory_order_relaxed) - 1;
+    pcmBudget_->setAllocated(count * sizeof(PcmFrame));
 }
 
 AudioDecoderNative::~AudioDecoderNative() {
@@ -42,6 +75,8 @@ AudioDecoderNative::~AudioDecoderNative() {
 
 void AudioDecoderNative::OnError(OH_AVCodec* codec, int32_t errorCode, void* userData) {
     OH_LOG_ERROR(LOG_APP, "[AudioNative] Decoder error: %{public}d", errorCode);
+    FlightRecorder::instance().record(FlightEvent::DecoderError, static_cast<uint32_t>(FlightStreamKind::Audio),
+                                      static_cast<uint32_t>(errorCode));
 }
 
 void AudioDecoderNative::OnStreamChanged(OH_AVCodec* codec, OH_AVFormat* format, void* userData) {
@@ -67,11 +102,8 @@ void AudioDecoderNative::OnNewOutputBuffer(OH_AVCodec* codec, uint32_t index, OH
         if (ctx->decoder->pcmQueue_.size_approx() < PCM_POOL_SIZE) {
             // Decoding mode: we still need to copy from AVBuffer to PcmFrame
             // Get a free frame
-            PcmFrame* frame = nullptr;
-            if (!ctx->decoder->freePcmFrames_.try_dequeue(frame)) {
-                 frame = new PcmFrame();
-            }
-            
+            PcmFrame* frame = ctx->decoder->AcquirePcmFrame();
+
             size_t copySize = std::min(static_cast<size_t>(attr.size), sizeof(frame->data));
             std::memcpy(frame->data.data(), data, copySize);
             frame->size = copySize;
@@ -105,7 +137,7 @@ int32_t AudioDecoderNative::OnAudioRendererWriteData(OH_AudioRenderer* renderer,
         if (self->currentFrame_ == nullptr || self->currentFrame_->remaining() == 0) {
              // Recycle used frame
              if (self->currentFrame_ != nullptr) {
-                 self->freePcmFrames_.enqueue(self->currentFrame_);
+                 self->RecyclePcmFrame(self->currentFrame_);
                  self->currentFrame_ = nullptr;
              }
              
@@ -310,10 +342,7 @@ int32_t AudioDecoderNative::GetInputBuffer(uint32_t* outIndex, uint8_t** outData
     // RAW 模式特殊处理：伪造一个 buffer
     if (isRaw_) {
         // Raw mode: Get frame from pool
-        PcmFrame* frame = nullptr;
-        if (!freePcmFrames_.try_dequeue(frame)) {
-             frame = new PcmFrame();
-        }
+        PcmFrame* frame = AcquirePcmFrame();
 
         *outIndex = 0; // Dummy
         // We use the frame pointer as the handle
@@ -395,10 +424,7 @@ int32_t AudioDecoderNative::PushData(uint8_t* data, int32_t size, int64_t pts) {
 
     // RAW模式直接放入PCM队列
     if (isRaw_) {
-        PcmFrame* frame = nullptr;
-        if (!freePcmFrames_.try_dequeue(frame)) {
-             frame = new PcmFrame();
-        }
+        PcmFrame* frame = AcquirePcmFrame();
 
         size_t copySize = std::min(static_cast<size_t>(size), sizeof(frame->data));
         std::memcpy(frame->data.data(), data, copySize);
@@ -506,10 +532,10 @@ int32_t AudioDecoderNative::Release() {
 
     // 清空buffer池
     PcmFrame* frame;
-    while (pcmQueue_.try_dequeue(frame)) { delete frame; }
-    while (freePcmFrames_.try_dequeue(frame)) { delete frame; }
+    while (pcmQueue_.try_dequeue(frame)) { DeletePcmFrame(frame); }
+    while (freePcmFrames_.try_dequeue(frame)) { DeletePcmFrame(frame); }
     if (currentFrame_) {
-        delete currentFrame_;
+        DeletePcmFrame(currentFrame_);
         currentFrame_ = nullptr;
     }
 
@@ -5,10 +5,13 @@
 #include <queue>
 #include <mutex>
 #include <array>
+#include <atomic>
+#include <memory>
 #include "concurrentqueue/blockingconcurrentqueue.h"
 #include "multimedia/player_framework/native_avcodec_audiocodec.h"
 #include "multimedia/player_framework/native_avbuffer.h"
 #include "ohaudio/native_audiorenderer.h"
+#include "util/MemoryBudget.h"
 
 struct PcmFrame {
     std::array<uint8_t, 32 * 1024> data{};
@@ -53,6 +56,11 @@ private:
 
     int32_t InitAudioRenderer();
 
+    // PCM 帧池：按需分配，归还时若超出内存预算则直接释放
+    PcmFrame* AcquirePcmFrame();
+    void RecyclePcmFrame(PcmFrame* frame);
+    void DeletePcmFrame(PcmFrame* frame);
+
     OH_AVCodec* decoder_;
     OH_AudioRenderer* renderer_;
     OH_AudioStreamBuilder* builder_;
@@ -69,6 +77,8 @@ private:
     moodycamel::BlockingConcurrentQueue<PcmFrame*> pcmQueue_;
     moodycamel::BlockingConcurrentQueue<PcmFrame*> freePcmFrames_; // Pool for raw mode
     PcmFrame* currentFrame_ = nullptr; // To hold partially consumed frame
+    std::atomic<size_t> pcmFrameCount_{0};
+    std::shared_ptr<BudgetLease> pcmBudget_;
 };
 
 #endif // AUDIO_DECODER_NATIVE_H
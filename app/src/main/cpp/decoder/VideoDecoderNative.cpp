@@ -1,6 +1,8 @@
 #include "decoder/VideoDecoderNative.h"
+#include "diag/FlightRecorder.h"
 #include <hilog/log.h>
 #include <algorithm>
+#include <atomic>
 #include <queue>
 #include <mutex>
 #include <cstring>
@@ -21,6 +23,9 @@ struct DecoderContext {
     // std::mutex queueMutex; // Removed
     // std::condition_variable queueCv; // Removed
     bool isDecFirstFrame = true;
+    std::atomic<uint64_t> renderedFrames{0};
+    std::atomic<int64_t> presentPts{-1};
+    std::atomic<uint32_t> skipOutputFrames{0};
     int32_t outputWidth = 0;
     int32_t outputHeight = 0;
 };
@@ -40,6 +45,8 @@ void VideoDecoderNative::SetSizeChangeCallback(VideoSizeChangeCallback callback)
 
 void VideoDecoderNative::OnError(OH_AVCodec* codec, int32_t errorCode, void* userData) {
     OH_LOG_ERROR(LOG_APP, "[Native] Decoder error: %{public}d", errorCode);
+    FlightRecorder::instance().record(FlightEvent::DecoderError, static_cast<uint32_t>(FlightStreamKind::Video),
+                                      static_cast<uint32_t>(errorCode));
 }
 
 void VideoDecoderNative::OnStreamChanged(OH_AVCodec* codec, OH_AVFormat* format, void* userData) {
@@ -95,7 +102,17 @@ void VideoDecoderNative::OnNewOutputBuffer(OH_AVCodec* codec, uint32_t index, OH
 
     OH_AVCodecBufferAttr attr;
     if (OH_AVBuffer_GetBufferAttr(buffer, &attr) == AV_ERR_OK) {
-        OH_VideoDecoder_RenderOutputBuffer(codec, index);
+        // 回放的 GOP 只用来重建参考帧，中间帧直接归还，避免在屏幕上快进
+        if (ctx->skipOutputFrames.load(std::memory_order_acquire) > 0 &&
+            attr.pts != ctx->presentPts.load(std::memory_order_relaxed)) {
+            ctx->skipOutputFrames.fetch_sub(1, std::memory_order_acq_rel);
+            OH_VideoDecoder_FreeOutputBuffer(codec, index);
+            return;
+        }
+        ctx->skipOutputFrames.store(0, std::memory_order_release);
+        if (OH_VideoDecoder_RenderOutputBuffer(codec, index) == AV_ERR_OK) {
+            ctx->renderedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
     } else {
         OH_VideoDecoder_FreeOutputBuffer(codec, index);
     }
@@ -287,6 +304,36 @@ int32_t VideoDecoderNative::SubmitInputBuffer(uint32_t index, void* handle, int6
     return 0;
 }
 
+int32_t VideoDecoderNative::Flush() {
+    if (!isStarted_ || decoder_ == nullptr || context_ == nullptr) return -1;
+
+    int32_t ret = OH_VideoDecoder_Flush(decoder_);
+    if (ret != AV_ERR_OK) {
+        OH_LOG_ERROR(LOG_APP, "[Native] Flush failed: %{public}d", ret);
+        return ret;
+    }
+
+    // Flush 之后旧的输入 buffer 索引全部失效，重新 Start 后由 OnNeedInputBuffer 再次下发
+    VideoInputBufferInfo stale;
+    while (context_->inputQueue.try_dequeue(stale)) {
+    }
+    context_->skipOutputFrames.store(0, std::memory_order_release);
+
+    ret = OH_VideoDecoder_Start(decoder_);
+    if (ret != AV_ERR_OK) {
+        OH_LOG_ERROR(LOG_APP, "[Native] Restart after flush failed: %{public}d", ret);
+        isStarted_ = false;
+        return ret;
+    }
+    return 0;
+}
+
+void VideoDecoderNative::SkipOutputUntil(int64_t presentPts, uint32_t maxSkipped) {
+    if (context_ == nullptr) return;
+    context_->presentPts.store(presentPts, std::memory_order_relaxed);
+    context_->skipOutputFrames.store(maxSkipped, std::memory_order_release);
+}
+
 int32_t VideoDecoderNative::Stop() {
     if (decoder_ != nullptr && isStarted_) {
         OH_VideoDecoder_Stop(decoder_);
@@ -322,3 +369,8 @@ bool VideoDecoderNative::HasAvailableBuffer() const {
     if (context_ == nullptr) return false;
     return context_->inputQueue.size_approx() > 0;
 }
+
+uint64_t VideoDecoderNative::GetRenderedFrameCount() const {
+    if (context_ == nullptr) return 0;
+    return context_->renderedFrames.load(std::memory_order_relaxed);
+}
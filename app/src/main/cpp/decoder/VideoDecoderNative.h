@@ -33,10 +33,20 @@ public:
     // Submit the filled input buffer.
     int32_t SubmitInputBuffer(uint32_t index, void* handle, int64_t pts, int32_t size, uint32_t flags);
 
+    // 清空解码器内部状态（丢弃已提交但未输出的帧），随后需重新送入 config + 关键帧
+    int32_t Flush();
+
+    // 回放缓存 GOP 时只送显 presentPts 那一帧：之前最多 maxSkipped 个输出帧只解码不上屏。
+    // maxSkipped 为 0 时取消跳过
+    void SkipOutputUntil(int64_t presentPts, uint32_t maxSkipped);
+
     int32_t Stop();
     int32_t Release();
     bool HasAvailableBuffer() const;
 
+    // 已送显的输出帧计数，用于统计重启后的出图耗时
+    uint64_t GetRenderedFrameCount() const;
+
     using VideoSizeChangeCallback = std::function<void(int32_t width, int32_t height)>;
     void SetSizeChangeCallback(VideoSizeChangeCallback callback);
     VideoSizeChangeCallback sizeChangeCallback_;
@@ -0,0 +1,214 @@
+#include "diag/FlightRecorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <hilog/log.h>
+#include <vector>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "FlightRecorder"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+struct Snapshot {
+    int64_t timeUs;
+    uint32_t event;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t d;
+};
+
+uint32_t readU32LE(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+// ADB 命令字是小端的 4 个 ASCII 字符，例如 0x45545257 = "WRTE"
+std::string commandName(uint32_t cmd) {
+    std::string name(4, '?');
+    for (size_t i = 0; i < 4; ++i) {
+        const char ch = static_cast<char>((cmd >> (i * 8)) & 0xFF);
+        if (ch >= 'A' && ch <= 'Z') {
+            name[i] = ch;
+        }
+    }
+    return name;
+}
+
+const char* kindName(uint32_t kind) {
+    switch (static_cast<FlightStreamKind>(kind)) {
+        case FlightStreamKind::Video: return "video";
+        case FlightStreamKind::Audio: return "audio";
+        case FlightStreamKind::Control: return "control";
+        default: return "other";
+    }
+}
+
+std::string formatRecord(const Snapshot& r) {
+    char line[160];
+    const double ms = static_cast<double>(r.timeUs) / 1000.0;
+    switch (static_cast<FlightEvent>(r.event)) {
+        case FlightEvent::AdbIn:
+        case FlightEvent::AdbOut:
+            snprintf(line, sizeof(line), "%12.3f %s %s arg0=%u arg1=%u len=%u", ms,
+                     static_cast<FlightEvent>(r.event) == FlightEvent::AdbIn ? "ADB_IN " : "ADB_OUT",
+                     commandName(r.a).c_str(), r.b, r.c, r.d);
+            break;
+        case FlightEvent::StreamOpen:
+            snprintf(line, sizeof(line), "%12.3f OPEN    local=%d remote=%d kind=%s", ms,
+                     static_cast<int32_t>(r.a), static_cast<int32_t>(r.b), kindName(r.c));
+            break;
+        case FlightEvent::StreamClose:
+            snprintf(line, sizeof(line), "%12.3f CLOSE   local=%d remote=%d kind=%s by=%s", ms,
+                     static_cast<int32_t>(r.a), static_cast<int32_t>(r.b), kindName(r.c), r.d ? "peer" : "local");
+            break;
+        case FlightEvent::RingHighWater:
+            snprintf(line, sizeof(line), "%12.3f RING_HW local=%d used=%u capacity=%u kind=%s", ms,
+                     static_cast<int32_t>(r.a), r.b, r.c, kindName(r.d));
+            break;
+        case FlightEvent::PacketDrop:
+            snprintf(line, sizeof(line), "%12.3f DROP    kind=%s total=%u sink=%u", ms, kindName(r.a), r.b, r.c);
+            break;
+        case FlightEvent::DecoderError:
+            snprintf(line, sizeof(line), "%12.3f DEC_ERR kind=%s code=%d", ms, kindName(r.a),
+                     static_cast<int32_t>(r.b));
+            break;
+        case FlightEvent::ControlWrite:
+            snprintf(line, sizeof(line), "%12.3f CTRL_WR type=%u bytes=%u", ms, r.a, r.b);
+            break;
+        default:
+            snprintf(line, sizeof(line), "%12.3f EVENT%u %u %u %u %u", ms, r.event, r.a, r.b, r.c, r.d);
+            break;
+    }
+    return line;
+}
+}
+
+FlightRecorder& FlightRecorder::instance() {
+    static FlightRecorder recorder;
+    return recorder;
+}
+
+FlightStreamKind FlightRecorder::kindCode(const std::string& streamKind) {
+    if (streamKind == "video") return FlightStreamKind::Video;
+    if (streamKind == "audio") return FlightStreamKind::Audio;
+    if (streamKind == "control") return FlightStreamKind::Control;
+    return FlightStreamKind::Other;
+}
+
+int64_t FlightRecorder::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin_).count();
+}
+
+void FlightRecorder::record(FlightEvent event, uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    const uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[index & (CAPACITY - 1)];
+    slot.seq.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timeUs.store(nowUs(), std::memory_order_relaxed);
+    slot.event.store(static_cast<uint32_t>(event), std::memory_order_relaxed);
+    slot.a.store(a, std::memory_order_relaxed);
+    slot.b.store(b, std::memory_order_relaxed);
+    slot.c.store(c, std::memory_order_relaxed);
+    slot.d.store(d, std::memory_order_relaxed);
+    slot.seq.store(index * 2 + 2, std::memory_order_release);
+}
+
+void FlightRecorder::recordAdbHeader(FlightEvent event, const uint8_t* header, size_t size) {
+    if (!header || size < 24) {
+        return;
+    }
+    record(event, readU32LE(header), readU32LE(header + 4), readU32LE(header + 8), readU32LE(header + 12));
+}
+
+void FlightRecorder::setDumpDirectory(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(dumpMutex_);
+    dumpDirectory_ = dir;
+}
+
+void FlightRecorder::setWindowSeconds(uint32_t seconds) {
+    windowSeconds_.store(std::max<uint32_t>(seconds, 1), std::memory_order_relaxed);
+}
+
+std::string FlightRecorder::dumpAuto(const std::string& reason) {
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex_);
+        const int64_t now = nowUs();
+        if (autoDumped_ && now - lastAutoDumpUs_ < AUTO_DUMP_INTERVAL_MS * 1000) {
+            return "";
+        }
+        autoDumped_ = true;
+        lastAutoDumpUs_ = now;
+    }
+    return dump(reason);
+}
+
+std::string FlightRecorder::dump(const std::string& reason) {
+    const int64_t now = nowUs();
+    const int64_t cutoffUs = now - static_cast<int64_t>(windowSeconds_.load(std::memory_order_relaxed)) * 1000000;
+
+    // 从最新往回读，写入中或已被覆盖的槽位直接跳过
+    std::vector<Snapshot> records;
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t count = std::min<uint64_t>(head, CAPACITY);
+    records.reserve(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; ++i) {
+        const uint64_t index = head - 1 - i;
+        const Slot& slot = slots_[index & (CAPACITY - 1)];
+        const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != index * 2 + 2) {
+            continue;
+        }
+        Snapshot r;
+        r.timeUs = slot.timeUs.load(std::memory_order_relaxed);
+        r.event = slot.event.load(std::memory_order_relaxed);
+        r.a = slot.a.load(std::memory_order_relaxed);
+        r.b = slot.b.load(std::memory_order_relaxed);
+        r.c = slot.c.load(std::memory_order_relaxed);
+        r.d = slot.d.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+        if (r.timeUs < cutoffUs) {
+            break;
+        }
+        records.push_back(r);
+    }
+    std::reverse(records.begin(), records.end());
+
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex_);
+        if (dumpDirectory_.empty()) {
+            OH_LOG_WARN(LOG_APP, "[FlightRecorder] Dump skipped, directory not set");
+            return "";
+        }
+        path = dumpDirectory_ + "/flight_recorder_" + std::to_string(dumpCount_ % MAX_DUMP_FILES) + ".log";
+        ++dumpCount_;
+    }
+
+    std::ofstream f(path, std::ios::trunc);
+    if (!f) {
+        OH_LOG_ERROR(LOG_APP, "[FlightRecorder] Open dump file failed: %{public}s", path.c_str());
+        return "";
+    }
+    const std::time_t wallClock = std::time(nullptr);
+    char timeText[32] = {0};
+    std::strftime(timeText, sizeof(timeText), "%Y-%m-%d %H:%M:%S", std::localtime(&wallClock));
+    f << "# reason=" << reason << " wall=" << timeText
+      << " uptimeMs=" << now / 1000
+      << " records=" << records.size() << " totalRecorded=" << head << "\n";
+    for (const Snapshot& r : records) {
+        f << formatRecord(r) << "\n";
+    }
+    f.close();
+
+    OH_LOG_INFO(LOG_APP, "[FlightRecorder] Dumped %{public}zu records (%{public}s) to %{public}s",
+                records.size(), reason.c_str(), path.c_str());
+    return path;
+}
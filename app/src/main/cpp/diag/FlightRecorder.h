@@ -0,0 +1,86 @@
+// FlightRecorder - 常驻的协议/管线事件黑匣子
+// 固定大小的无锁环形记录：ADB 收发消息头、流打开关闭、读缓冲水位、丢包、解码错误、控制写入。
+// 只保留最近一段时间，在 disconnected / error 事件或按需时解码成文本落盘，
+// 用于在 hilog 已经滚动掉之后还原卡死前传输层在做什么。
+#ifndef SCRCPY_FLIGHT_RECORDER_H
+#define SCRCPY_FLIGHT_RECORDER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+enum class FlightEvent : uint16_t {
+    AdbIn = 1,       // a=cmd b=arg0 c=arg1 d=payloadLen
+    AdbOut,          // a=cmd b=arg0 c=arg1 d=payloadLen
+    StreamOpen,      // a=localId b=remoteId c=kind
+    StreamClose,     // a=localId b=remoteId c=kind d=1 表示对端关闭
+    RingHighWater,   // a=localId b=used c=capacity d=kind
+    PacketDrop,      // a=kind b=累计丢弃数 c=sinkId(旁路消费者，否则 0)
+    DecoderError,    // a=kind b=errorCode
+    ControlWrite,    // a=消息类型 b=字节数
+};
+
+// 记录里的流类型编码，与 Adb::normalizeStreamKind 的取值对应
+enum class FlightStreamKind : uint32_t {
+    Other = 0,
+    Video,
+    Audio,
+    Control,
+};
+
+class FlightRecorder {
+public:
+    static FlightRecorder& instance();
+
+    static FlightStreamKind kindCode(const std::string& streamKind);
+
+    // 任意线程调用，无锁；环满后覆盖最旧的记录
+    void record(FlightEvent event, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t d = 0);
+    // 解析 24 字节 ADB 消息头并记录
+    void recordAdbHeader(FlightEvent event, const uint8_t* header, size_t size);
+
+    void setDumpDirectory(const std::string& dir);
+    void setWindowSeconds(uint32_t seconds);
+
+    // 写出最近窗口内的记录，返回文件路径；失败返回空串
+    std::string dump(const std::string& reason);
+    // 事件触发的自动落盘，限制频率，避免断线风暴时反复写文件
+    std::string dumpAuto(const std::string& reason);
+
+private:
+    FlightRecorder() = default;
+
+    static constexpr size_t CAPACITY = 16384;   // 2 的幂
+    static constexpr size_t MAX_DUMP_FILES = 4;
+    static constexpr int64_t AUTO_DUMP_INTERVAL_MS = 10000;
+
+    struct Slot {
+        // 奇数表示正在写入；读取前后两次一致才认为记录完整
+        std::atomic<uint64_t> seq{0};
+        std::atomic<int64_t> timeUs{0};
+        std::atomic<uint32_t> event{0};
+        std::atomic<uint32_t> a{0};
+        std::atomic<uint32_t> b{0};
+        std::atomic<uint32_t> c{0};
+        std::atomic<uint32_t> d{0};
+    };
+
+    int64_t nowUs() const;
+
+    const std::chrono::steady_clock::time_point origin_ = std::chrono::steady_clock::now();
+    std::array<Slot, CAPACITY> slots_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint32_t> windowSeconds_{30};
+
+    std::mutex dumpMutex_;
+    std::string dumpDirectory_;
+    uint64_t dumpCount_ = 0;
+    bool autoDumped_ = false;
+    int64_t lastAutoDumpUs_ = 0;
+};
+
+#endif // SCRCPY_FLIGHT_RECORDER_H
@@ -0,0 +1,283 @@
+#include "diag/StallWatchdog.h"
+#include "diag/ThreadCpuMonitor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <hilog/log.h>
+#include <sstream>
+#include <utility>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "StallWatchdog"
+#define LOG_DOMAIN 0x3200
+
+struct StallWatchdog::ThreadState {
+    std::string name;
+    std::atomic<int64_t> heartbeatMs{0};
+    std::atomic<const char*> resource{nullptr};
+    std::atomic<int32_t> streamId{-1};
+    std::atomic<int64_t> waitSinceMs{0};
+    std::atomic<uint8_t> waitKind{0};
+
+    // 以下只由看门狗线程在 mutex_ 下读写
+    bool stallActive = false;
+    int64_t stallSinceMs = 0;
+    const char* stallResource = nullptr;
+};
+
+namespace {
+constexpr int64_t CHECK_INTERVAL_MS = 500;
+
+thread_local StallWatchdog::ThreadState* t_threadState = nullptr;
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+StallWatchdog::ThreadScope::ThreadScope(const char* name) : state_(std::make_shared<ThreadState>()) {
+    state_->name = name;
+    state_->heartbeatMs.store(nowMs(), std::memory_order_relaxed);
+    t_threadState = state_.get();
+    StallWatchdog::instance().registerState(state_);
+}
+
+StallWatchdog::ThreadScope::~ThreadScope() {
+    if (t_threadState == state_.get()) {
+        t_threadState = nullptr;
+    }
+    StallWatchdog::instance().unregisterState(state_.get());
+}
+
+StallWatchdog::WaitScope::WaitScope(const char* resource, int32_t streamId, WaitKind kind) {
+    state_ = t_threadState;
+    if (!state_) {
+        if (kind == WaitKind::Idle) {
+            return;
+        }
+        transient_ = std::make_shared<ThreadState>();
+        transient_->name = "unregistered";
+        state_ = transient_.get();
+    } else {
+        prevResource_ = state_->resource.load(std::memory_order_relaxed);
+        prevStreamId_ = state_->streamId.load(std::memory_order_relaxed);
+        prevSinceMs_ = state_->waitSinceMs.load(std::memory_order_relaxed);
+        prevKind_ = state_->waitKind.load(std::memory_order_relaxed);
+    }
+
+    state_->waitSinceMs.store(nowMs(), std::memory_order_relaxed);
+    state_->streamId.store(streamId, std::memory_order_relaxed);
+    state_->waitKind.store(static_cast<uint8_t>(kind), std::memory_order_relaxed);
+    state_->resource.store(resource, std::memory_order_release);
+    if (transient_) {
+        StallWatchdog::instance().registerState(transient_);
+    }
+}
+
+StallWatchdog::WaitScope::~WaitScope() {
+    if (!state_) {
+        return;
+    }
+    if (transient_) {
+        StallWatchdog::instance().unregisterState(transient_.get());
+        return;
+    }
+    // 嵌套等待退出时恢复外层标记
+    state_->waitSinceMs.store(prevSinceMs_, std::memory_order_relaxed);
+    state_->streamId.store(prevStreamId_, std::memory_order_relaxed);
+    state_->waitKind.store(prevKind_, std::memory_order_relaxed);
+    state_->resource.store(prevResource_, std::memory_order_release);
+    state_->heartbeatMs.store(nowMs(), std::memory_order_relaxed);
+}
+
+StallWatchdog& StallWatchdog::instance() {
+    static StallWatchdog watchdog;
+    return watchdog;
+}
+
+void StallWatchdog::heartbeat() {
+    if (t_threadState) {
+        t_threadState->heartbeatMs.store(nowMs(), std::memory_order_relaxed);
+    }
+}
+
+StallWatchdog::~StallWatchdog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void StallWatchdog::setEventSink(EventSink sink) {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    sink_ = std::move(sink);
+}
+
+void StallWatchdog::setThresholdMs(int64_t thresholdMs) {
+    thresholdMs_.store(std::max<int64_t>(thresholdMs, CHECK_INTERVAL_MS), std::memory_order_relaxed);
+}
+
+void StallWatchdog::registerState(const std::shared_ptr<ThreadState>& state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.push_back(state);
+    ensureStartedLocked();
+}
+
+void StallWatchdog::unregisterState(const ThreadState* state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.erase(std::remove_if(threads_.begin(), threads_.end(),
+                                  [state](const std::shared_ptr<ThreadState>& item) { return item.get() == state; }),
+                   threads_.end());
+}
+
+void StallWatchdog::ensureStartedLocked() {
+    if (running_ || thread_.joinable()) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&StallWatchdog::run, this);
+}
+
+void StallWatchdog::run() {
+    ThreadCpuMonitor::setCurrentThreadName("stall-watchdog");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait_for(lock, std::chrono::milliseconds(CHECK_INTERVAL_MS), [this]() { return !running_; });
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        checkOnce();
+        lock.lock();
+    }
+}
+
+void StallWatchdog::checkOnce() {
+    std::vector<std::pair<std::string, std::string>> events;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const int64_t now = nowMs();
+        const int64_t threshold = thresholdMs_.load(std::memory_order_relaxed);
+        for (const auto& state : threads_) {
+            const char* resource = state->resource.load(std::memory_order_acquire);
+            bool stalled = false;
+            const char* stallResource = nullptr;
+            int64_t since = 0;
+            if (resource) {
+                since = state->waitSinceMs.load(std::memory_order_relaxed);
+                if (state->waitKind.load(std::memory_order_relaxed) == static_cast<uint8_t>(WaitKind::Blocking) &&
+                    now - since >= threshold) {
+                    stalled = true;
+                    stallResource = resource;
+                }
+            } else {
+                // 不在任何标记过的等待里，却长时间没有心跳：卡在了未标记的调用中
+                since = state->heartbeatMs.load(std::memory_order_relaxed);
+                if (since > 0 && now - since >= threshold) {
+                    stalled = true;
+                    stallResource = "busy";
+                }
+            }
+
+            if (stalled && (!state->stallActive || state->stallSinceMs != since ||
+                            state->stallResource != stallResource)) {
+                state->stallActive = true;
+                state->stallSinceMs = since;
+                state->stallResource = stallResource;
+                ++stallCount_;
+                std::ostringstream oss;
+                oss << "{\"thread\":\"" << state->name << "\""
+                    << ",\"resource\":\"" << stallResource << "\""
+                    << ",\"streamId\":" << (resource ? state->streamId.load(std::memory_order_relaxed) : -1)
+                    << ",\"waitingMs\":" << (now - since)
+                    << ",\"diagnosis\":\"" << diagnoseLocked(stallResource, now) << "\""
+                    << ",\"threads\":" << snapshotJsonLocked(now) << "}";
+                OH_LOG_WARN(LOG_APP, "[Watchdog] Stall: thread=%{public}s resource=%{public}s waiting=%{public}lld ms",
+                            state->name.c_str(), stallResource, static_cast<long long>(now - since));
+                events.emplace_back("stall", oss.str());
+            } else if (!stalled && state->stallActive) {
+                state->stallActive = false;
+                std::ostringstream oss;
+                oss << "{\"thread\":\"" << state->name << "\""
+                    << ",\"resource\":\"" << (state->stallResource ? state->stallResource : "") << "\""
+                    << ",\"durationMs\":" << (now - state->stallSinceMs) << "}";
+                events.emplace_back("stall_cleared", oss.str());
+            }
+        }
+    }
+
+    if (events.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    if (!sink_) {
+        return;
+    }
+    for (const auto& event : events) {
+        sink_(event.first, event.second);
+    }
+}
+
+std::string StallWatchdog::diagnoseLocked(const char* resource, int64_t now) const {
+    if (std::strcmp(resource, "ring_space") == 0) {
+        // 收包线程等读缓冲腾出空间：链路正常，下游读取/解码跟不上
+        return "slow_consumer";
+    }
+    if (std::strcmp(resource, "busy") == 0) {
+        return "thread_busy";
+    }
+    // 等待对端（OKAY、OPEN 应答、socket 发送）：看 ADB 收包线程是否也已经长时间收不到任何消息
+    const int64_t threshold = thresholdMs_.load(std::memory_order_relaxed);
+    for (const auto& state : threads_) {
+        if (state->name != "adb-recv") {
+            continue;
+        }
+        const char* resource = state->resource.load(std::memory_order_acquire);
+        if (resource && std::strcmp(resource, "adb_read") == 0 &&
+            now - state->waitSinceMs.load(std::memory_order_relaxed) >= threshold) {
+            return "link_silent";
+        }
+    }
+    return "peer_slow";
+}
+
+std::string StallWatchdog::snapshotJsonLocked(int64_t now) const {
+    std::ostringstream oss;
+    oss << "[";
+    for (size_t i = 0; i < threads_.size(); ++i) {
+        const auto& state = threads_[i];
+        if (i > 0) {
+            oss << ",";
+        }
+        const char* resource = state->resource.load(std::memory_order_acquire);
+        oss << "{\"name\":\"" << state->name << "\""
+            << ",\"heartbeatAgeMs\":" << (now - state->heartbeatMs.load(std::memory_order_relaxed));
+        if (resource) {
+            const bool blocking =
+                state->waitKind.load(std::memory_order_relaxed) == static_cast<uint8_t>(WaitKind::Blocking);
+            oss << ",\"waiting\":\"" << resource << "\""
+                << ",\"kind\":\"" << (blocking ? "blocking" : "idle") << "\""
+                << ",\"streamId\":" << state->streamId.load(std::memory_order_relaxed)
+                << ",\"waitingMs\":" << (now - state->waitSinceMs.load(std::memory_order_relaxed));
+        }
+        oss << "}";
+    }
+    oss << "]";
+    return oss.str();
+}
+
+std::string StallWatchdog::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+    oss << "{\"thresholdMs\":" << thresholdMs_.load(std::memory_order_relaxed)
+        << ",\"stalls\":" << stallCount_
+        << ",\"threads\":" << snapshotJsonLocked(nowMs()) << "}";
+    return oss.str();
+}
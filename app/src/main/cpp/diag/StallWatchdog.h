@@ -0,0 +1,93 @@
+// StallWatchdog - 管线阻塞看门狗
+// 工作线程登记后发布心跳，并在可能无限期阻塞的位置标记"正在等待 X（自 T 起）"。
+// 看门狗线程周期巡检：阻塞型等待超过阈值、或线程既不在等待也长时间没有心跳时，发出 stall 事件，
+// 附带线程、资源、流 id 和全部线程快照，用于区分"消费者太慢"和"链路已断"。
+#ifndef SCRCPY_STALL_WATCHDOG_H
+#define SCRCPY_STALL_WATCHDOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class StallWatchdog {
+public:
+    // Idle: 没有数据时的正常等待（读 socket、等包），只用于快照，不单独触发 stall
+    // Blocking: 等待对端或消费者释放资源，超过阈值即视为 stall
+    enum class WaitKind : uint8_t {
+        Idle = 0,
+        Blocking,
+    };
+
+    using EventSink = std::function<void(const std::string& type, const std::string& data)>;
+
+    struct ThreadState;
+
+    // 在线程函数入口声明，线程退出时自动注销
+    class ThreadScope {
+    public:
+        explicit ThreadScope(const char* name);
+        ~ThreadScope();
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope& operator=(const ThreadScope&) = delete;
+
+    private:
+        std::shared_ptr<ThreadState> state_;
+    };
+
+    // 包住一次可能阻塞的等待；resource 必须是字符串字面量。
+    // 未登记线程上的阻塞型等待会临时登记，Idle 等待则直接忽略
+    class WaitScope {
+    public:
+        WaitScope(const char* resource, int32_t streamId = -1, WaitKind kind = WaitKind::Blocking);
+        ~WaitScope();
+        WaitScope(const WaitScope&) = delete;
+        WaitScope& operator=(const WaitScope&) = delete;
+
+    private:
+        ThreadState* state_ = nullptr;
+        std::shared_ptr<ThreadState> transient_;
+        const char* prevResource_ = nullptr;
+        int32_t prevStreamId_ = -1;
+        int64_t prevSinceMs_ = 0;
+        uint8_t prevKind_ = 0;
+    };
+
+    static StallWatchdog& instance();
+    static void heartbeat();
+
+    void setEventSink(EventSink sink);
+    void setThresholdMs(int64_t thresholdMs);
+    std::string toJson() const;
+
+    ~StallWatchdog();
+
+private:
+    StallWatchdog() = default;
+
+    void registerState(const std::shared_ptr<ThreadState>& state);
+    void unregisterState(const ThreadState* state);
+    void ensureStartedLocked();
+    void run();
+    void checkOnce();
+    std::string snapshotJsonLocked(int64_t now) const;
+    std::string diagnoseLocked(const char* resource, int64_t now) const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<ThreadState>> threads_;
+    std::thread thread_;
+    bool running_ = false;
+    std::atomic<int64_t> thresholdMs_{3000};
+    uint64_t stallCount_ = 0;
+
+    std::mutex sinkMutex_;
+    EventSink sink_;
+};
+
+#endif // SCRCPY_STALL_WATCHDOG_H
@@ -0,0 +1,185 @@
+#include "diag/StartupTimeline.h"
+
+#include <algorithm>
+#include <hilog/log.h>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "StartupTimeline"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+// 最近邻法取分位数，样本量很小，不做插值
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+}
+
+void StartupTimeline::begin(Clock::time_point origin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    origin_ = origin;
+    started_ = true;
+    completed_ = false;
+    spans_.clear();
+}
+
+bool StartupTimeline::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return started_ && !completed_;
+}
+
+void StartupTimeline::addSpan(const std::string& phase, Clock::time_point start, Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!started_ || completed_ || hasPhaseLocked(phase)) {
+        return;
+    }
+    Span span;
+    span.phase = phase;
+    span.startMs = offsetMsLocked(start);
+    span.durationMs = std::chrono::duration<double, std::milli>(end - start).count();
+    spans_.push_back(std::move(span));
+}
+
+void StartupTimeline::mark(const std::string& phase, Clock::time_point at) {
+    addSpan(phase, at, at);
+}
+
+void StartupTimeline::addSpanSinceMark(const std::string& phase, const std::string& fromMark,
+                                       Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!started_ || completed_ || hasPhaseLocked(phase)) {
+        return;
+    }
+    auto it = std::find_if(spans_.begin(), spans_.end(),
+                           [&fromMark](const Span& span) { return span.phase == fromMark; });
+    if (it == spans_.end()) {
+        return;
+    }
+    Span span;
+    span.phase = phase;
+    span.startMs = it->startMs + it->durationMs;
+    span.durationMs = std::max(0.0, offsetMsLocked(end) - span.startMs);
+    spans_.push_back(std::move(span));
+}
+
+std::string StartupTimeline::complete(Clock::time_point at) {
+    std::vector<Span> spans;
+    double totalMs = 0;
+    std::string json;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!started_ || completed_) {
+            return "";
+        }
+        totalMs = offsetMsLocked(at);
+        Span firstFrame;
+        firstFrame.phase = "first_frame";
+        firstFrame.startMs = totalMs;
+        spans_.push_back(firstFrame);
+        completed_ = true;
+        spans = spans_;
+        json = toJsonLocked();
+    }
+    StartupStats::instance().record(spans, totalMs);
+    OH_LOG_INFO(LOG_APP, "[Startup] First frame after %{public}.1f ms, phases=%{public}zu", totalMs, spans.size());
+    return json;
+}
+
+std::string StartupTimeline::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return toJsonLocked();
+}
+
+bool StartupTimeline::hasPhaseLocked(const std::string& phase) const {
+    return std::any_of(spans_.begin(), spans_.end(),
+                       [&phase](const Span& span) { return span.phase == phase; });
+}
+
+double StartupTimeline::offsetMsLocked(Clock::time_point at) const {
+    return std::chrono::duration<double, std::milli>(at - origin_).count();
+}
+
+std::string StartupTimeline::toJsonLocked() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    double totalMs = 0;
+    for (const Span& span : spans_) {
+        totalMs = std::max(totalMs, span.startMs + span.durationMs);
+    }
+    oss << "{\"completed\":" << (completed_ ? "true" : "false")
+        << ",\"totalMs\":" << totalMs
+        << ",\"phases\":[";
+    for (size_t i = 0; i < spans_.size(); ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "{\"name\":\"" << spans_[i].phase << "\""
+            << ",\"startMs\":" << spans_[i].startMs
+            << ",\"durationMs\":" << spans_[i].durationMs << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
+
+StartupStats& StartupStats::instance() {
+    static StartupStats stats;
+    return stats;
+}
+
+void StartupStats::record(const std::vector<StartupTimeline::Span>& spans, double totalMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_.push_back({spans, totalMs});
+    while (sessions_.size() > MAX_SESSIONS) {
+        sessions_.pop_front();
+    }
+    ++totalSessions_;
+}
+
+std::string StartupStats::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 阶段按首次出现的顺序输出，便于和单次时间线对照
+    std::vector<std::string> order;
+    std::map<std::string, std::vector<double>> durations;
+    std::vector<double> totals;
+    for (const Session& session : sessions_) {
+        totals.push_back(session.totalMs);
+        for (const auto& span : session.spans) {
+            if (span.phase == "first_frame") {
+                continue;
+            }
+            auto& values = durations[span.phase];
+            if (values.empty()) {
+                order.push_back(span.phase);
+            }
+            values.push_back(span.durationMs);
+        }
+    }
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "{\"sessions\":" << totalSessions_
+        << ",\"window\":" << sessions_.size()
+        << ",\"firstFrameMs\":{\"median\":" << percentile(totals, 0.5)
+        << ",\"p90\":" << percentile(totals, 0.9) << "}"
+        << ",\"phases\":[";
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        const auto& values = durations[order[i]];
+        oss << "{\"name\":\"" << order[i] << "\""
+            << ",\"samples\":" << values.size()
+            << ",\"median\":" << percentile(values, 0.5)
+            << ",\"p90\":" << percentile(values, 0.9) << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
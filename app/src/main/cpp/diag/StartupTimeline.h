@@ -0,0 +1,75 @@
+// StartupTimeline - 单次会话的启动关键路径计时
+// 从 TCP 连接开始，依次记录 CNXN、STLS/TLS 握手、AUTH、server 推送与启动、各流 OPEN、
+// 视频流头读取、解码器 Init/Start，直到首帧。首帧时整体冻结，并计入 StartupStats 的最近会话聚合。
+#ifndef SCRCPY_STARTUP_TIMELINE_H
+#define SCRCPY_STARTUP_TIMELINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class StartupTimeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Span {
+        std::string phase;
+        double startMs = 0;     // 相对会话起点
+        double durationMs = 0;
+    };
+
+    // 以 origin 为 0 点开始新的时间线，丢弃之前的记录
+    void begin(Clock::time_point origin = Clock::now());
+    bool active() const;
+
+    // 时间线未开始或已完成时忽略；同名阶段只记录第一次
+    void addSpan(const std::string& phase, Clock::time_point start, Clock::time_point end = Clock::now());
+    void mark(const std::string& phase, Clock::time_point at = Clock::now());
+    // 以此前 mark 的时刻为起点记录阶段，例如 server 启动 = shell 打开 -> 首个媒体流建立
+    void addSpanSinceMark(const std::string& phase, const std::string& fromMark,
+                          Clock::time_point end = Clock::now());
+
+    // 记录 first_frame 并冻结时间线，返回本次会话的 JSON；已完成或未开始时返回空串
+    std::string complete(Clock::time_point at = Clock::now());
+
+    std::string toJson() const;
+
+private:
+    bool hasPhaseLocked(const std::string& phase) const;
+    double offsetMsLocked(Clock::time_point at) const;
+    std::string toJsonLocked() const;
+
+    mutable std::mutex mutex_;
+    Clock::time_point origin_;
+    bool started_ = false;
+    bool completed_ = false;
+    std::vector<Span> spans_;
+};
+
+// 最近若干次会话的启动耗时聚合（每个阶段的中位数与 p90）
+class StartupStats {
+public:
+    static StartupStats& instance();
+
+    void record(const std::vector<StartupTimeline::Span>& spans, double totalMs);
+    std::string toJson() const;
+
+private:
+    StartupStats() = default;
+
+    struct Session {
+        std::vector<StartupTimeline::Span> spans;
+        double totalMs = 0;
+    };
+
+    static constexpr size_t MAX_SESSIONS = 20;
+
+    mutable std::mutex mutex_;
+    std::deque<Session> sessions_;
+    size_t totalSessions_ = 0;
+};
+
+#endif // SCRCPY_STARTUP_TIMELINE_H
@@ -0,0 +1,177 @@
+#include "diag/ThreadCpuMonitor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <pthread.h>
+#include <sstream>
+
+struct ThreadCpuMonitor::Scope::Entry {
+    std::string role;
+    std::string name;
+    clockid_t clock = CLOCK_THREAD_CPUTIME_ID;
+    int64_t lastCpuNs = 0;
+    double cpuPercent = 0;
+};
+
+namespace {
+int64_t readClockNs(clockid_t clock) {
+    timespec ts {};
+    if (clock_gettime(clock, &ts) != 0) {
+        return -1;
+    }
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+int64_t wallNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+ThreadCpuMonitor::Scope::Scope(const char* role, const char* name) : entry_(std::make_shared<Entry>()) {
+    ThreadCpuMonitor::setCurrentThreadName(name);
+    entry_->role = role;
+    entry_->name = name;
+    if (pthread_getcpuclockid(pthread_self(), &entry_->clock) != 0) {
+        entry_->clock = CLOCK_THREAD_CPUTIME_ID;
+    }
+    entry_->lastCpuNs = std::max<int64_t>(readClockNs(CLOCK_THREAD_CPUTIME_ID), 0);
+    ThreadCpuMonitor::instance().registerEntry(entry_);
+}
+
+ThreadCpuMonitor::Scope::~Scope() {
+    ThreadCpuMonitor::instance().unregisterEntry(entry_.get());
+}
+
+ThreadCpuMonitor& ThreadCpuMonitor::instance() {
+    static ThreadCpuMonitor monitor;
+    return monitor;
+}
+
+void ThreadCpuMonitor::setCurrentThreadName(const char* name) {
+    // Linux 线程名最长 15 字符，超长会直接失败
+    char truncated[16] = {0};
+    snprintf(truncated, sizeof(truncated), "%s", name);
+    pthread_setname_np(pthread_self(), truncated);
+}
+
+ThreadCpuMonitor::~ThreadCpuMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ThreadCpuMonitor::registerEntry(const std::shared_ptr<Scope::Entry>& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(entry);
+    roles_[entry->role];
+    if (!running_ && !thread_.joinable()) {
+        running_ = true;
+        lastSampleWallNs_ = wallNs();
+        lastProcessCpuNs_ = std::max<int64_t>(readClockNs(CLOCK_PROCESS_CPUTIME_ID), 0);
+        thread_ = std::thread(&ThreadCpuMonitor::run, this);
+    }
+}
+
+void ThreadCpuMonitor::unregisterEntry(const Scope::Entry* entry) {
+    // 在退出线程自身上调用：用本线程时钟补齐最后一段，之后该时钟即失效
+    const int64_t cpu = readClockNs(CLOCK_THREAD_CPUTIME_ID);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [entry](const std::shared_ptr<Scope::Entry>& item) { return item.get() == entry; });
+    if (it == entries_.end()) {
+        return;
+    }
+    if (cpu >= entry->lastCpuNs) {
+        RoleStats& role = roles_[entry->role];
+        role.windowCpuNs += cpu - entry->lastCpuNs;
+        role.totalCpuNs += cpu - entry->lastCpuNs;
+    }
+    entries_.erase(it);
+}
+
+void ThreadCpuMonitor::run() {
+    ThreadCpuMonitor::setCurrentThreadName("cpu-sampler");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait_for(lock, std::chrono::milliseconds(SAMPLE_INTERVAL_MS), [this]() { return !running_; });
+        if (!running_) {
+            break;
+        }
+        sampleLocked();
+    }
+}
+
+void ThreadCpuMonitor::sampleLocked() {
+    const int64_t now = wallNs();
+    const int64_t wallDelta = std::max<int64_t>(now - lastSampleWallNs_, 1);
+    for (auto& entry : entries_) {
+        const int64_t cpu = readClockNs(entry->clock);
+        if (cpu < entry->lastCpuNs) {
+            continue;
+        }
+        const int64_t delta = cpu - entry->lastCpuNs;
+        entry->lastCpuNs = cpu;
+        entry->cpuPercent = 100.0 * static_cast<double>(delta) / static_cast<double>(wallDelta);
+        RoleStats& role = roles_[entry->role];
+        role.windowCpuNs += delta;
+        role.totalCpuNs += delta;
+    }
+    for (auto& item : roles_) {
+        item.second.cpuPercent = 100.0 * static_cast<double>(item.second.windowCpuNs) / static_cast<double>(wallDelta);
+        item.second.windowCpuNs = 0;
+    }
+
+    const int64_t processCpu = readClockNs(CLOCK_PROCESS_CPUTIME_ID);
+    if (processCpu >= lastProcessCpuNs_) {
+        processCpuPercent_ = 100.0 * static_cast<double>(processCpu - lastProcessCpuNs_) /
+                             static_cast<double>(wallDelta);
+        lastProcessCpuNs_ = processCpu;
+    }
+    lastSampleWallNs_ = now;
+}
+
+std::string ThreadCpuMonitor::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    double attributed = 0;
+    for (const auto& item : roles_) {
+        attributed += item.second.cpuPercent;
+    }
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "{\"intervalMs\":" << SAMPLE_INTERVAL_MS
+        << ",\"processCpuPercent\":" << processCpuPercent_
+        << ",\"unattributedCpuPercent\":" << std::max(0.0, processCpuPercent_ - attributed)
+        << ",\"roles\":[";
+    bool first = true;
+    for (const auto& item : roles_) {
+        if (!first) {
+            oss << ",";
+        }
+        first = false;
+        size_t threads = static_cast<size_t>(std::count_if(entries_.begin(), entries_.end(),
+            [&item](const std::shared_ptr<Scope::Entry>& entry) { return entry->role == item.first; }));
+        oss << "{\"role\":\"" << item.first << "\""
+            << ",\"threads\":" << threads
+            << ",\"cpuPercent\":" << item.second.cpuPercent
+            << ",\"cpuMsTotal\":" << static_cast<double>(item.second.totalCpuNs) / 1e6 << "}";
+    }
+    oss << "],\"threads\":[";
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "{\"name\":\"" << entries_[i]->name << "\""
+            << ",\"role\":\"" << entries_[i]->role << "\""
+            << ",\"cpuPercent\":" << entries_[i]->cpuPercent << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
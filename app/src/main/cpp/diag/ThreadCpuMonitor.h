@@ -0,0 +1,67 @@
+// ThreadCpuMonitor - 管线线程 CPU 占用统计
+// 线程入口声明 Scope：设置线程名并登记线程 CPU 时钟。采样线程每秒读取一次各线程的
+// CLOCK_THREAD_CPUTIME_ID，按角色（demux、send、video/audio 读取与解码、control、bridge 等）汇总 CPU%。
+#ifndef SCRCPY_THREAD_CPU_MONITOR_H
+#define SCRCPY_THREAD_CPU_MONITOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ThreadCpuMonitor {
+public:
+    class Scope {
+    public:
+        // name 会作为线程名（超过 15 字符截断），role 用于汇总
+        Scope(const char* role, const char* name);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        struct Entry;
+        friend class ThreadCpuMonitor;
+        std::shared_ptr<Entry> entry_;
+    };
+
+    static ThreadCpuMonitor& instance();
+    static void setCurrentThreadName(const char* name);
+
+    std::string toJson() const;
+
+    ~ThreadCpuMonitor();
+
+private:
+    ThreadCpuMonitor() = default;
+
+    struct RoleStats {
+        int64_t windowCpuNs = 0;
+        int64_t totalCpuNs = 0;
+        double cpuPercent = 0;
+    };
+
+    void registerEntry(const std::shared_ptr<Scope::Entry>& entry);
+    void unregisterEntry(const Scope::Entry* entry);
+    void run();
+    void sampleLocked();
+
+    static constexpr int64_t SAMPLE_INTERVAL_MS = 1000;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<Scope::Entry>> entries_;
+    std::map<std::string, RoleStats> roles_;
+    int64_t lastSampleWallNs_ = 0;
+    int64_t lastProcessCpuNs_ = 0;
+    double processCpuPercent_ = 0;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+#endif // SCRCPY_THREAD_CPU_MONITOR_H
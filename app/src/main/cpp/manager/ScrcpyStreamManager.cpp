@@ -7,6 +7,10 @@
 
 constexpr size_t VIDEO_PACKET_POOL_SIZE = 64;
 constexpr size_t AUDIO_PACKET_POOL_SIZE = 32;
+constexpr size_t VIDEO_PACKET_STORE_BUDGET = 32 * 1024 * 1024;
+constexpr size_t VIDEO_PACKET_STORE_MIN = 4 * 1024 * 1024;
+constexpr size_t AUDIO_PACKET_STORE_BUDGET = 2 * 1024 * 1024;
+constexpr size_t AUDIO_PACKET_STORE_MIN = 256 * 1024;
 
 // ===================== 辅助函数 =====================
 std::vector<uint8_t> ScrcpyStreamManager::readExact(IByteStream* source, size_t size, int32_t timeoutMs) {
@@ -26,16 +30,31 @@ void ScrcpyStreamManager::readExactToBuffer(IByteStream* source, uint8_t* dest,
 }
 
 void ScrcpyStreamManager::initPacketPools() {
-    videoPackets_.initialize(VIDEO_PACKET_POOL_SIZE);
+    // stop() 已清空缓存；这里保留的只可能是 suspendPipeline 留给恢复后回放的 GOP
+    videoPackets_.initialize(VIDEO_PACKET_POOL_SIZE, true);
     audioPackets_.initialize(AUDIO_PACKET_POOL_SIZE);
+    videoPackets_.attachBudget(MemoryBudget::instance().acquire(
+        BudgetCategory::PacketStore, "videoPackets", VIDEO_PACKET_STORE_BUDGET, VIDEO_PACKET_STORE_MIN));
+    audioPackets_.attachBudget(MemoryBudget::instance().acquire(
+        BudgetCategory::PacketStore, "audioPackets", AUDIO_PACKET_STORE_BUDGET, AUDIO_PACKET_STORE_MIN));
+    videoPackets_.setRetention(config_.videoRetention, config_.maxRetainedVideoBytes);
 }
 
-void ScrcpyStreamManager::resetPacketPools() {
-    videoPackets_.reset();
+void ScrcpyStreamManager::trimMemory(MemoryPressure level) {
+    const bool dropGop = level == MemoryPressure::Low || level == MemoryPressure::Critical;
+    videoPackets_.trim(dropGop, level == MemoryPressure::Critical);
+    audioPackets_.trim(false, false);
+}
+
+void ScrcpyStreamManager::resetPacketPools(bool keepVideoGop) {
+    videoPackets_.reset(keepVideoGop);
     audioPackets_.reset();
 }
 
 void ScrcpyStreamManager::emitEvent(const std::string& type, const std::string& data) {
+    if (type == "disconnected" || type == "error") {
+        FlightRecorder::instance().dumpAuto(type + ":" + data);
+    }
     std::lock_guard<std::mutex> lock(eventMutex_);
     if (eventCallback_) {
         eventCallback_(type, data);
@@ -43,3 +62,24 @@ void ScrcpyStreamManager::emitEvent(const std::string& type, const std::string&
 }
 
 
+
+// ===================== 旁路消费者 =====================
+int32_t ScrcpyStreamManager::addPacketSink(std::unique_ptr<IPacketSink> sink) {
+    return packetFanout_.addSink(std::move(sink));
+}
+
+bool ScrcpyStreamManager::removePacketSink(int32_t sinkId) {
+    return packetFanout_.removeSink(sinkId);
+}
+
+int32_t ScrcpyStreamManager::startPacketServer(FanoutMediaKind kind, uint16_t port) {
+    if (!running_.load()) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(packetServerMutex_);
+    auto& server = kind == FanoutMediaKind::Video ? videoPacketServer_ : audioPacketServer_;
+    if (!server) {
+        server = std::make_unique<PacketSocketServer>(packetFanout_, kind);
+    }
+    return server->start(port);
+}
@@ -16,8 +16,11 @@ constexpr int32_t AUDIO_HANDSHAKE_TIMEOUT_MS = 10000;
 }
 
 void ScrcpyStreamManager::audioThreadFunc() {
+    StallWatchdog::ThreadScope watchdogScope("audio-reader");
+    ThreadCpuMonitor::Scope cpuScope("audio-read", "audio-reader");
+    AllocTracker::StageScope allocScope(AllocStage::AudioRead);
     try {
-        auto source = ::createByteStream(adb_, audioChannel_, audioStream_, "audio");
+        auto source = ::createByteStream(connections().audio, audioChannel_, audioStream_, "audio");
         if (!source) {
             throw std::runtime_error("audio source not found");
         }
@@ -57,6 +60,7 @@ void ScrcpyStreamManager::audioThreadFunc() {
         }
 
         OH_LOG_INFO(LOG_APP, "[AudioThread] Using codec: %{public}s", codecName.c_str());
+        packetFanout_.setStreamHeader(FanoutMediaKind::Audio, std::vector<uint8_t>(codecBytes, codecBytes + 4));
 
         audioDecoder_ = new AudioDecoderNative();
         int32_t initRet = audioDecoder_->Init(codecName.c_str(), config_.audioSampleRate, config_.audioChannelCount);
@@ -91,9 +95,10 @@ void ScrcpyStreamManager::audioThreadFunc() {
                 continue;
             }
             applyPacketMeta(packet, meta);
+            packetFanout_.publish({FanoutMediaKind::Audio, packet->data, meta.pts, meta.isConfig, false});
 
             if (meta.isConfig) {
-                audioPackets_.cacheConfig(packet->data.data(), packet->data.size(), packet->submitFlags);
+                audioPackets_.cacheConfig(packet->data->data(), packet->data->size(), packet->submitFlags);
                 audioPackets_.recycle(packet);
                 continue;
             }
@@ -103,7 +108,11 @@ void ScrcpyStreamManager::audioThreadFunc() {
     } catch (const std::exception& e) {
         if (running_.load()) {
             OH_LOG_ERROR(LOG_APP, "[AudioThread] Error: %{public}s", e.what());
-            emitEvent("error", std::string("Audio thread error: ") + e.what());
+            if (transportLost()) {
+                requestResume("audio transport");
+            } else {
+                emitEvent("error", std::string("Audio thread error: ") + e.what());
+            }
         }
     }
 
@@ -113,6 +122,9 @@ void ScrcpyStreamManager::audioThreadFunc() {
 
 void ScrcpyStreamManager::audioDecodeThreadFunc() {
     uint64_t appliedConfigSerial = 0;
+    StallWatchdog::ThreadScope watchdogScope("audio-decode");
+    ThreadCpuMonitor::Scope cpuScope("audio-decode", "audio-decode");
+    AllocTracker::StageScope allocScope(AllocStage::AudioDecode);
 
     try {
         while (running_.load() || !audioReaderDone_.load()) {
@@ -173,24 +185,27 @@ void ScrcpyStreamManager::audioDecodeThreadFunc() {
                 break;
             }
 
-            if (bufCapacity < static_cast<int32_t>(packet->data.size())) {
+            if (bufCapacity < static_cast<int32_t>(packet->data->size())) {
                 OH_LOG_ERROR(LOG_APP, "[AudioDecode] Buffer too small: %{public}d < %{public}zu",
-                             bufCapacity, packet->data.size());
+                             bufCapacity, packet->data->size());
                 audioDecoder_->SubmitInputBuffer(bufIndex, bufHandle, 0, 0, 0);
                 audioPackets_.recycle(packet);
                 continue;
             }
 
-            std::memcpy(bufData, packet->data.data(), packet->data.size());
+            std::memcpy(bufData, packet->data->data(), packet->data->size());
             int32_t submitRet = audioDecoder_->SubmitInputBuffer(
                 bufIndex,
                 bufHandle,
                 packet->pts,
-                static_cast<int32_t>(packet->data.size()),
+                static_cast<int32_t>(packet->data->size()),
                 packet->submitFlags);
             audioPackets_.recycle(packet);
             if (submitRet != 0) {
                 OH_LOG_WARN(LOG_APP, "[AudioDecode] Submit failed: %{public}d", submitRet);
+                FlightRecorder::instance().record(FlightEvent::DecoderError,
+                                                  static_cast<uint32_t>(FlightStreamKind::Audio),
+                                                  static_cast<uint32_t>(submitRet));
             }
         }
     } catch (const std::exception& e) {
@@ -20,6 +20,7 @@ bool ScrcpyStreamManager::sendControl(const uint8_t* data, size_t len) {
         return false;
     }
 
+    AllocTracker::StageScope allocScope(AllocStage::Control);
     if (controlReliableQueue_.size_approx() >= CONTROL_MSG_QUEUE_MAX) {
         return false;
     }
@@ -29,13 +30,17 @@ bool ScrcpyStreamManager::sendControl(const uint8_t* data, size_t len) {
 }
 
 void ScrcpyStreamManager::controlSendThreadFunc() {
-    auto sink = ::createByteSink(adb_, controlChannel_, controlStream_, "control");
+    auto sink = ::createByteSink(connections().control, controlChannel_, controlStream_, "control");
     if (!sink) {
         OH_LOG_WARN(LOG_APP, "[ControlSend] No sink available, thread exits");
         return;
     }
 
+    StallWatchdog::ThreadScope watchdogScope("control-send");
+    ThreadCpuMonitor::Scope cpuScope("control", "control-send");
+    AllocTracker::StageScope allocScope(AllocStage::Control);
     while (true) {
+        StallWatchdog::heartbeat();
         std::vector<uint8_t> packet;
         if (!controlReliableQueue_.wait_dequeue_timed(packet, std::chrono::milliseconds(1))) {
             if (!running_.load()) {
@@ -52,6 +57,8 @@ void ScrcpyStreamManager::controlSendThreadFunc() {
                 throw std::runtime_error("control sink closed");
             }
             sink->write(packet.data(), packet.size());
+            FlightRecorder::instance().record(FlightEvent::ControlWrite, packet.empty() ? 0 : packet[0],
+                                              static_cast<uint32_t>(packet.size()));
         } catch (const std::exception& e) {
             if (!running_.load()) {
                 break;
@@ -62,8 +69,11 @@ void ScrcpyStreamManager::controlSendThreadFunc() {
 }
 
 void ScrcpyStreamManager::controlThreadFunc() {
+    StallWatchdog::ThreadScope watchdogScope("control-reader");
+    ThreadCpuMonitor::Scope cpuScope("control", "control-reader");
+    AllocTracker::StageScope allocScope(AllocStage::Control);
     try {
-        auto source = ::createByteStream(adb_, controlChannel_, controlStream_, "control");
+        auto source = ::createByteStream(connections().control, controlChannel_, controlStream_, "control");
         if (!source) {
             throw std::runtime_error("control source not found");
         }
@@ -121,7 +131,11 @@ void ScrcpyStreamManager::controlThreadFunc() {
     } catch (const std::exception& e) {
         if (running_.load()) {
             OH_LOG_ERROR(LOG_APP, "[ControlThread] Error: %{public}s", e.what());
-            emitEvent("error", std::string("Control thread error: ") + e.what());
+            if (transportLost()) {
+                requestResume("control transport");
+            } else {
+                emitEvent("error", std::string("Control thread error: ") + e.what());
+            }
         }
     }
 }
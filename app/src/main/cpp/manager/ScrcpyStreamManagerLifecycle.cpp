@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <hilog/log.h>
+#include <unistd.h>
 
 #undef LOG_TAG
 #undef LOG_DOMAIN
@@ -40,23 +41,46 @@ int32_t ScrcpyStreamManager::start(Adb* adb, const Config& config, StreamEventCa
         stop();
     }
 
-    adb_ = adb;
-    config_ = config;
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex_);
+        config_ = config;
+    }
     eventCallback_ = callback;
-    videoStream_ = (config_.videoStreamId >= 0 && adb_) ? adb_->getStreamHandle(config_.videoStreamId) : nullptr;
-    audioStream_ = (config_.audioStreamId >= 0 && adb_) ? adb_->getStreamHandle(config_.audioStreamId) : nullptr;
-    controlStream_ = (config_.controlStreamId >= 0 && adb_) ? adb_->getStreamHandle(config_.controlStreamId) : nullptr;
+    if (adb && !adb->startupTimeline().active()) {
+        // 复用已有 ADB 连接重新拉流时，时间线从这里开始
+        adb->startupTimeline().begin();
+    }
+    setConnections(adb, config_.videoAdb ? config_.videoAdb : adb, config_.audioAdb ? config_.audioAdb : adb,
+                   config_.controlAdb ? config_.controlAdb : adb);
+    videoStream_ = (config_.videoStreamId >= 0 && videoAdb_) ? videoAdb_->getStreamHandle(config_.videoStreamId) : nullptr;
+    audioStream_ = (config_.audioStreamId >= 0 && audioAdb_) ? audioAdb_->getStreamHandle(config_.audioStreamId) : nullptr;
+    controlStream_ = (config_.controlStreamId >= 0 && controlAdb_)
+        ? controlAdb_->getStreamHandle(config_.controlStreamId) : nullptr;
 
     if (config_.videoStreamId >= 0 && !videoStream_) return -3;
     if (config_.audioStreamId >= 0 && !audioStream_) return -4;
     if (config_.controlStreamId >= 0 && !controlStream_) return -5;
 
+    stopping_.store(false);
+    StallWatchdog::instance().setEventSink(
+        [this](const std::string& type, const std::string& data) { emitEvent(type, data); });
+    startStreamThreads();
+    return 0;
+}
+
+void ScrcpyStreamManager::startStreamThreads() {
     running_.store(true);
     videoReaderDone_.store(false);
     audioReaderDone_.store(false);
+    lastVideoPacketNs_.store(0);
     drainQueue(controlReliableQueue_);
     initPacketPools();
 
+    if (config_.reverse) {
+        // 反向模式由 accept 线程在连接到达后起收流线程
+        acceptThread_ = std::thread(&ScrcpyStreamManager::acceptThreadFunc, this);
+        return;
+    }
     if (videoStream_) {
         videoThread_ = std::thread(&ScrcpyStreamManager::videoThreadFunc, this);
     }
@@ -69,8 +93,6 @@ int32_t ScrcpyStreamManager::start(Adb* adb, const Config& config, StreamEventCa
         controlThread_ = std::thread(&ScrcpyStreamManager::controlThreadFunc, this);
         controlSendThread_ = std::thread(&ScrcpyStreamManager::controlSendThreadFunc, this);
     }
-
-    return 0;
 }
 
 int32_t ScrcpyStreamManager::startReverse(Adb* adb, const Config& config, StreamEventCallback callback) {
@@ -79,9 +101,16 @@ int32_t ScrcpyStreamManager::startReverse(Adb* adb, const Config& config, Stream
         stop();
     }
 
-    adb_ = adb;
-    config_ = config;
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex_);
+        config_ = config;
+    }
     eventCallback_ = callback;
+    if (adb && !adb->startupTimeline().active()) {
+        adb->startupTimeline().begin();
+    }
+    // 反向模式的数据经主连接进来（进程内直通或本地 socket），不使用连接池
+    setConnections(adb, adb, adb, adb);
     videoStream_ = nullptr;
     audioStream_ = nullptr;
     controlStream_ = nullptr;
@@ -91,46 +120,71 @@ int32_t ScrcpyStreamManager::startReverse(Adb* adb, const Config& config, Stream
     if (listenerRet != 0) {
         closeLocalTunnels();
         closeListener();
-        adb_ = nullptr;
+        setConnections(nullptr, nullptr, nullptr, nullptr);
         return listenerRet;
     }
 
-    running_.store(true);
-    videoReaderDone_.store(false);
-    audioReaderDone_.store(false);
-    drainQueue(controlReliableQueue_);
-    initPacketPools();
-    acceptThread_ = std::thread(&ScrcpyStreamManager::acceptThreadFunc, this);
+    stopping_.store(false);
+    StallWatchdog::instance().setEventSink(
+        [this](const std::string& type, const std::string& data) { emitEvent(type, data); });
+    startStreamThreads();
 
     return static_cast<int32_t>(port);
 }
 
 void ScrcpyStreamManager::stop() {
+    // 先结束断线恢复线程：恢复过程中 running_ 为 false，但解码器等资源仍需在下面释放
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        stopping_.store(true);
+        if (connectingAdb_) {
+            connectingAdb_->close();
+        }
+    }
+    resumeCv_.notify_all();
+    const bool hadResume = resumeThread_.joinable();
+    joinThread(resumeThread_);
+    resumeEnabled_.store(false);
+
     bool wasRunning = running_.exchange(false);
-    if (!wasRunning && !videoThread_.joinable() && !videoDecodeThread_.joinable() &&
+    if (!wasRunning && !hadResume && !videoThread_.joinable() && !videoDecodeThread_.joinable() &&
         !audioThread_.joinable() && !audioDecodeThread_.joinable() &&
         !controlThread_.joinable() && !controlSendThread_.joinable() &&
         !acceptThread_.joinable()) {
         return;
     }
 
+    StallWatchdog::instance().setEventSink(nullptr);
     closeLocalTunnels();
     closeListener();
+    // accept 线程可能正在领取直通流，先等它退出再关闭这些流
+    joinThread(acceptThread_);
+    closeDirectReverseStreams();
+    if (acceptWakeFd_ >= 0) {
+        ::close(acceptWakeFd_);
+        acceptWakeFd_ = -1;
+    }
     videoReaderDone_.store(true);
     audioReaderDone_.store(true);
     videoPackets_.notifyAll();
     audioPackets_.notifyAll();
 
-    if (adb_) {
-        if (config_.videoStreamId >= 0) {
-            adb_->streamClose(config_.videoStreamId);
-        }
-        if (config_.audioStreamId >= 0) {
-            adb_->streamClose(config_.audioStreamId);
-        }
-        if (config_.controlStreamId >= 0) {
-            adb_->streamClose(config_.controlStreamId);
-        }
+    if (videoAdb_ && config_.videoStreamId >= 0) {
+        videoAdb_->streamClose(config_.videoStreamId);
+    }
+    if (audioAdb_ && config_.audioStreamId >= 0) {
+        audioAdb_->streamClose(config_.audioStreamId);
+    }
+    if (controlAdb_ && config_.controlStreamId >= 0) {
+        controlAdb_->streamClose(config_.controlStreamId);
+    }
+    if (adb_ && serverShellId_ >= 0) {
+        // 恢复时由这里启动的 server，关闭 shell 流即结束它
+        adb_->streamClose(serverShellId_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex_);
+        serverShellId_ = -1;
     }
 
     joinThread(videoThread_);
@@ -143,6 +197,12 @@ void ScrcpyStreamManager::stop() {
     drainQueue(controlReliableQueue_);
     releaseLocalTunnels();
     resetPacketPools();
+    {
+        std::lock_guard<std::mutex> lock(packetServerMutex_);
+        videoPacketServer_.reset();
+        audioPacketServer_.reset();
+    }
+    packetFanout_.reset();
 
     if (videoDecoder_) {
         videoDecoder_->Release();
@@ -158,5 +218,71 @@ void ScrcpyStreamManager::stop() {
     videoStream_ = nullptr;
     audioStream_ = nullptr;
     controlStream_ = nullptr;
-    adb_ = nullptr;
+    setConnections(nullptr, nullptr, nullptr, nullptr);
+    videoCodecType_.clear();
+}
+
+void ScrcpyStreamManager::suspendPipeline() {
+    // 与 stop() 相同的收尾顺序，但保留解码器、surface 和旁路消费者，供恢复后接回
+    running_.store(false);
+    closeLocalTunnels();
+    if (adb_ && reversePort_ != 0) {
+        // 监听 socket 与端口保留，恢复后登记到新连接上
+        adb_->unregisterLocalReverseTarget(reversePort_);
+    }
+    wakeAcceptThread();
+    joinThread(acceptThread_);
+    closeDirectReverseStreams();
+    videoReaderDone_.store(true);
+    audioReaderDone_.store(true);
+    videoPackets_.notifyAll();
+    audioPackets_.notifyAll();
+
+    // 旧连接已失联，关闭后所有阻塞在流缓冲上的读写立即返回
+    for (Adb* adb : {adb_, videoAdb_, audioAdb_, controlAdb_}) {
+        if (adb) {
+            adb->close();
+        }
+    }
+
+    joinThread(videoThread_);
+    joinThread(videoDecodeThread_);
+    joinThread(audioThread_);
+    joinThread(audioDecodeThread_);
+    joinThread(controlThread_);
+    joinThread(controlSendThread_);
+    drainQueue(controlReliableQueue_);
+    releaseLocalTunnels();
+    // 视频 GOP 留给沿用的解码器在恢复后回放
+    resetPacketPools(true);
+    // 音频解码器不绑定 surface，恢复后按新 server 的编码重新创建
+    if (audioDecoder_) {
+        audioDecoder_->Release();
+        delete audioDecoder_;
+        audioDecoder_ = nullptr;
+    }
+
+    videoStream_ = nullptr;
+    audioStream_ = nullptr;
+    controlStream_ = nullptr;
+    std::lock_guard<std::mutex> lock(connectionMutex_);
+    serverShellId_ = -1;
+}
+
+ScrcpyStreamManager::Connections ScrcpyStreamManager::connections() const {
+    std::lock_guard<std::mutex> lock(connectionMutex_);
+    Connections snapshot;
+    snapshot.primary = adb_;
+    snapshot.video = videoAdb_;
+    snapshot.audio = audioAdb_;
+    snapshot.control = controlAdb_;
+    return snapshot;
+}
+
+void ScrcpyStreamManager::setConnections(Adb* primary, Adb* video, Adb* audio, Adb* control) {
+    std::lock_guard<std::mutex> lock(connectionMutex_);
+    adb_ = primary;
+    videoAdb_ = video;
+    audioAdb_ = audio;
+    controlAdb_ = control;
 }
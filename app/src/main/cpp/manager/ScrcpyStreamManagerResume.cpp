@@ -0,0 +1,375 @@
+#include "ScrcpyStreamManager.h"
+
+#include "adb/crypto/AdbKeyPair.h"
+
+#include <chrono>
+#include <hilog/log.h>
+#include <sstream>
+#include <stdexcept>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "StreamManager"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+constexpr int32_t RESUME_POLL_MS = 250;
+constexpr int32_t RESUME_FORWARD_RETRY_MS = 100;
+constexpr int32_t RESUME_BACKOFF_MS = 300;
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+bool ScrcpyStreamManager::enableAutoResume(const ResumeOptions& options) {
+    Adb* primary = connections().primary;
+    if (!primary || primary->remoteHost().empty()) {
+        OH_LOG_WARN(LOG_APP, "[Resume] Connection has no remote endpoint, auto resume disabled");
+        return false;
+    }
+    if (options.serverCommand.empty() || options.socketName.empty()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        if (stopping_.load()) {
+            return false;
+        }
+        resumeOptions_ = options;
+        if (resumeOptions_.deadPeerMs <= 0) {
+            resumeOptions_.deadPeerMs = ResumeOptions().deadPeerMs;
+        }
+        if (resumeOptions_.targetMs <= 0) {
+            resumeOptions_.targetMs = ResumeOptions().targetMs;
+        }
+        if (resumeOptions_.maxAttempts <= 0) {
+            resumeOptions_.maxAttempts = 1;
+        }
+    }
+    resumeEnabled_.store(true);
+    if (!resumeThread_.joinable()) {
+        resumeThread_ = std::thread(&ScrcpyStreamManager::resumeThreadFunc, this);
+    }
+    OH_LOG_INFO(LOG_APP, "[Resume] Enabled for %{public}s:%{public}d, deadPeer=%{public}d ms target=%{public}d ms",
+                primary->remoteHost().c_str(), primary->remotePort(), options.deadPeerMs, options.targetMs);
+    return true;
+}
+
+std::shared_ptr<Adb> ScrcpyStreamManager::resumedAdb() const {
+    std::lock_guard<std::mutex> lock(resumeMutex_);
+    return resumedAdb_;
+}
+
+bool ScrcpyStreamManager::transportLost() const {
+    if (!resumeEnabled_.load() || stopping_.load()) {
+        return false;
+    }
+    const Connections current = connections();
+    for (Adb* adb : {current.primary, current.video, current.audio, current.control}) {
+        if (adb && adb->isAdbClosed()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ScrcpyStreamManager::requestResume(const std::string& reason) {
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        if (resumeReason_.empty()) {
+            resumeReason_ = reason;
+        }
+    }
+    resumeCv_.notify_all();
+}
+
+bool ScrcpyStreamManager::resumeCancelled() const {
+    return stopping_.load();
+}
+
+void ScrcpyStreamManager::resumeThreadFunc() {
+    ThreadCpuMonitor::Scope cpuScope("resume", "session-resume");
+    while (true) {
+        std::string reason;
+        int32_t deadPeerMs = 0;
+        {
+            std::unique_lock<std::mutex> lock(resumeMutex_);
+            resumeCv_.wait_for(lock, std::chrono::milliseconds(RESUME_POLL_MS),
+                               [this]() { return stopping_.load() || !resumeReason_.empty(); });
+            if (stopping_.load()) {
+                return;
+            }
+            reason.swap(resumeReason_);
+            deadPeerMs = resumeOptions_.deadPeerMs;
+        }
+
+        if (reason.empty() && running_.load()) {
+            // 只在已经出过视频之后判定：握手和首帧各有自己的超时
+            const int64_t lastNs = lastVideoPacketNs_.load();
+            if (lastNs != 0 && steadyNowNs() - lastNs >= static_cast<int64_t>(deadPeerMs) * 1000000) {
+                reason = "dead peer";
+            } else if (transportLost()) {
+                reason = "transport closed";
+            }
+        }
+        if (reason.empty() || !running_.load()) {
+            continue;
+        }
+
+        resumeSession(reason);
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        // 恢复期间旧线程报的原因已经处理过
+        resumeReason_.clear();
+    }
+}
+
+bool ScrcpyStreamManager::resumeSession(const std::string& reason) {
+    ResumeOptions options;
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        options = resumeOptions_;
+    }
+    Adb* primary = connections().primary;
+    const std::string host = primary ? primary->remoteHost() : std::string();
+    const int port = primary ? primary->remotePort() : 0;
+    const int connectTimeoutMs = primary ? primary->connectTimeoutMs() : TcpChannel::DEFAULT_CONNECT_TIMEOUT_MS;
+    if (host.empty()) {
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    resuming_.store(true);
+    OH_LOG_WARN(LOG_APP, "[Resume] Session lost (%{public}s), reconnecting to %{public}s:%{public}d",
+                reason.c_str(), host.c_str(), port);
+    emitEvent("reconnecting", "{\"reason\":\"" + reason + "\"}");
+
+    suspendPipeline();
+    {
+        // 连接池的额外连接随旧连接一起失效，恢复后所有流都走新的主连接
+        std::lock_guard<std::mutex> lock(connectionMutex_);
+        config_.videoAdb = nullptr;
+        config_.audioAdb = nullptr;
+        config_.controlAdb = nullptr;
+    }
+
+    bool resumed = false;
+    int32_t attempt = 0;
+    std::shared_ptr<Adb> adb;
+    while (!resumed && attempt < options.maxAttempts && !resumeCancelled()) {
+        ++attempt;
+        resumeAttempts_.fetch_add(1);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.targetMs);
+        std::string failure;
+
+        adb.reset(Adb::create(host, port, connectTimeoutMs));
+        if (!adb) {
+            failure = "tcp connect failed";
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(resumeMutex_);
+                if (stopping_.load()) {
+                    adb->close();
+                    break;
+                }
+                connectingAdb_ = adb;
+            }
+            try {
+                // 不传 onWaitAuth：密钥已授权过，再要求授权时让这次尝试失败
+                AdbKeyPair keyPair = AdbKeyPair::read(options.pubKeyPath, options.priKeyPath);
+                int ret = adb->connect(keyPair);
+                if (ret != 0) {
+                    failure = "connect returned " + std::to_string(ret);
+                    const std::string detail = adb->getLastConnectError();
+                    if (!detail.empty()) {
+                        failure += " (" + detail + ")";
+                    }
+                } else {
+                    setConnections(adb.get(), adb.get(), adb.get(), adb.get());
+                    resumed = reattach(adb.get(), deadline);
+                    if (!resumed) {
+                        failure = resumeCancelled() ? "cancelled" : "server did not come back in time";
+                    }
+                }
+            } catch (const std::exception& e) {
+                failure = e.what();
+            }
+        }
+
+        if (!resumed) {
+            OH_LOG_WARN(LOG_APP, "[Resume] Attempt %{public}d/%{public}d failed: %{public}s",
+                        attempt, options.maxAttempts, failure.c_str());
+            if (connections().primary) {
+                suspendPipeline();
+            }
+            setConnections(nullptr, nullptr, nullptr, nullptr);
+            if (adb) {
+                adb->close();
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(resumeMutex_);
+            connectingAdb_.reset();
+            if (!resumed && attempt < options.maxAttempts) {
+                resumeCv_.wait_for(lock, std::chrono::milliseconds(RESUME_BACKOFF_MS * attempt),
+                                   [this]() { return stopping_.load(); });
+            }
+        }
+    }
+
+    const int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    resuming_.store(false);
+    if (resumeCancelled()) {
+        return false;
+    }
+    if (!resumed) {
+        resumeFailures_.fetch_add(1);
+        OH_LOG_ERROR(LOG_APP, "[Resume] Giving up after %{public}d attempt(s), %{public}lld ms",
+                     attempt, static_cast<long long>(elapsedMs));
+        emitEvent("disconnected", "resume");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        resumedAdb_ = adb;
+    }
+    resumeSuccesses_.fetch_add(1);
+    lastResumeMs_.store(elapsedMs);
+    OH_LOG_INFO(LOG_APP, "[Resume] Session resumed in %{public}lld ms (attempt %{public}d)",
+                static_cast<long long>(elapsedMs), attempt);
+    int32_t shellId = -1;
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex_);
+        shellId = serverShellId_;
+    }
+    std::ostringstream oss;
+    oss << "{\"reason\":\"" << reason << "\""
+        << ",\"attempt\":" << attempt
+        << ",\"elapsedMs\":" << elapsedMs
+        << ",\"serverShellId\":" << shellId << "}";
+    emitEvent("reconnected", oss.str());
+    return true;
+}
+
+bool ScrcpyStreamManager::reattach(Adb* adb, std::chrono::steady_clock::time_point deadline) {
+    std::string socketName;
+    std::string serverCommand;
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        socketName = resumeOptions_.socketName;
+        serverCommand = resumeOptions_.serverCommand + "\n";
+    }
+    auto launchServer = [this, adb, &serverCommand]() {
+        const int32_t shellId = adb->getShell();
+        if (shellId < 0) {
+            throw std::runtime_error("get shell failed");
+        }
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex_);
+            serverShellId_ = shellId;
+        }
+        adb->streamWrite(shellId, reinterpret_cast<const uint8_t*>(serverCommand.data()),
+                         serverCommand.size());
+    };
+
+    if (config_.reverse) {
+        if (reversePort_ == 0 || listenFd_ < 0) {
+            throw std::runtime_error("reverse listener closed");
+        }
+        std::vector<std::string> streamKinds;
+        if (config_.expectVideo) {
+            streamKinds.emplace_back("video");
+        }
+        if (config_.expectAudio) {
+            streamKinds.emplace_back("audio");
+        }
+        if (config_.expectControl) {
+            streamKinds.emplace_back("control");
+        }
+        adb->prepareIncomingStreamKinds(streamKinds);
+        adb->registerLocalReverseTarget(reversePort_,
+                                        [this](AdbStream* stream) { return onDirectReverseStream(stream); });
+        // 设备端的 reverse 规则随旧传输一起消失，重新登记
+        if (!adb->reverseForward("localabstract:" + socketName, "tcp:" + std::to_string(reversePort_))) {
+            throw std::runtime_error("reverse forward failed");
+        }
+        launchServer();
+        startStreamThreads();
+    } else {
+        launchServer();
+        auto openSocket = [this, adb, &socketName, deadline](const char* kind, bool required) -> int32_t {
+            while (!resumeCancelled()) {
+                try {
+                    return adb->localSocketForward(socketName, kind);
+                } catch (const std::exception&) {
+                    // server 还没开始监听
+                    if (!required || adb->isAdbClosed() || std::chrono::steady_clock::now() >= deadline) {
+                        if (required) {
+                            throw;
+                        }
+                        return -1;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(RESUME_FORWARD_RETRY_MS));
+            }
+            return -1;
+        };
+        const int32_t videoStreamId = openSocket("video", true);
+        int32_t audioStreamId = -1;
+        if (config_.audioStreamId >= 0) {
+            audioStreamId = openSocket("audio", false);
+            if (audioStreamId < 0) {
+                OH_LOG_WARN(LOG_APP, "[Resume] Audio stream not restored, continuing without audio");
+            }
+        }
+        const int32_t controlStreamId = openSocket("control", true);
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex_);
+            config_.videoStreamId = videoStreamId;
+            config_.audioStreamId = audioStreamId;
+            config_.controlStreamId = controlStreamId;
+        }
+        if (videoStreamId < 0 || controlStreamId < 0) {
+            return false;
+        }
+        videoStream_ = adb->getStreamHandle(videoStreamId);
+        audioStream_ = audioStreamId >= 0 ? adb->getStreamHandle(audioStreamId) : nullptr;
+        controlStream_ = adb->getStreamHandle(controlStreamId);
+        if (!videoStream_ || !controlStream_) {
+            return false;
+        }
+        startStreamThreads();
+    }
+
+    // 以新 server 的第一个视频包作为恢复完成
+    while (!resumeCancelled() && std::chrono::steady_clock::now() < deadline) {
+        if (lastVideoPacketNs_.load() != 0) {
+            return true;
+        }
+        if (adb->isAdbClosed()) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return false;
+}
+
+std::string ScrcpyStreamManager::resumeJson() const {
+    std::ostringstream oss;
+    oss << "{\"enabled\":" << (resumeEnabled_.load() ? "true" : "false")
+        << ",\"resuming\":" << (resuming_.load() ? "true" : "false")
+        << ",\"attempts\":" << resumeAttempts_.load()
+        << ",\"successes\":" << resumeSuccesses_.load()
+        << ",\"failures\":" << resumeFailures_.load()
+        << ",\"lastResumeMs\":" << lastResumeMs_.load();
+    {
+        std::lock_guard<std::mutex> lock(resumeMutex_);
+        oss << ",\"deadPeerMs\":" << resumeOptions_.deadPeerMs
+            << ",\"targetMs\":" << resumeOptions_.targetMs;
+    }
+    oss << "}";
+    return oss.str();
+}
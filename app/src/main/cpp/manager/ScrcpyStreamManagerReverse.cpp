@@ -1,13 +1,16 @@
 #include "ScrcpyStreamManager.h"
 
 #include "adb/channel/LocalSocketChannel.h"
+#include "util/SocketTuning.h"
 
 #include <arpa/inet.h>
 #include <cerrno>
 #include <hilog/log.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <stdexcept>
 #include <string>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -53,7 +56,52 @@ void ScrcpyStreamManager::releaseLocalTunnels() {
 }
 
 void ScrcpyStreamManager::closeListener() {
+    if (adb_ && reversePort_ != 0) {
+        adb_->unregisterLocalReverseTarget(reversePort_);
+    }
+    reversePort_ = 0;
     closeFd(listenFd_);
+    wakeAcceptThread();
+}
+
+bool ScrcpyStreamManager::onDirectReverseStream(AdbStream* stream) {
+    if (!running_.load()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(directReverseMutex_);
+        directReverseStreams_.push_back(stream);
+    }
+    wakeAcceptThread();
+    return true;
+}
+
+void ScrcpyStreamManager::wakeAcceptThread() {
+    if (acceptWakeFd_ < 0) {
+        return;
+    }
+    uint64_t one = 1;
+    ssize_t ret = ::write(acceptWakeFd_, &one, sizeof(one));
+    (void)ret;
+}
+
+void ScrcpyStreamManager::closeDirectReverseStreams() {
+    std::vector<AdbStream*> streams;
+    {
+        std::lock_guard<std::mutex> lock(directReverseMutex_);
+        streams.assign(directReverseStreams_.begin(), directReverseStreams_.end());
+        directReverseStreams_.clear();
+    }
+    streams.insert(streams.end(), acceptedDirectStreams_.begin(), acceptedDirectStreams_.end());
+    acceptedDirectStreams_.clear();
+    if (!adb_) {
+        return;
+    }
+    for (AdbStream* stream : streams) {
+        if (stream && !stream->closed.load()) {
+            adb_->streamClose(stream->localId);
+        }
+    }
 }
 
 int32_t ScrcpyStreamManager::createTcpListener(uint16_t& port) {
@@ -65,6 +113,8 @@ int32_t ScrcpyStreamManager::createTcpListener(uint16_t& port) {
 
     int reuseAddr = 1;
     setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof(reuseAddr));
+    // 缓冲大小需在 listen 之前设置，accept 出来的连接才能按大窗口协商
+    SocketTuning::apply(fd, SocketProfile::Bulk, "reverse-listener");
 
     sockaddr_in addr {};
     addr.sin_family = AF_INET;
@@ -91,31 +141,77 @@ int32_t ScrcpyStreamManager::createTcpListener(uint16_t& port) {
         return -4;
     }
 
+    acceptWakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
     listenFd_ = fd;
     port = ntohs(localAddr.sin_port);
+    if (adb_ && acceptWakeFd_ >= 0) {
+        // server 经由本 Adb 的 reverse 连回来时直接交接 AdbStream，不经回环 socket
+        reversePort_ = port;
+        adb_->registerLocalReverseTarget(port, [this](AdbStream* stream) { return onDirectReverseStream(stream); });
+    }
     return 0;
 }
 
 void ScrcpyStreamManager::acceptThreadFunc() {
+    ThreadCpuMonitor::Scope cpuScope("accept", "reverse-accept");
     try {
-        auto acceptChannel = [this]() -> AdbChannel* {
-            int fd = ::accept(listenFd_, nullptr, nullptr);
-            if (fd < 0) {
-                throw std::runtime_error("accept failed");
+        const int listenFd = listenFd_;
+        const int wakeFd = acceptWakeFd_;
+        // 按到达顺序领取下一条连接：直通的 AdbStream 优先，否则 accept 回环 socket（其它来源的连接）
+        auto acceptChannel = [this, listenFd, wakeFd](SocketProfile profile, const char* label,
+                                                      AdbStream*& directStream) -> AdbChannel* {
+            directStream = nullptr;
+            while (running_.load()) {
+                {
+                    std::lock_guard<std::mutex> lock(directReverseMutex_);
+                    if (!directReverseStreams_.empty()) {
+                        directStream = directReverseStreams_.front();
+                        directReverseStreams_.pop_front();
+                        acceptedDirectStreams_.push_back(directStream);
+                        OH_LOG_INFO(LOG_APP, "[StreamManager] %{public}s attached in-process, localId=%{public}d",
+                                    label, directStream->localId);
+                        return nullptr;
+                    }
+                }
+
+                struct pollfd fds[2] = {{listenFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+                int ret = ::poll(fds, wakeFd >= 0 ? 2 : 1, -1);
+                if (ret < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error("accept poll failed");
+                }
+                if (wakeFd >= 0 && (fds[1].revents & POLLIN)) {
+                    uint64_t value = 0;
+                    ssize_t drained = ::read(wakeFd, &value, sizeof(value));
+                    (void)drained;
+                }
+                if (fds[0].revents & POLLIN) {
+                    int fd = ::accept(listenFd, nullptr, nullptr);
+                    if (fd < 0) {
+                        throw std::runtime_error("accept failed");
+                    }
+                    SocketTuning::apply(fd, profile, label);
+                    return new LocalSocketChannel(fd, profile == SocketProfile::LowLatency);
+                }
+                if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                    throw std::runtime_error("accept failed");
+                }
             }
-            return new LocalSocketChannel(fd);
+            throw std::runtime_error("accept cancelled");
         };
 
         if (config_.expectVideo) {
-            videoChannel_ = acceptChannel();
+            videoChannel_ = acceptChannel(SocketProfile::Bulk, "reverse-video", videoStream_);
             videoThread_ = std::thread(&ScrcpyStreamManager::videoThreadFunc, this);
         }
         if (config_.expectAudio) {
-            audioChannel_ = acceptChannel();
+            audioChannel_ = acceptChannel(SocketProfile::Bulk, "reverse-audio", audioStream_);
             audioThread_ = std::thread(&ScrcpyStreamManager::audioThreadFunc, this);
         }
         if (config_.expectControl) {
-            controlChannel_ = acceptChannel();
+            controlChannel_ = acceptChannel(SocketProfile::LowLatency, "reverse-control", controlStream_);
             controlThread_ = std::thread(&ScrcpyStreamManager::controlThreadFunc, this);
             controlSendThread_ = std::thread(&ScrcpyStreamManager::controlSendThreadFunc, this);
         }
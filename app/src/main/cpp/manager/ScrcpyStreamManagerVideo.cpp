@@ -4,6 +4,7 @@
 #include <chrono>
 #include <cstring>
 #include <hilog/log.h>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -17,6 +18,8 @@ namespace {
 constexpr size_t VIDEO_STARTUP_PREBUFFER_FRAMES = 10;
 constexpr size_t VIDEO_REBUFFER_LOW_WATERMARK = 2;
 constexpr int32_t VIDEO_REBUFFER_TRIGGER_MS = 90;
+// 按估计的链路抖动放宽断流判定，上限避免真断流时迟迟不进入重缓冲
+constexpr int32_t VIDEO_REBUFFER_TRIGGER_MAX_MS = 250;
 constexpr int32_t VIDEO_REBUFFER_MAX_WAIT_MS = 120;
 constexpr int32_t VIDEO_HANDSHAKE_TIMEOUT_MS = 10000;
 
@@ -27,11 +30,16 @@ double elapsedMs(const std::chrono::steady_clock::time_point& start,
 }
 
 void ScrcpyStreamManager::videoThreadFunc() {
+    StallWatchdog::ThreadScope watchdogScope("video-reader");
+    ThreadCpuMonitor::Scope cpuScope("video-read", "video-reader");
+    AllocTracker::StageScope allocScope(AllocStage::VideoRead);
+    videoClock_.reset();
     try {
-        auto source = ::createByteStream(adb_, videoChannel_, videoStream_, "video");
+        auto source = ::createByteStream(connections().video, videoChannel_, videoStream_, "video");
         if (!source) {
             throw std::runtime_error("video source not found");
         }
+        source->enableArrivalTracking();
 
         auto readToBuffer = [this, &source](uint8_t* dest, size_t size, int32_t timeoutMs = -1) {
             readExactToBuffer(source.get(), dest, size, timeoutMs);
@@ -42,10 +50,13 @@ void ScrcpyStreamManager::videoThreadFunc() {
         };
 
         if (config_.sendDummyByte) {
+            const auto dummyStart = std::chrono::steady_clock::now();
             auto dummy = readBytes(1, VIDEO_HANDSHAKE_TIMEOUT_MS);
             (void)dummy;
+            recordStartupSpan("dummy_byte", dummyStart);
         }
 
+        const auto metaStart = std::chrono::steady_clock::now();
         auto deviceNameData = readBytes(64, VIDEO_HANDSHAKE_TIMEOUT_MS);
         std::string deviceName(reinterpret_cast<char*>(deviceNameData.data()), 64);
         deviceName = deviceName.c_str();
@@ -56,6 +67,8 @@ void ScrcpyStreamManager::videoThreadFunc() {
         int32_t height = readInt32BEValue(codecMeta.data() + 8);
         videoWidth_.store(width);
         videoHeight_.store(height);
+        packetFanout_.setStreamHeader(FanoutMediaKind::Video, codecMeta);
+        recordStartupSpan("device_meta", metaStart);
 
         std::string codecType = "h264";
         if (codecId == 1 || codecId == 1748121141) codecType = "h265";
@@ -71,65 +84,104 @@ void ScrcpyStreamManager::videoThreadFunc() {
             emitEvent("video_config", oss.str());
         }
 
-        videoDecoder_ = new VideoDecoderNative();
-        videoDecoder_->SetSizeChangeCallback([this, codecId, codecType, deviceName](int32_t w, int32_t h) {
-            this->videoWidth_.store(w);
-            this->videoHeight_.store(h);
-            std::ostringstream oss;
-            oss << "{\"codecId\":" << codecId
-                << ",\"width\":" << w
-                << ",\"height\":" << h
-                << ",\"codecType\":\"" << codecType << "\""
-                << ",\"deviceName\":\"" << deviceName << "\"}";
-            this->emitEvent("video_size_changed", oss.str());
-        });
-
-        int32_t initRet = videoDecoder_->Init(codecType.c_str(), config_.surfaceId.c_str(), width, height);
-        if (initRet != 0) {
-            OH_LOG_ERROR(LOG_APP, "[VideoThread] Decoder init failed: %{public}d", initRet);
-            emitEvent("error", "Video decoder init failed");
-            videoReaderDone_.store(true);
-            videoPackets_.notifyAll();
-            return;
+        bool reuseDecoder = false;
+        if (videoDecoder_ && videoCodecType_ == codecType) {
+            // 断线恢复：沿用绑定在 surface 上的解码器，Flush 清掉旧 server 的残留输入后直接接收新流
+            // 随后由解码线程用 suspend 前保留的 GOP 回放，不必等新 server 的下一个关键帧才出图
+            reuseDecoder = videoDecoder_->Flush() == 0;
+            if (reuseDecoder) {
+                OH_LOG_INFO(LOG_APP, "[VideoThread] Reattached existing %{public}s decoder", codecType.c_str());
+            }
         }
+        if (!reuseDecoder) {
+            if (videoDecoder_) {
+                videoDecoder_->Release();
+                delete videoDecoder_;
+                videoDecoder_ = nullptr;
+            }
+            videoCodecType_ = codecType;
+
+            videoDecoder_ = new VideoDecoderNative();
+            videoDecoder_->SetSizeChangeCallback([this, codecId, codecType, deviceName](int32_t w, int32_t h) {
+                this->videoWidth_.store(w);
+                this->videoHeight_.store(h);
+                std::ostringstream oss;
+                oss << "{\"codecId\":" << codecId
+                    << ",\"width\":" << w
+                    << ",\"height\":" << h
+                    << ",\"codecType\":\"" << codecType << "\""
+                    << ",\"deviceName\":\"" << deviceName << "\"}";
+                this->emitEvent("video_size_changed", oss.str());
+            });
 
-        int32_t startRet = videoDecoder_->Start();
-        if (startRet != 0) {
-            OH_LOG_ERROR(LOG_APP, "[VideoThread] Decoder start failed: %{public}d", startRet);
-            emitEvent("error", "Video decoder start failed");
-            videoReaderDone_.store(true);
-            videoPackets_.notifyAll();
-            return;
+            const auto initStart = std::chrono::steady_clock::now();
+            int32_t initRet = videoDecoder_->Init(codecType.c_str(), config_.surfaceId.c_str(), width, height);
+            if (initRet != 0) {
+                OH_LOG_ERROR(LOG_APP, "[VideoThread] Decoder init failed: %{public}d", initRet);
+                emitEvent("error", "Video decoder init failed");
+                videoReaderDone_.store(true);
+                videoPackets_.notifyAll();
+                return;
+            }
+            recordStartupSpan("decoder_init", initStart);
+
+            const auto decoderStart = std::chrono::steady_clock::now();
+            int32_t startRet = videoDecoder_->Start();
+            if (startRet != 0) {
+                OH_LOG_ERROR(LOG_APP, "[VideoThread] Decoder start failed: %{public}d", startRet);
+                emitEvent("error", "Video decoder start failed");
+                videoReaderDone_.store(true);
+                videoPackets_.notifyAll();
+                return;
+            }
+            recordStartupSpan("decoder_start", decoderStart);
         }
 
-        videoDecodeThread_ = std::thread(&ScrcpyStreamManager::videoDecodeThreadFunc, this);
+        videoDecodeThread_ = std::thread(&ScrcpyStreamManager::videoDecodeThreadFunc, this, reuseDecoder);
 
         uint8_t ptsBuf[8];
         uint8_t sizeBuf[4];
+        bool congested = false;
 
         while (running_.load()) {
+            const uint64_t headerPosition = source->readPosition();
             ScrcpyPacketMeta meta = readScrcpyPacketMeta(readToBuffer, ptsBuf, sizeBuf, 20 * 1024 * 1024,
                                                          "VideoThread");
+            // 时钟估计用包头随 WRTE 到达的时刻；读线程被调度延迟或缓冲里有积压时，读取时刻会偏晚
+            const int64_t headerArrivalNs = source->arrivalNs(headerPosition);
             EncodedVideoPacket* packet = readScrcpyPacketPayload<EncodedVideoPacket>(
                 readToBuffer, [this]() { return videoPackets_.acquireForWrite(); }, meta,
                 "VideoThread", "frame");
             if (!packet) {
                 continue;
             }
+            lastVideoPacketNs_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
             applyPacketMeta(packet, meta);
+            packetFanout_.publish({FanoutMediaKind::Video, packet->data, meta.pts, meta.isConfig, meta.isKeyFrame});
 
             if (meta.isConfig) {
-                videoPackets_.cacheConfig(packet->data.data(), packet->data.size(), packet->submitFlags);
+                videoPackets_.cacheConfig(packet->data->data(), packet->data->size(), packet->submitFlags);
                 videoPackets_.recycle(packet);
                 continue;
             }
 
+            videoClock_.addSample(meta.pts, headerArrivalNs > 0
+                ? std::chrono::steady_clock::time_point(std::chrono::nanoseconds(headerArrivalNs))
+                : std::chrono::steady_clock::now());
+            if (videoClock_.congested() != congested) {
+                congested = !congested;
+                emitEvent(congested ? "video_congestion" : "video_congestion_cleared", videoClock_.toJson());
+            }
+
             videoPackets_.enqueue(packet);
         }
     } catch (const std::exception& e) {
         if (running_.load()) {
             OH_LOG_ERROR(LOG_APP, "[VideoThread] Error: %{public}s", e.what());
-            emitEvent("error", std::string("Video thread error: ") + e.what());
+            if (!transportLost()) {
+                emitEvent("error", std::string("Video thread error: ") + e.what());
+            }
         }
     }
 
@@ -137,21 +189,55 @@ void ScrcpyStreamManager::videoThreadFunc() {
     videoPackets_.notifyAll();
 
     if (running_.load()) {
-        emitEvent("disconnected", "video");
+        if (transportLost()) {
+            requestResume("video transport");
+        } else {
+            emitEvent("disconnected", "video");
+        }
     }
 }
 
-void ScrcpyStreamManager::videoDecodeThreadFunc() {
+void ScrcpyStreamManager::videoDecodeThreadFunc(bool reattached) {
     uint64_t appliedConfigSerial = 0;
     bool firstFrameNotified = false;
     bool startupBuffered = false;
     bool rebuffering = false;
     bool starvationActive = false;
+    bool resyncPending = false;
+    size_t resyncPrimedPackets = 0;
+    uint64_t resyncRenderedBase = 0;
+    int64_t lastSubmittedPts = -1;
     auto rebufferStart = std::chrono::steady_clock::now();
     auto starvationStart = std::chrono::steady_clock::now();
+    auto resyncStart = std::chrono::steady_clock::now();
 
+    StallWatchdog::ThreadScope watchdogScope("video-decode");
+    ThreadCpuMonitor::Scope cpuScope("video-decode", "video-decode");
+    AllocTracker::StageScope allocScope(AllocStage::VideoDecode);
     try {
+        if (reattached) {
+            // 沿用的解码器已在收流线程里 Flush 过；旧 server 的包全部回放，新 server 的包仍从队列送入
+            resyncStart = std::chrono::steady_clock::now();
+            resyncRenderedBase = videoDecoder_->GetRenderedFrameCount();
+            resyncPrimedPackets = primeVideoDecoder(std::numeric_limits<int64_t>::max(), appliedConfigSerial, false);
+            resyncPending = true;
+        }
         while (running_.load() || !videoReaderDone_.load()) {
+            StallWatchdog::heartbeat();
+            if (videoResyncRequested_.exchange(false) && running_.load()) {
+                resyncStart = std::chrono::steady_clock::now();
+                resyncRenderedBase = videoDecoder_->GetRenderedFrameCount();
+                resyncPrimedPackets = primeVideoDecoder(lastSubmittedPts, appliedConfigSerial, true);
+                resyncPending = true;
+            }
+            if (resyncPending && videoDecoder_->GetRenderedFrameCount() > resyncRenderedBase) {
+                resyncPending = false;
+                std::ostringstream oss;
+                oss << "{\"timeToFirstPictureMs\":" << elapsedMs(resyncStart, std::chrono::steady_clock::now())
+                    << ",\"primedPackets\":" << resyncPrimedPackets << "}";
+                emitEvent("video_resync", oss.str());
+            }
+
             if ((!startupBuffered || rebuffering) && running_.load()) {
                 size_t queuedFrames = videoPackets_.queuedSize();
                 const size_t targetFrames = startupBuffered ? VIDEO_REBUFFER_LOW_WATERMARK
@@ -184,8 +270,10 @@ void ScrcpyStreamManager::videoDecodeThreadFunc() {
                     starvationStart = now;
                     continue;
                 }
+                const int32_t triggerMs = std::max(VIDEO_REBUFFER_TRIGGER_MS,
+                    std::min(static_cast<int32_t>(videoClock_.jitterMs()), VIDEO_REBUFFER_TRIGGER_MAX_MS));
                 if (!rebuffering &&
-                    elapsedMs(starvationStart, now) >= VIDEO_REBUFFER_TRIGGER_MS) {
+                    elapsedMs(starvationStart, now) >= triggerMs) {
                     rebuffering = true;
                     rebufferStart = now;
                 }
@@ -197,29 +285,9 @@ void ScrcpyStreamManager::videoDecodeThreadFunc() {
             std::vector<uint8_t> configData;
             uint32_t configFlags = 0;
             uint64_t nextConfigSerial = appliedConfigSerial;
-            if (videoPackets_.copyPendingConfig(configData, configFlags, nextConfigSerial, appliedConfigSerial)) {
-                uint32_t cfgIndex = 0;
-                uint8_t* cfgData = nullptr;
-                int32_t cfgCapacity = 0;
-                void* cfgHandle = nullptr;
-                while (running_.load()) {
-                    int32_t ret = videoDecoder_->GetInputBuffer(&cfgIndex, &cfgData, &cfgCapacity, &cfgHandle, 10);
-                    if (ret == 0) {
-                        if (cfgCapacity >= static_cast<int32_t>(configData.size())) {
-                            std::memcpy(cfgData, configData.data(), configData.size());
-                            videoDecoder_->SubmitInputBuffer(cfgIndex, cfgHandle, 0,
-                                                             static_cast<int32_t>(configData.size()), configFlags);
-                            appliedConfigSerial = nextConfigSerial;
-                        } else {
-                            videoDecoder_->SubmitInputBuffer(cfgIndex, cfgHandle, 0, 0, 0);
-                        }
-                        break;
-                    }
-                    if (ret != -2) {
-                        OH_LOG_ERROR(LOG_APP, "[VideoDecode] GetInputBuffer for config failed: %{public}d", ret);
-                        break;
-                    }
-                }
+            if (videoPackets_.copyPendingConfig(configData, configFlags, nextConfigSerial, appliedConfigSerial) &&
+                submitVideoBytes(configData.data(), configData.size(), 0, configFlags)) {
+                appliedConfigSerial = nextConfigSerial;
             }
 
             uint32_t bufIndex = 0;
@@ -243,30 +311,37 @@ void ScrcpyStreamManager::videoDecodeThreadFunc() {
                 break;
             }
 
-            if (bufCapacity < static_cast<int32_t>(packet->data.size())) {
+            if (bufCapacity < static_cast<int32_t>(packet->data->size())) {
                 OH_LOG_ERROR(LOG_APP, "[VideoDecode] Buffer too small: %{public}d < %{public}zu",
-                             bufCapacity, packet->data.size());
+                             bufCapacity, packet->data->size());
                 videoDecoder_->SubmitInputBuffer(bufIndex, bufHandle, 0, 0, 0);
                 videoPackets_.recycle(packet);
                 continue;
             }
 
-            std::memcpy(bufData, packet->data.data(), packet->data.size());
+            std::memcpy(bufData, packet->data->data(), packet->data->size());
             int32_t submitRet = videoDecoder_->SubmitInputBuffer(
                 bufIndex,
                 bufHandle,
                 packet->pts,
-                static_cast<int32_t>(packet->data.size()),
+                static_cast<int32_t>(packet->data->size()),
                 packet->submitFlags);
+            const int64_t submittedPts = packet->pts;
             videoPackets_.recycle(packet);
 
             if (submitRet == 0) {
+                lastSubmittedPts = submittedPts;
+                AllocTracker::noteFrame();
                 if (!firstFrameNotified) {
                     firstFrameNotified = true;
                     emitEvent("first_frame", "");
+                    completeStartupTimeline();
                 }
             } else {
                 OH_LOG_ERROR(LOG_APP, "[VideoDecode] Submit failed: %{public}d", submitRet);
+                FlightRecorder::instance().record(FlightEvent::DecoderError,
+                                                  static_cast<uint32_t>(FlightStreamKind::Video),
+                                                  static_cast<uint32_t>(submitRet));
             }
         }
     } catch (const std::exception& e) {
@@ -276,3 +351,97 @@ void ScrcpyStreamManager::videoDecodeThreadFunc() {
         }
     }
 }
+
+bool ScrcpyStreamManager::requestVideoResync() {
+    if (!running_.load() || !videoDecoder_) {
+        return false;
+    }
+    videoResyncRequested_.store(true);
+    videoPackets_.notifyAll();
+    return true;
+}
+
+bool ScrcpyStreamManager::submitVideoBytes(const uint8_t* data, size_t size, int64_t pts, uint32_t flags) {
+    uint32_t bufIndex = 0;
+    uint8_t* bufData = nullptr;
+    int32_t bufCapacity = 0;
+    void* bufHandle = nullptr;
+    while (running_.load()) {
+        int32_t ret = videoDecoder_->GetInputBuffer(&bufIndex, &bufData, &bufCapacity, &bufHandle, 10);
+        if (ret == 0) {
+            if (bufCapacity < static_cast<int32_t>(size)) {
+                videoDecoder_->SubmitInputBuffer(bufIndex, bufHandle, 0, 0, 0);
+                return false;
+            }
+            std::memcpy(bufData, data, size);
+            return videoDecoder_->SubmitInputBuffer(bufIndex, bufHandle, pts, static_cast<int32_t>(size), flags) == 0;
+        }
+        if (ret != -2) {
+            OH_LOG_ERROR(LOG_APP, "[VideoDecode] GetInputBuffer for sync submit failed: %{public}d", ret);
+            return false;
+        }
+    }
+    return false;
+}
+
+size_t ScrcpyStreamManager::primeVideoDecoder(int64_t replayUpToPts, uint64_t& appliedConfigSerial, bool flush) {
+    if (flush && videoDecoder_->Flush() != 0) {
+        return 0;
+    }
+
+    std::vector<uint8_t> configData;
+    uint32_t configFlags = 0;
+    uint64_t configSerial = 0;
+    if (videoPackets_.copyPendingConfig(configData, configFlags, configSerial, 0) &&
+        submitVideoBytes(configData.data(), configData.size(), 0, configFlags)) {
+        appliedConfigSerial = configSerial;
+    }
+
+    // 只回放解码器已经消费过的部分；pts 更新的包仍在队列里，按正常路径送入。
+    std::vector<RetainedPacket> retained;
+    size_t primed = 0;
+    if (replayUpToPts < 0 || !videoPackets_.copyRetainedPackets(retained, appliedConfigSerial)) {
+        return primed;
+    }
+    size_t replayCount = 0;
+    while (replayCount < retained.size() && retained[replayCount].pts <= replayUpToPts) {
+        ++replayCount;
+    }
+    if (replayCount == 0) {
+        return primed;
+    }
+    // 整段 GOP 只送显最后一帧，前面的帧解码后直接丢弃
+    videoDecoder_->SkipOutputUntil(retained[replayCount - 1].pts, static_cast<uint32_t>(replayCount - 1));
+    for (size_t i = 0; i < replayCount && running_.load(); ++i) {
+        const auto& cached = retained[i];
+        if (!submitVideoBytes(cached.data->data(), cached.data->size(), cached.pts, cached.submitFlags)) {
+            break;
+        }
+        ++primed;
+    }
+    if (primed < replayCount) {
+        // 回放中断，最后一帧不会出来，恢复正常送显
+        videoDecoder_->SkipOutputUntil(-1, 0);
+    }
+    OH_LOG_INFO(LOG_APP, "[VideoDecode] Decoder resynced with %{public}zu cached packets", primed);
+    return primed;
+}
+
+void ScrcpyStreamManager::recordStartupSpan(const std::string& phase, std::chrono::steady_clock::time_point start) {
+    if (Adb* adb = connections().primary) {
+        adb->startupTimeline().addSpan(phase, start);
+    }
+}
+
+void ScrcpyStreamManager::completeStartupTimeline() {
+    Adb* adb = connections().primary;
+    if (!adb) {
+        return;
+    }
+    std::string session = adb->startupTimeline().complete();
+    if (session.empty()) {
+        return;
+    }
+    emitEvent("startup_timeline",
+              "{\"session\":" + session + ",\"aggregate\":" + StartupStats::instance().toJson() + "}");
+}
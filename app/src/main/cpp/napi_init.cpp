@@ -4,6 +4,14 @@
 #include "adb/core/Adb.h"
 #include "adb/pairing/AdbPair.h"
 #include "concurrentqueue/concurrentqueue.h"
+#include "util/MemoryBudget.h"
+#include "util/ProfiledMutex.h"
+#include "diag/FlightRecorder.h"
+#include "diag/StallWatchdog.h"
+#include "diag/ThreadCpuMonitor.h"
+#include "util/AllocTracker.h"
+#include "util/SocketTuning.h"
+#include "diag/StartupTimeline.h"
 
 
 #include <hilog/log.h>
@@ -392,10 +400,23 @@ static napi_value ReleaseAudioDecoder(napi_env env, napi_callback_info info) {
 // ============== ADB Module ==============
 
 #include "adb/crypto/AdbKeyPair.h"
+#include "adb/pairing/TlsSessionCache.h"
+#include "adb/channel/TlsAdbChannel.h"
+#include "adb/channel/UringChannel.h"
+#include "adb/core/AdbConnectionPool.h"
+#include "adb/core/AdbReactor.h"
+#include "adb/core/ReverseBridgeLoop.h"
 
 static std::unordered_map<int64_t, std::shared_ptr<Adb>> g_adbInstances;
 static int64_t g_nextAdbId = 1;
 
+// 连接池：key 为主连接 adbId，额外连接同样注册到 g_adbInstances，便于复用现有的按 adbId 操作流的接口
+struct AdbPoolEntry {
+    std::shared_ptr<AdbConnectionPool> pool;
+    std::vector<int64_t> extraAdbIds;
+};
+static std::unordered_map<int64_t, AdbPoolEntry> g_adbPools;
+
 // 创建ADB实例 - adbCreate(ip, port) => adbId
 // 异步任务上下文
 struct AdbCreateContext {
@@ -449,6 +470,7 @@ struct AdbCreateContextFull {
     
     std::string ip;
     int32_t port;
+    int32_t connectTimeoutMs = TcpChannel::DEFAULT_CONNECT_TIMEOUT_MS;
     
     std::shared_ptr<Adb> adbInstance; // Created in BG
     int64_t resultAdbId = -1;
@@ -459,7 +481,8 @@ struct AdbCreateContextFull {
 static void ExecuteAdbCreateFull(napi_env env, void* data) {
     AdbCreateContextFull* context = static_cast<AdbCreateContextFull*>(data);
     try {
-        context->adbInstance = std::shared_ptr<Adb>(Adb::create(context->ip, context->port));
+        context->adbInstance = std::shared_ptr<Adb>(
+            Adb::create(context->ip, context->port, context->connectTimeoutMs));
         if (context->adbInstance) {
             context->success = true;
         } else {
@@ -494,10 +517,10 @@ static void CompleteAdbCreateFull(napi_env env, napi_status status, void* data)
     delete context;
 }
 
-// 创建ADB实例 - adbCreate(ip, port) => Promise<number>
+// 创建ADB实例 - adbCreate(ip, port, connectTimeoutMs?) => Promise<number>
 static napi_value AdbCreate(napi_env env, napi_callback_info info) {
-    size_t argc = 2;
-    napi_value args[2];
+    size_t argc = 3;
+    napi_value args[3];
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
     char ip[256];
@@ -513,6 +536,15 @@ static napi_value AdbCreate(napi_env env, napi_callback_info info) {
     AdbCreateContextFull* context = new AdbCreateContextFull();
     context->ip = ip;
     context->port = port;
+    if (argc > 2) {
+        napi_valuetype timeoutType = napi_undefined;
+        napi_typeof(env, args[2], &timeoutType);
+        int32_t connectTimeoutMs = 0;
+        if (timeoutType == napi_number && napi_get_value_int32(env, args[2], &connectTimeoutMs) == napi_ok &&
+            connectTimeoutMs > 0) {
+            context->connectTimeoutMs = connectTimeoutMs;
+        }
+    }
 
     napi_value promise;
     napi_create_promise(env, &context->deferred, &promise);
@@ -1490,6 +1522,62 @@ static napi_value AdbTcpForward(napi_env env, napi_callback_info info) {
     return result;
 }
 
+// 本地端口转发监听 - adbForwardListen(adbId, localPort, remote) => 实际监听端口，失败返回 -1
+// localPort 为 0 时随机分配；remote 为设备端目标，如 "tcp:8700"、"localabstract:foo"
+static napi_value AdbForwardListen(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int64_t adbId;
+    int32_t localPort;
+    char remote[256];
+    size_t remoteLen;
+
+    napi_get_value_int64(env, args[0], &adbId);
+    napi_get_value_int32(env, args[1], &localPort);
+    napi_get_value_string_utf8(env, args[2], remote, sizeof(remote), &remoteLen);
+
+    napi_value result;
+    auto it = g_adbInstances.find(adbId);
+    if (it == g_adbInstances.end() || localPort < 0 || localPort > 65535) {
+        napi_create_int32(env, -1, &result);
+        return result;
+    }
+
+    try {
+        uint16_t port = it->second->forwardListen(static_cast<uint16_t>(localPort), std::string(remote, remoteLen));
+        napi_create_int32(env, port, &result);
+    } catch (const std::exception& e) {
+        OH_LOG_ERROR(LOG_APP, "[NAPI] AdbForwardListen failed: %{public}s", e.what());
+        napi_create_int32(env, -1, &result);
+    }
+    return result;
+}
+
+// 停止本地端口转发监听 - adbForwardRemove(adbId, localPort) => boolean，已建立的连接不受影响
+static napi_value AdbForwardRemove(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int64_t adbId;
+    int32_t localPort;
+
+    napi_get_value_int64(env, args[0], &adbId);
+    napi_get_value_int32(env, args[1], &localPort);
+
+    bool removed = false;
+    auto it = g_adbInstances.find(adbId);
+    if (it != g_adbInstances.end() && localPort > 0 && localPort <= 65535) {
+        removed = it->second->forwardRemove(static_cast<uint16_t>(localPort));
+    }
+
+    napi_value result;
+    napi_get_boolean(env, removed, &result);
+    return result;
+}
+
 // 本地Socket转发 - adbLocalSocketForward(adbId, socketName, streamKind?) => streamId
 static napi_value AdbLocalSocketForward(napi_env env, napi_callback_info info) {
     size_t argc = 3;
@@ -1870,6 +1958,15 @@ static napi_value AdbClose(napi_env env, napi_callback_info info) {
     int64_t adbId;
     napi_get_value_int64(env, args[0], &adbId);
 
+    auto poolIt = g_adbPools.find(adbId);
+    if (poolIt != g_adbPools.end()) {
+        for (int64_t extraId : poolIt->second.extraAdbIds) {
+            g_adbInstances.erase(extraId);
+        }
+        poolIt->second.pool->close();
+        g_adbPools.erase(poolIt);
+    }
+
     auto it = g_adbInstances.find(adbId);
     if (it != g_adbInstances.end()) {
         it->second->close();
@@ -1924,6 +2021,227 @@ static napi_value AdbIsConnected(napi_env env, napi_callback_info info) {
     return result;
 }
 
+// 设置 TLS 会话缓存的持久化目录 - adbSetTlsSessionDir(dir) => void，空串表示只缓存在内存
+static napi_value AdbSetTlsSessionDir(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    char dir[1024] = {0};
+    size_t dirLen = 0;
+    if (argc > 0) {
+        napi_get_value_string_utf8(env, args[0], dir, sizeof(dir), &dirLen);
+    }
+    scrcpy::pairing::TlsSessionCache::Instance().SetPersistDirectory(std::string(dir, dirLen));
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// 开关 TLS 解密流水线 - adbSetTlsDecryptPipeline(enabled) => void，只影响之后建立的 TLS 连接
+static napi_value AdbSetTlsDecryptPipeline(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool enabled = false;
+    if (argc > 0) {
+        napi_get_value_bool(env, args[0], &enabled);
+    }
+    TlsAdbChannel::setDecryptPipelineEnabled(enabled);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// 开关 io_uring 通道 - adbSetIoUring(enabled) => boolean，返回内核是否支持；只影响之后建立的明文 TCP 连接
+static napi_value AdbSetIoUring(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool enabled = false;
+    if (argc > 0) {
+        napi_get_value_bool(env, args[0], &enabled);
+    }
+    UringChannel::setEnabled(enabled);
+
+    napi_value result;
+    napi_get_boolean(env, enabled && UringChannel::supported(), &result);
+    return result;
+}
+
+// 开关 reverse 桥接零拷贝发送 - adbSetReverseBridgeZeroCopy(enabled) => void，只影响之后建立的连接
+static napi_value AdbSetReverseBridgeZeroCopy(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool enabled = false;
+    if (argc > 0) {
+        napi_get_value_bool(env, args[0], &enabled);
+    }
+    ReverseBridgeLoop::setMode(enabled ? ReverseBridgeMode::ZeroCopy : ReverseBridgeMode::Copy);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// 开关 ADB 反应器模式 - adbSetReactorMode(enabled, threads?) => void，只影响之后建立的连接
+static napi_value AdbSetReactorMode(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool enabled = false;
+    int32_t threads = 1;
+    if (argc > 0) {
+        napi_get_value_bool(env, args[0], &enabled);
+    }
+    if (argc > 1) {
+        napi_get_value_int32(env, args[1], &threads);
+    }
+    AdbReactor::setEnabled(enabled, threads);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// 为已连接的 adbId 打开连接池 - adbPoolOpen(adbId, connections, pubKeyPath, priKeyPath) => Promise<number>
+// 返回实际连接数（含主连接），设备不接受更多连接时回退，失败返回 -1
+struct AdbPoolOpenContext {
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+    int64_t adbId = -1;
+    int32_t connections = 1;
+    std::string pubKeyPath;
+    std::string priKeyPath;
+    std::shared_ptr<AdbConnectionPool> pool;
+    int32_t result = -1;
+    std::string errorMsg;
+};
+
+static napi_value AdbPoolOpen(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value args[4];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int64_t adbId = -1;
+    int32_t connections = 1;
+    char pubKeyPath[512] = {0};
+    char priKeyPath[512] = {0};
+    napi_get_value_int64(env, args[0], &adbId);
+    napi_get_value_int32(env, args[1], &connections);
+    napi_get_value_string_utf8(env, args[2], pubKeyPath, sizeof(pubKeyPath), nullptr);
+    napi_get_value_string_utf8(env, args[3], priKeyPath, sizeof(priKeyPath), nullptr);
+
+    auto it = g_adbInstances.find(adbId);
+    if (it == g_adbInstances.end()) {
+        napi_throw_error(env, nullptr, "Adb instance not found");
+        return nullptr;
+    }
+
+    auto* context = new AdbPoolOpenContext();
+    context->adbId = adbId;
+    context->connections = connections;
+    context->pubKeyPath = pubKeyPath;
+    context->priKeyPath = priKeyPath;
+    auto poolIt = g_adbPools.find(adbId);
+    context->pool = poolIt != g_adbPools.end() ? poolIt->second.pool
+                                               : std::make_shared<AdbConnectionPool>(it->second);
+
+    napi_value resourceName;
+    napi_create_string_utf8(env, "AdbPoolOpen", NAPI_AUTO_LENGTH, &resourceName);
+    napi_value promise;
+    napi_create_promise(env, &context->deferred, &promise);
+
+    napi_create_async_work(
+        env, nullptr, resourceName,
+        [](napi_env, void* rawData) {
+            auto* context = static_cast<AdbPoolOpenContext*>(rawData);
+            try {
+                AdbKeyPair keyPair = AdbKeyPair::read(context->pubKeyPath, context->priKeyPath);
+                context->result = context->pool->open(context->connections, keyPair);
+            } catch (const std::exception& e) {
+                context->errorMsg = e.what();
+            }
+        },
+        [](napi_env env, napi_status, void* rawData) {
+            auto* context = static_cast<AdbPoolOpenContext*>(rawData);
+            napi_value result;
+            if (context->errorMsg.empty() && g_adbInstances.count(context->adbId) > 0) {
+                AdbPoolEntry& entry = g_adbPools[context->adbId];
+                entry.pool = context->pool;
+                for (const auto& extra : context->pool->extraConnections()) {
+                    bool registered = false;
+                    for (int64_t extraId : entry.extraAdbIds) {
+                        auto found = g_adbInstances.find(extraId);
+                        if (found != g_adbInstances.end() && found->second == extra) {
+                            registered = true;
+                            break;
+                        }
+                    }
+                    if (!registered) {
+                        int64_t extraId = g_nextAdbId++;
+                        g_adbInstances[extraId] = extra;
+                        entry.extraAdbIds.push_back(extraId);
+                    }
+                }
+                OH_LOG_INFO(LOG_APP, "[NAPI] AdbPoolOpen adbId=%{public}lld connections=%{public}d",
+                            static_cast<long long>(context->adbId), context->result);
+                napi_create_int32(env, context->result, &result);
+            } else {
+                OH_LOG_ERROR(LOG_APP, "[NAPI] AdbPoolOpen failed: %{public}s",
+                             context->errorMsg.empty() ? "adb closed" : context->errorMsg.c_str());
+                context->pool->close();
+                napi_create_int32(env, -1, &result);
+            }
+            napi_resolve_deferred(env, context->deferred, result);
+            napi_delete_async_work(env, context->work);
+            delete context;
+        },
+        context,
+        &context->work);
+    napi_queue_async_work(env, context->work);
+    return promise;
+}
+
+// 按流量类型选连接 - adbPoolConnectionFor(adbId, trafficClass) => adbId
+// trafficClass 为 "video" / "audio" / "control" / "bulk"；没有连接池时返回传入的 adbId
+static napi_value AdbPoolConnectionFor(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int64_t adbId = -1;
+    char kind[32] = {0};
+    napi_get_value_int64(env, args[0], &adbId);
+    if (argc > 1) {
+        napi_get_value_string_utf8(env, args[1], kind, sizeof(kind), nullptr);
+    }
+
+    int64_t selected = adbId;
+    auto poolIt = g_adbPools.find(adbId);
+    if (poolIt != g_adbPools.end()) {
+        auto adb = poolIt->second.pool->connectionFor(AdbConnectionPool::trafficClassForKind(kind));
+        for (int64_t extraId : poolIt->second.extraAdbIds) {
+            auto found = g_adbInstances.find(extraId);
+            if (found != g_adbInstances.end() && found->second == adb) {
+                selected = extraId;
+                break;
+            }
+        }
+    }
+
+    napi_value result;
+    napi_create_int64(env, selected, &result);
+    return result;
+}
+
 // 获取Shell - adbGetShell(adbId) => streamId
 static napi_value AdbGetShell(napi_env env, napi_callback_info info) {
     size_t argc = 1;
@@ -2052,6 +2370,8 @@ static napi_value AdbIsStreamClosed(napi_env env, napi_callback_info info) {
 #include <cstring>
 
 static ScrcpyStreamManager* g_streamManager = nullptr;
+// 当前拉流使用的主连接 adbId，断线恢复后用新连接替换该 id 对应的实例
+static int64_t g_streamAdbId = -1;
 static OH_NativeXComponent_Callback g_xComponentCallback;
 static std::atomic<bool> g_nativeXComponentCallbacksRegistered{false};
 
@@ -2148,9 +2468,18 @@ void SendNativeTouchEvent(const OH_NativeXComponent_TouchEvent& event, uint64_t
     SendNativeTouchSample(event.id, event.x, event.y, event.type, event.force, componentWidthVp, componentHeightVp);
 }
 
-void OnSurfaceCreated(OH_NativeXComponent*, void*) {}
+// surface 重建或尺寸变化后旧画面已失效，用缓存的关键帧/GOP 立即补一帧，而不是等设备的下一个周期关键帧
+void OnSurfaceCreated(OH_NativeXComponent*, void*) {
+    if (g_streamManager) {
+        g_streamManager->requestVideoResync();
+    }
+}
 
-void OnSurfaceChanged(OH_NativeXComponent*, void*) {}
+void OnSurfaceChanged(OH_NativeXComponent*, void*) {
+    if (g_streamManager) {
+        g_streamManager->requestVideoResync();
+    }
+}
 
 void OnSurfaceDestroyed(OH_NativeXComponent*, void*) {}
 
@@ -2267,6 +2596,23 @@ static void StreamEventCallToJS(napi_env env, napi_value jsCb, void* context, vo
         return;
     }
 
+    if (eventData->type == "reconnected" && g_streamManager && g_streamAdbId >= 0) {
+        // 断线恢复建立了新连接：原 adbId 改指向它，ArkTS 侧沿用同一个 id；连接池的额外连接已失效
+        std::shared_ptr<Adb> resumed = g_streamManager->resumedAdb();
+        auto it = g_adbInstances.find(g_streamAdbId);
+        if (resumed && it != g_adbInstances.end() && it->second != resumed) {
+            auto poolIt = g_adbPools.find(g_streamAdbId);
+            if (poolIt != g_adbPools.end()) {
+                for (int64_t extraId : poolIt->second.extraAdbIds) {
+                    g_adbInstances.erase(extraId);
+                }
+                poolIt->second.pool->close();
+                g_adbPools.erase(poolIt);
+            }
+            it->second = resumed;
+        }
+    }
+
     napi_value argv[2];
     napi_create_string_utf8(env, eventData->type.c_str(), eventData->type.size(), &argv[0]);
     napi_create_string_utf8(env, eventData->data.c_str(), eventData->data.size(), &argv[1]);
@@ -2312,8 +2658,8 @@ static StreamEventCallback CreateNativeStreamEventCallback() {
 }
 
 static napi_value NativeStartStreams(napi_env env, napi_callback_info info) {
-    size_t argc = 8;
-    napi_value args[8];
+    size_t argc = 9;
+    napi_value args[9];
     napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
 
     int64_t adbId;
@@ -2347,6 +2693,7 @@ static napi_value NativeStartStreams(napi_env env, napi_callback_info info) {
         napi_async_work work = nullptr;
         napi_deferred deferred = nullptr;
         std::shared_ptr<Adb> adbInstance;
+        std::vector<std::shared_ptr<Adb>> streamAdbInstances;
         ScrcpyStreamManager::Config config;
         bool reverse = false;
         int32_t result = -1;
@@ -2365,6 +2712,7 @@ static napi_value NativeStartStreams(napi_env env, napi_callback_info info) {
 
     auto* context = new NativeStartStreamsContext();
     context->adbInstance = it->second;
+    g_streamAdbId = adbId;
     context->config.videoStreamId = videoStreamId;
     context->config.audioStreamId = audioStreamId;
     context->config.controlStreamId = controlStreamId;
@@ -2374,6 +2722,25 @@ static napi_value NativeStartStreams(napi_env env, napi_callback_info info) {
     context->config.reverse = false;
     context->config.sendDummyByte = true;
 
+    // 可选第 9 个参数：[videoAdbId, audioAdbId, controlAdbId]，流分布在连接池的不同连接上
+    bool isArray = false;
+    if (argc > 8 && napi_is_array(env, args[8], &isArray) == napi_ok && isArray) {
+        Adb** streamAdbs[3] = {&context->config.videoAdb, &context->config.audioAdb, &context->config.controlAdb};
+        uint32_t length = 0;
+        napi_get_array_length(env, args[8], &length);
+        for (uint32_t i = 0; i < length && i < 3; ++i) {
+            napi_value element;
+            int64_t streamAdbId = -1;
+            napi_get_element(env, args[8], i, &element);
+            napi_get_value_int64(env, element, &streamAdbId);
+            auto streamAdbIt = g_adbInstances.find(streamAdbId);
+            if (streamAdbIt != g_adbInstances.end()) {
+                *streamAdbs[i] = streamAdbIt->second.get();
+                context->streamAdbInstances.push_back(streamAdbIt->second);
+            }
+        }
+    }
+
     napi_value promise;
     napi_create_promise(env, &context->deferred, &promise);
 
@@ -2473,6 +2840,7 @@ static napi_value NativeStartReverseStreams(napi_env env, napi_callback_info inf
 
     auto* context = new NativeStartReverseStreamsContext();
     context->adbInstance = it->second;
+    g_streamAdbId = adbId;
     context->config.videoStreamId = -1;
     context->config.audioStreamId = -1;
     context->config.controlStreamId = -1;
@@ -2547,6 +2915,7 @@ static napi_value NativeStopStreams(napi_env env, napi_callback_info info) {
         delete g_streamManager;
         g_streamManager = nullptr;
     }
+    g_streamAdbId = -1;
 
     if (g_streamCallback) {
         napi_release_threadsafe_function(g_streamCallback, napi_tsfn_release);
@@ -2579,6 +2948,205 @@ static napi_value NativeSendControl(napi_env env, napi_callback_info info) {
     return result;
 }
 
+// nativeEnableAutoReconnect(serverCommand, socketName, pubKeyPath, priKeyPath, deadPeerMs?, targetMs?) => boolean
+// 拉流启动成功后调用；连接不是按地址建立时返回 false
+static napi_value NativeEnableAutoReconnect(napi_env env, napi_callback_info info) {
+    size_t argc = 6;
+    napi_value args[6];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    auto readString = [env](napi_value value) {
+        size_t length = 0;
+        napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+        std::string text(length, '\0');
+        napi_get_value_string_utf8(env, value, &text[0], length + 1, &length);
+        return text;
+    };
+
+    bool enabled = false;
+    if (argc >= 4 && g_streamManager) {
+        ScrcpyStreamManager::ResumeOptions options;
+        options.serverCommand = readString(args[0]);
+        options.socketName = readString(args[1]);
+        options.pubKeyPath = readString(args[2]);
+        options.priKeyPath = readString(args[3]);
+        if (argc > 4) {
+            napi_get_value_int32(env, args[4], &options.deadPeerMs);
+        }
+        if (argc > 5) {
+            napi_get_value_int32(env, args[5], &options.targetMs);
+        }
+        enabled = g_streamManager->enableAutoResume(options);
+    }
+
+    napi_value result;
+    napi_get_boolean(env, enabled, &result);
+    return result;
+}
+
+// nativeResyncVideo() => boolean
+static napi_value NativeResyncVideo(napi_env env, napi_callback_info info) {
+    bool accepted = g_streamManager && g_streamManager->requestVideoResync();
+
+    napi_value result;
+    napi_get_boolean(env, accepted, &result);
+    return result;
+}
+
+// nativeStartPacketServer(kind: 'video' | 'audio', port: number) => number
+static napi_value NativeStartPacketServer(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    char kindBuf[16] = {0};
+    size_t kindLen = 0;
+    napi_get_value_string_utf8(env, args[0], kindBuf, sizeof(kindBuf), &kindLen);
+    int32_t port = 0;
+    if (argc > 1) {
+        napi_get_value_int32(env, args[1], &port);
+    }
+
+    int32_t boundPort = -1;
+    if (g_streamManager && port >= 0 && port <= 65535) {
+        FanoutMediaKind kind = std::string(kindBuf) == "audio" ? FanoutMediaKind::Audio : FanoutMediaKind::Video;
+        boundPort = g_streamManager->startPacketServer(kind, static_cast<uint16_t>(port));
+    }
+
+    napi_value result;
+    napi_create_int32(env, boundPort, &result);
+    return result;
+}
+
+// nativeOnMemoryLevel(level: number) => void，level 对应 AbilityConstant.MemoryLevel
+static napi_value NativeOnMemoryLevel(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int32_t level = -1;
+    if (argc > 0) {
+        napi_get_value_int32(env, args[0], &level);
+    }
+    level = std::max(-1, std::min(level, 2));
+    MemoryPressure pressure = static_cast<MemoryPressure>(level);
+    MemoryBudget::instance().onMemoryPressure(pressure);
+    if (g_streamManager) {
+        g_streamManager->trimMemory(pressure);
+    }
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// nativeGetStats() => string (JSON)
+static napi_value NativeGetStats(napi_env env, napi_callback_info info) {
+    ScrcpyStreamManager* streamManager = g_streamManager;
+    std::string poolsJson = "{";
+    for (const auto& entry : g_adbPools) {
+        if (poolsJson.size() > 1) {
+            poolsJson += ",";
+        }
+        poolsJson += "\"" + std::to_string(entry.first) + "\":" + entry.second.pool->toJson();
+    }
+    poolsJson += "}";
+    std::string json = "{\"memory\":" + MemoryBudget::instance().toJson() +
+                       ",\"startup\":" + StartupStats::instance().toJson() +
+                       ",\"watchdog\":" + StallWatchdog::instance().toJson() +
+                       ",\"locks\":" + LockProfiler::toJson() +
+                       ",\"cpu\":" + ThreadCpuMonitor::instance().toJson() +
+                       ",\"alloc\":" + AllocTracker::toJson() +
+                       ",\"videoLatency\":" + (streamManager ? streamManager->videoLatencyJson() : "null") +
+                       ",\"resume\":" + (streamManager ? streamManager->resumeJson() : "null") +
+                       ",\"tls\":" + scrcpy::pairing::TlsSessionCache::Instance().ToJson() +
+                       ",\"tlsChannel\":" + TlsAdbChannel::statsJson() +
+                       ",\"sockets\":" + SocketTuning::toJson() +
+                       ",\"adbPools\":" + poolsJson +
+                       ",\"adbReactor\":" + AdbReactor::instance().toJson() +
+                       ",\"uring\":" + UringChannel::statsJson() +
+                       ",\"reverseBridges\":" + ReverseBridgeLoop::instance().toJson() + "}";
+
+    napi_value result;
+    napi_create_string_utf8(env, json.c_str(), json.size(), &result);
+    return result;
+}
+
+// nativeSetDiagnosticsDir(dir: string) => void，诊断文件（飞行记录等）的输出目录
+static napi_value NativeSetDiagnosticsDir(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    char dir[1024] = {0};
+    size_t dirLen = 0;
+    if (argc > 0) {
+        napi_get_value_string_utf8(env, args[0], dir, sizeof(dir), &dirLen);
+    }
+    FlightRecorder::instance().setDumpDirectory(std::string(dir, dirLen));
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// nativeDumpFlightRecorder(reason?: string) => string，返回落盘文件路径，失败为空串
+static napi_value NativeDumpFlightRecorder(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    char reason[256] = {0};
+    size_t reasonLen = 0;
+    if (argc > 0) {
+        napi_get_value_string_utf8(env, args[0], reason, sizeof(reason), &reasonLen);
+    }
+    std::string path = FlightRecorder::instance().dump(reasonLen > 0 ? std::string(reason, reasonLen) : "manual");
+
+    napi_value result;
+    napi_create_string_utf8(env, path.c_str(), path.size(), &result);
+    return result;
+}
+
+// nativeSetLockProfiling(enabled: boolean) => void，开启时清零已有锁统计
+static napi_value NativeSetLockProfiling(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool enabled = false;
+    if (argc > 0) {
+        napi_get_value_bool(env, args[0], &enabled);
+    }
+    LockProfiler::setEnabled(enabled);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// nativeSetAllocTracking(enabled: boolean, budgetPerFrame?: number) => boolean
+// 返回分配统计是否已编译进来（SCRCPY_ALLOC_TRACKING）；开启时清零计数
+static napi_value NativeSetAllocTracking(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2];
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    bool enabled = false;
+    uint32_t budgetPerFrame = 0;
+    if (argc > 0) {
+        napi_get_value_bool(env, args[0], &enabled);
+    }
+    if (argc > 1) {
+        napi_get_value_uint32(env, args[1], &budgetPerFrame);
+    }
+    AllocTracker::setEnabled(enabled, budgetPerFrame);
+
+    napi_value result;
+    napi_get_boolean(env, AllocTracker::compiledIn(), &result);
+    return result;
+}
+
 // ============== Module Registration ==============
 
 EXTERN_C_START
@@ -2611,6 +3179,8 @@ static napi_value Init(napi_env env, napi_value exports) {
         {"adbPushFile", nullptr, AdbPushFile, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"adbPushFileFromFd", nullptr, AdbPushFileFromFd, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"adbTcpForward", nullptr, AdbTcpForward, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbForwardListen", nullptr, AdbForwardListen, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbForwardRemove", nullptr, AdbForwardRemove, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"adbLocalSocketForward", nullptr, AdbLocalSocketForward, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"adbReverse", nullptr, AdbReverse, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"adbReverseRemove", nullptr, AdbReverseRemove, nullptr, nullptr, nullptr, napi_default, nullptr},
@@ -2623,12 +3193,28 @@ static napi_value Init(napi_env env, napi_value exports) {
         {"adbClose", nullptr, AdbClose, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"adbGenerateKeyPair", nullptr, AdbGenerateKeyPair, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"adbIsConnected", nullptr, AdbIsConnected, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbSetTlsSessionDir", nullptr, AdbSetTlsSessionDir, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbSetTlsDecryptPipeline", nullptr, AdbSetTlsDecryptPipeline, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbSetReactorMode", nullptr, AdbSetReactorMode, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbSetIoUring", nullptr, AdbSetIoUring, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbSetReverseBridgeZeroCopy", nullptr, AdbSetReverseBridgeZeroCopy, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbPoolOpen", nullptr, AdbPoolOpen, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"adbPoolConnectionFor", nullptr, AdbPoolConnectionFor, nullptr, nullptr, nullptr, napi_default, nullptr},
 
         // Stream Manager API
         {"nativeStartStreams", nullptr, NativeStartStreams, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"nativeStartReverseStreams", nullptr, NativeStartReverseStreams, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"nativeStopStreams", nullptr, NativeStopStreams, nullptr, nullptr, nullptr, napi_default, nullptr},
         {"nativeSendControl", nullptr, NativeSendControl, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeResyncVideo", nullptr, NativeResyncVideo, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeEnableAutoReconnect", nullptr, NativeEnableAutoReconnect, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeStartPacketServer", nullptr, NativeStartPacketServer, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeOnMemoryLevel", nullptr, NativeOnMemoryLevel, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeGetStats", nullptr, NativeGetStats, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeSetDiagnosticsDir", nullptr, NativeSetDiagnosticsDir, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeDumpFlightRecorder", nullptr, NativeDumpFlightRecorder, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeSetLockProfiling", nullptr, NativeSetLockProfiling, nullptr, nullptr, nullptr, napi_default, nullptr},
+        {"nativeSetAllocTracking", nullptr, NativeSetAllocTracking, nullptr, nullptr, nullptr, napi_default, nullptr},
     };
 
     napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc);
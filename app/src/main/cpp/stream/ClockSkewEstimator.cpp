@@ -0,0 +1,197 @@
+#include "stream/ClockSkewEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+constexpr double CONGESTION_ENTER_MS = 150.0;
+constexpr double CONGESTION_EXIT_MS = 60.0;
+constexpr double CONGESTION_TREND_MS_PER_SEC = 10.0;
+// 晶振漂移通常在 ±100ppm 内；持续排队会把窗口最小值整体抬高，不能被当成漂移吸收
+constexpr double MAX_SKEW_PPM = 500.0;
+
+int64_t toUs(std::chrono::steady_clock::time_point tp) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp.time_since_epoch()).count();
+}
+}
+
+double ClockSkewEstimator::addSample(int64_t devicePtsUs, std::chrono::steady_clock::time_point arrival) {
+    const int64_t delta = toUs(arrival) - devicePtsUs;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (hasCurrent_ || fitted_) {
+        const double reference = fitted_ ? baselineUsLocked(devicePtsUs) : static_cast<double>(current_.minDeltaUs);
+        if (std::fabs(static_cast<double>(delta) - reference) > DISCONTINUITY_US ||
+            (hasCurrent_ && devicePtsUs + DISCONTINUITY_US < current_.startUs)) {
+            resetLocked();
+            ++resets_;
+        }
+    }
+
+    if (hasCurrent_ && devicePtsUs - current_.startUs >= WINDOW_US && current_.samples > 0) {
+        closeWindowLocked();
+    }
+    if (!hasCurrent_) {
+        current_ = Window();
+        current_.startUs = devicePtsUs;
+        current_.deviceUs = devicePtsUs;
+        current_.minDeltaUs = delta;
+        hasCurrent_ = true;
+    } else if (delta < current_.minDeltaUs) {
+        current_.deviceUs = devicePtsUs;
+        current_.minDeltaUs = delta;
+    }
+    ++current_.samples;
+    ++samples_;
+
+    if (!fitted_) {
+        return -1;
+    }
+    const double baseline = baselineUsLocked(devicePtsUs);
+    const double excessMs = std::max(0.0, (static_cast<double>(delta) - baseline) / 1000.0);
+    current_.excessSumMs += excessMs;
+    lastExcessMs_ = excessMs;
+    const double err = excessMs - meanExcessMs_;
+    meanExcessMs_ += err / 16.0;
+    devExcessMs_ += (std::fabs(err) - devExcessMs_) / 8.0;
+    return excessMs;
+}
+
+void ClockSkewEstimator::closeWindowLocked() {
+    windows_.push_back(current_);
+    while (windows_.size() > MAX_WINDOWS) {
+        windows_.pop_front();
+    }
+    hasCurrent_ = false;
+    fitLocked();
+
+    // 迟滞：额外时延持续偏高且仍在上升时进入拥塞，回落到低位后退出
+    const double trend = queueTrendLocked();
+    if (!congested_ && meanExcessMs_ >= CONGESTION_ENTER_MS && trend >= CONGESTION_TREND_MS_PER_SEC) {
+        congested_ = true;
+    } else if (congested_ && meanExcessMs_ <= CONGESTION_EXIT_MS) {
+        congested_ = false;
+    }
+}
+
+void ClockSkewEstimator::fitLocked() {
+    if (windows_.empty()) {
+        return;
+    }
+    fitOriginUs_ = windows_.front().deviceUs;
+    if (windows_.size() < 3) {
+        int64_t minDelta = windows_.front().minDeltaUs;
+        for (const auto& window : windows_) {
+            minDelta = std::min(minDelta, window.minDeltaUs);
+        }
+        interceptUs_ = static_cast<double>(minDelta);
+        slopePpm_ = 0;
+        fitted_ = true;
+        return;
+    }
+
+    double sumX = 0;
+    double sumY = 0;
+    double sumXX = 0;
+    double sumXY = 0;
+    const double n = static_cast<double>(windows_.size());
+    for (const auto& window : windows_) {
+        const double x = static_cast<double>(window.deviceUs - fitOriginUs_) / 1e6;
+        const double y = static_cast<double>(window.minDeltaUs);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+    }
+    const double denom = n * sumXX - sumX * sumX;
+    double slope = denom > 1e-9 ? (n * sumXY - sumX * sumY) / denom : 0;
+    slope = std::max(-MAX_SKEW_PPM, std::min(slope, MAX_SKEW_PPM));
+    if (congested_) {
+        // 拥塞期间沿用已有漂移，只平移基线
+        slope = slopePpm_;
+    }
+    double intercept = (sumY - slope * sumX) / n;
+    // 基线应是下包络：把拟合线下移到不高于任何窗口最小值
+    for (const auto& window : windows_) {
+        const double x = static_cast<double>(window.deviceUs - fitOriginUs_) / 1e6;
+        intercept = std::min(intercept, static_cast<double>(window.minDeltaUs) - slope * x);
+    }
+    interceptUs_ = intercept;
+    slopePpm_ = slope;  // 每秒偏移的微秒数即 ppm
+    fitted_ = true;
+}
+
+double ClockSkewEstimator::baselineUsLocked(int64_t deviceUs) const {
+    const double x = static_cast<double>(deviceUs - fitOriginUs_) / 1e6;
+    return interceptUs_ + slopePpm_ * x;
+}
+
+void ClockSkewEstimator::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resetLocked();
+    samples_ = 0;
+    resets_ = 0;
+}
+
+void ClockSkewEstimator::resetLocked() {
+    windows_.clear();
+    current_ = Window();
+    hasCurrent_ = false;
+    fitted_ = false;
+    fitOriginUs_ = 0;
+    interceptUs_ = 0;
+    slopePpm_ = 0;
+    lastExcessMs_ = -1;
+    meanExcessMs_ = 0;
+    devExcessMs_ = 0;
+    congested_ = false;
+}
+
+double ClockSkewEstimator::jitterMs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fitted_ ? meanExcessMs_ + 2 * devExcessMs_ : 0;
+}
+
+double ClockSkewEstimator::queueTrendMsPerSec() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queueTrendLocked();
+}
+
+double ClockSkewEstimator::queueTrendLocked() const {
+    size_t count = std::min(windows_.size(), TREND_WINDOWS);
+    if (count < 2) {
+        return 0;
+    }
+    const Window& first = windows_[windows_.size() - count];
+    const Window& last = windows_.back();
+    if (first.samples == 0 || last.samples == 0 || last.startUs <= first.startUs) {
+        return 0;
+    }
+    const double firstAvg = first.excessSumMs / first.samples;
+    const double lastAvg = last.excessSumMs / last.samples;
+    return (lastAvg - firstAvg) / (static_cast<double>(last.startUs - first.startUs) / 1e6);
+}
+
+bool ClockSkewEstimator::congested() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return congested_;
+}
+
+std::string ClockSkewEstimator::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "{\"samples\":" << samples_
+        << ",\"fitted\":" << (fitted_ ? "true" : "false")
+        << ",\"windows\":" << windows_.size()
+        << ",\"skewPpm\":" << slopePpm_
+        << ",\"lastExcessMs\":" << lastExcessMs_
+        << ",\"meanExcessMs\":" << meanExcessMs_
+        << ",\"jitterMs\":" << (fitted_ ? meanExcessMs_ + 2 * devExcessMs_ : 0)
+        << ",\"queueTrendMsPerSec\":" << queueTrendLocked()
+        << ",\"congested\":" << (congested_ ? "true" : "false")
+        << ",\"resets\":" << resets_ << "}";
+    return oss.str();
+}
@@ -0,0 +1,67 @@
+// ClockSkewEstimator - 设备时钟与本地时钟的偏移/漂移估计
+// scrcpy 包的 PTS 是设备侧采集时间（微秒）。d = 本地到达时间 - PTS = 时钟偏移 + 编码与传输时延。
+// 每秒（设备时间）取一次 d 的最小值（最接近"无排队"的那一帧），对最近的窗口最小值做最小二乘拟合，
+// 斜率即时钟漂移，拟合线即基线；每帧 d 高出基线的部分就是编码到到达的额外时延（排队时延）。
+// 绝对单向时延无法在时钟未同步时得到，这里只给出相对最佳路径的额外时延。
+#ifndef SCRCPY_CLOCK_SKEW_ESTIMATOR_H
+#define SCRCPY_CLOCK_SKEW_ESTIMATOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+class ClockSkewEstimator {
+public:
+    // 返回该帧的额外时延（毫秒），基线尚未建立时返回 -1
+    double addSample(int64_t devicePtsUs, std::chrono::steady_clock::time_point arrival);
+    void reset();
+
+    // 额外时延的平滑均值 + 2 倍平均偏差，作为抖动缓冲的参考
+    double jitterMs() const;
+    // 近几个窗口额外时延的变化率（ms/s），持续为正说明链路在排队
+    double queueTrendMsPerSec() const;
+    // 按额外时延和趋势判断是否拥塞（带迟滞）
+    bool congested() const;
+
+    std::string toJson() const;
+
+private:
+    struct Window {
+        int64_t startUs = 0;       // 窗口起点（设备时间）
+        int64_t deviceUs = 0;      // 最小值所在帧的设备时间
+        int64_t minDeltaUs = 0;
+        double excessSumMs = 0;
+        uint32_t samples = 0;
+    };
+
+    double baselineUsLocked(int64_t deviceUs) const;
+    double queueTrendLocked() const;
+    void closeWindowLocked();
+    void fitLocked();
+    void resetLocked();
+
+    static constexpr int64_t WINDOW_US = 1000000;
+    static constexpr size_t MAX_WINDOWS = 30;
+    static constexpr size_t TREND_WINDOWS = 5;
+    // d 相对基线跳变超过该值视为设备 PTS 重置（编码器重启等），重新估计
+    static constexpr int64_t DISCONTINUITY_US = 2000000;
+
+    mutable std::mutex mutex_;
+    std::deque<Window> windows_;
+    Window current_;
+    bool hasCurrent_ = false;
+    bool fitted_ = false;
+    int64_t fitOriginUs_ = 0;
+    double interceptUs_ = 0;
+    double slopePpm_ = 0;
+    uint64_t samples_ = 0;
+    uint32_t resets_ = 0;
+    double lastExcessMs_ = -1;
+    double meanExcessMs_ = 0;
+    double devExcessMs_ = 0;
+    bool congested_ = false;
+};
+
+#endif // SCRCPY_CLOCK_SKEW_ESTIMATOR_H
@@ -1,20 +1,28 @@
 #ifndef SCRCPY_ENCODED_PACKET_H
 #define SCRCPY_ENCODED_PACKET_H
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
+// 编码包负载以引用计数形式持有：解码线程消费完后，若关键帧缓存仍引用该负载，
+// 回收时包对象改用新的负载，缓存中的数据保持不变且无需拷贝。
+using PacketPayload = std::shared_ptr<std::vector<uint8_t>>;
+
 struct EncodedVideoPacket {
-    std::vector<uint8_t> data;
+    PacketPayload data = std::make_shared<std::vector<uint8_t>>();
     int64_t pts = 0;
     uint32_t submitFlags = 0;
     bool isKeyFrame = false;
+    size_t accountedCapacity = 0;  // MediaPacketStore 内存预算记账用
 };
 
 struct EncodedAudioPacket {
-    std::vector<uint8_t> data;
+    PacketPayload data = std::make_shared<std::vector<uint8_t>>();
     int64_t pts = 0;
     uint32_t submitFlags = 0;
+    size_t accountedCapacity = 0;  // MediaPacketStore 内存预算记账用
 };
 
 #endif // SCRCPY_ENCODED_PACKET_H
@@ -1,7 +1,11 @@
 #ifndef SCRCPY_MEDIA_PACKET_STORE_H
 #define SCRCPY_MEDIA_PACKET_STORE_H
 
+#include "diag/FlightRecorder.h"
+#include "diag/StallWatchdog.h"
 #include "stream/EncodedPacket.h"
+#include "util/MemoryBudget.h"
+#include "util/ProfiledMutex.h"
 #include "concurrentqueue/concurrentqueue.h"
 
 #include <algorithm>
@@ -15,15 +19,46 @@
 #include <mutex>
 #include <vector>
 
+// 关键帧保留策略：KeyFrame 只保留最近一个 IDR；Gop 额外保留该 IDR 之后的整个 GOP，
+// 使重新启动/flush 后的解码器可以立即解出当前画面，而不必等设备下一个周期关键帧。
+enum class PacketRetention : uint8_t {
+    None = 0,
+    KeyFrame = 1,
+    Gop = 2,
+};
+
+struct RetainedPacket {
+    PacketPayload data;
+    int64_t pts = 0;
+    uint32_t submitFlags = 0;
+    bool isKeyFrame = false;
+};
+
+// 负载仍被关键帧缓存引用时，给包对象换一份新负载，避免覆盖缓存中的数据。
+template <typename PacketT>
+void detachSharedPayload(PacketT* packet) {
+    if (!packet->data || packet->data.use_count() > 1) {
+        packet->data = std::make_shared<std::vector<uint8_t>>();
+    }
+}
+
 template <typename PacketT>
 struct PacketStoreTraits;
 
 template <>
 struct PacketStoreTraits<EncodedVideoPacket> {
+    static constexpr FlightStreamKind kFlightKind = FlightStreamKind::Video;
+    static constexpr const char* kLockName = "MediaPacketStore<video>::mutex_";
+
     static void reset(EncodedVideoPacket* packet) {
         packet->pts = 0;
         packet->submitFlags = 0;
         packet->isKeyFrame = false;
+        detachSharedPayload(packet);
+    }
+
+    static bool isKeyFrame(const EncodedVideoPacket* packet) {
+        return packet->isKeyFrame;
     }
 
     static EncodedVideoPacket* reclaimQueuedPacket(std::deque<EncodedVideoPacket*>& queue, uint64_t& droppedCount) {
@@ -38,15 +73,24 @@ struct PacketStoreTraits<EncodedVideoPacket> {
         EncodedVideoPacket* packet = *dropIt;
         queue.erase(dropIt);
         ++droppedCount;
+        detachSharedPayload(packet);
         return packet;
     }
 };
 
 template <>
 struct PacketStoreTraits<EncodedAudioPacket> {
+    static constexpr FlightStreamKind kFlightKind = FlightStreamKind::Audio;
+    static constexpr const char* kLockName = "MediaPacketStore<audio>::mutex_";
+
     static void reset(EncodedAudioPacket* packet) {
         packet->pts = 0;
         packet->submitFlags = 0;
+        detachSharedPayload(packet);
+    }
+
+    static bool isKeyFrame(const EncodedAudioPacket*) {
+        return false;
     }
 
     static EncodedAudioPacket* reclaimQueuedPacket(std::deque<EncodedAudioPacket*>& queue, uint64_t& droppedCount) {
@@ -56,6 +100,7 @@ struct PacketStoreTraits<EncodedAudioPacket> {
         EncodedAudioPacket* packet = queue.front();
         queue.pop_front();
         ++droppedCount;
+        detachSharedPayload(packet);
         return packet;
     }
 };
@@ -63,10 +108,10 @@ struct PacketStoreTraits<EncodedAudioPacket> {
 template <typename PacketT>
 class MediaPacketStore {
 public:
-    void initialize(size_t poolSize) {
-        reset();
+    void initialize(size_t poolSize, bool keepRetained = false) {
+        reset(keepRetained);
 
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<ProfiledMutex> lock(mutex_);
         storage_.reserve(poolSize);
         for (size_t i = 0; i < poolSize; ++i) {
             auto packet = std::make_unique<PacketT>();
@@ -75,33 +120,87 @@ public:
         }
     }
 
-    void reset() {
+    // keepRetained 时保留最近的 config 与 GOP：它们只持有负载的引用，不依赖包池，断线恢复后用来回放
+    void reset(bool keepRetained = false) {
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<ProfiledMutex> lock(mutex_);
             queue_.clear();
             storage_.clear();
-            latestConfig_.clear();
-            latestConfigFlags_ = 0;
-            latestConfigSerial_ = 0;
             droppedCount_ = 0;
+            if (!keepRetained) {
+                latestConfig_.clear();
+                latestConfigFlags_ = 0;
+                latestConfigSerial_ = 0;
+                retained_.clear();
+                retainedBytes_ = 0;
+                retainedTruncated_ = false;
+            }
         }
         PacketT* packet = nullptr;
         while (freePackets_.try_dequeue(packet)) {
         }
+        // recycle() 在解码线程上读 budget_，换成原子地读写
+        std::shared_ptr<BudgetLease> budget = std::atomic_exchange(&budget_, std::shared_ptr<BudgetLease>());
+        if (budget) {
+            budget->setAllocated(0);
+        }
         cv_.notify_all();
     }
 
+    // 负载容量计入预算；超出 limit() 时，归还的包会释放自己的负载而不是留在池里复用
+    void attachBudget(std::shared_ptr<BudgetLease> lease) {
+        std::atomic_store(&budget_, std::move(lease));
+    }
+
+    // 内存压力下收缩：空闲包释放负载；dropGop 时只保留关键帧，clearRetained 时全部丢弃
+    void trim(bool dropGop, bool clearRetained) {
+        // 整个过程持锁：空闲包被临时取走期间，acquireForWrite 会在锁上等到它们放回，而不是误判池空去丢包
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        if (clearRetained) {
+            retained_.clear();
+            retainedBytes_ = 0;
+        } else if (dropGop && retained_.size() > 1) {
+            retained_.resize(1);
+            retainedBytes_ = retained_.front().data ? retained_.front().data->size() : 0;
+        }
+        if (dropGop || clearRetained) {
+            retainedTruncated_ = !retained_.empty();
+        }
+
+        std::shared_ptr<BudgetLease> budget = std::atomic_load(&budget_);
+        std::vector<PacketT*> idle;
+        PacketT* packet = nullptr;
+        while (freePackets_.try_dequeue(packet)) {
+            idle.push_back(packet);
+        }
+        for (PacketT* idlePacket : idle) {
+            idlePacket->data = std::make_shared<std::vector<uint8_t>>();
+            accountPayload(budget.get(), idlePacket);
+            freePackets_.enqueue(idlePacket);
+        }
+    }
+
     PacketT* acquireForWrite() {
         PacketT* packet = nullptr;
         if (freePackets_.try_dequeue(packet)) {
             return packet;
         }
 
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        // trim() 持锁期间会暂时取空空闲队列，拿到锁后再取一次
+        if (freePackets_.try_dequeue(packet)) {
+            return packet;
+        }
         // No free packet available: reclaim a fully queued packet instead of
         // blocking the upstream reader. This keeps overload handling at the
         // frame level rather than pushing it back down to the raw ADB byte stream.
-        return PacketStoreTraits<PacketT>::reclaimQueuedPacket(queue_, droppedCount_);
+        PacketT* reclaimed = PacketStoreTraits<PacketT>::reclaimQueuedPacket(queue_, droppedCount_);
+        if (reclaimed) {
+            FlightRecorder::instance().record(FlightEvent::PacketDrop,
+                                              static_cast<uint32_t>(PacketStoreTraits<PacketT>::kFlightKind),
+                                              static_cast<uint32_t>(droppedCount_));
+        }
+        return reclaimed;
     }
 
     void enqueue(PacketT* packet) {
@@ -109,16 +208,46 @@ public:
             return;
         }
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<ProfiledMutex> lock(mutex_);
+            retainLocked(packet);
             queue_.push_back(packet);
         }
         cv_.notify_one();
     }
 
+    void setRetention(PacketRetention retention, size_t maxRetainedBytes) {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        retention_ = retention;
+        maxRetainedBytes_ = maxRetainedBytes;
+        if (retention_ == PacketRetention::None) {
+            retained_.clear();
+            retainedBytes_ = 0;
+            retainedTruncated_ = false;
+        }
+    }
+
+    // 拷出最近关键帧（及其后的 GOP）的引用，只增加引用计数，不复制负载。
+    // 没有可用关键帧，或调用方已送入的配置序号不是当前配置（GOP 属于别的配置）时返回 false。
+    bool copyRetainedPackets(std::vector<RetainedPacket>& out, uint64_t configSerial) const {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        out.clear();
+        if (retained_.empty() || configSerial != latestConfigSerial_) {
+            return false;
+        }
+        out.assign(retained_.begin(), retained_.end());
+        return true;
+    }
+
+    size_t retainedBytes() const {
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        return retainedBytes_;
+    }
+
     bool waitDequeue(PacketT*& packet,
                      const std::atomic<bool>& running,
                      const std::atomic<bool>& readerDone) {
-        std::unique_lock<std::mutex> lock(mutex_);
+        StallWatchdog::WaitScope waitScope("packet_queue", -1, StallWatchdog::WaitKind::Idle);
+        auto lock = mutex_.uniqueLock();
         cv_.wait(lock, [this, &running, &readerDone]() {
             return !queue_.empty() || !running.load() || readerDone.load();
         });
@@ -134,7 +263,7 @@ public:
                           int32_t timeoutMs,
                           const std::atomic<bool>& running,
                           const std::atomic<bool>& readerDone) {
-        std::unique_lock<std::mutex> lock(mutex_);
+        auto lock = mutex_.uniqueLock();
         cv_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, &running, &readerDone]() {
             return !queue_.empty() || !running.load() || readerDone.load();
         });
@@ -151,11 +280,22 @@ public:
             return;
         }
         PacketStoreTraits<PacketT>::reset(packet);
+        std::shared_ptr<BudgetLease> budget = std::atomic_load(&budget_);
+        if (budget && budget->allocated() > budget->limit()) {
+            packet->data = std::make_shared<std::vector<uint8_t>>();
+        }
+        accountPayload(budget.get(), packet);
         freePackets_.enqueue(packet);
     }
 
     void cacheConfig(const uint8_t* data, size_t len, uint32_t flags) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<ProfiledMutex> lock(mutex_);
+        // 配置（SPS/PPS 等）变化后旧 GOP 无法用新配置解码，丢弃保留的 GOP，等下一个关键帧重新开始保留。
+        if (latestConfig_.size() != len || !std::equal(latestConfig_.begin(), latestConfig_.end(), data)) {
+            retained_.clear();
+            retainedBytes_ = 0;
+            retainedTruncated_ = true;
+        }
         latestConfig_.assign(data, data + len);
         latestConfigFlags_ = flags;
         ++latestConfigSerial_;
@@ -165,7 +305,7 @@ public:
                            uint32_t& flags,
                            uint64_t& serial,
                            uint64_t lastSerial) {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<ProfiledMutex> lock(mutex_);
         if (latestConfigSerial_ == 0 || latestConfigSerial_ == lastSerial || latestConfig_.empty()) {
             return false;
         }
@@ -176,12 +316,12 @@ public:
     }
 
     size_t queuedSize() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<ProfiledMutex> lock(mutex_);
         return queue_.size();
     }
 
     uint64_t droppedCount() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<ProfiledMutex> lock(mutex_);
         return droppedCount_;
     }
 
@@ -190,7 +330,37 @@ public:
     }
 
 private:
-    mutable std::mutex mutex_;
+    void accountPayload(BudgetLease* budget, PacketT* packet) {
+        if (!budget) {
+            return;
+        }
+        const size_t capacity = packet->data ? packet->data->capacity() : 0;
+        budget->addAllocated(static_cast<int64_t>(capacity) - static_cast<int64_t>(packet->accountedCapacity));
+        packet->accountedCapacity = capacity;
+    }
+
+    void retainLocked(const PacketT* packet) {
+        if (retention_ == PacketRetention::None || !packet->data) {
+            return;
+        }
+        const size_t size = packet->data->size();
+        if (PacketStoreTraits<PacketT>::isKeyFrame(packet)) {
+            retained_.clear();
+            retainedBytes_ = 0;
+            retainedTruncated_ = false;
+        } else if (retention_ != PacketRetention::Gop || retained_.empty() || retainedTruncated_) {
+            return;
+        } else if (retainedBytes_ + size > maxRetainedBytes_) {
+            // GOP 超出上限后停止追加：保留下来的前缀仍可连续解码，中间缺帧的尾部则不行。
+            retainedTruncated_ = true;
+            return;
+        }
+        retained_.push_back({packet->data, packet->pts, packet->submitFlags,
+                             PacketStoreTraits<PacketT>::isKeyFrame(packet)});
+        retainedBytes_ += size;
+    }
+
+    mutable ProfiledMutex mutex_{PacketStoreTraits<PacketT>::kLockName};
     std::condition_variable cv_;
     std::deque<PacketT*> queue_;
     moodycamel::ConcurrentQueue<PacketT*> freePackets_;
@@ -199,6 +369,13 @@ private:
     uint32_t latestConfigFlags_ = 0;
     uint64_t latestConfigSerial_ = 0;
     uint64_t droppedCount_ = 0;
+    PacketRetention retention_ = PacketRetention::None;
+    size_t maxRetainedBytes_ = 0;
+    std::vector<RetainedPacket> retained_;
+    size_t retainedBytes_ = 0;
+    bool retainedTruncated_ = false;
+    // 解码线程与 reset/attachBudget 并发访问，只经 std::atomic_load/atomic_store 读写
+    std::shared_ptr<BudgetLease> budget_;
 };
 
 #endif // SCRCPY_MEDIA_PACKET_STORE_H
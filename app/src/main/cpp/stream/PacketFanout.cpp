@@ -0,0 +1,326 @@
+#include "stream/PacketFanout.h"
+
+#include "diag/FlightRecorder.h"
+#include "diag/ThreadCpuMonitor.h"
+#include <hilog/log.h>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "PacketFanout"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+size_t payloadSize(const FanoutPacket& packet) {
+    return packet.data ? packet.data->size() : 0;
+}
+
+bool isControlPacket(const FanoutPacket& packet) {
+    return packet.isConfig || packet.isStreamHeader;
+}
+}
+
+class PacketFanout::SinkSlot {
+public:
+    SinkSlot(int32_t id, std::unique_ptr<IPacketSink> sink, const SinkOptions& options)
+        : id_(id), sink_(std::move(sink)), options_(options) {}
+
+    ~SinkSlot() { stop(); }
+
+    int32_t id() const { return id_; }
+    bool accepts(FanoutMediaKind kind) const { return sink_->accepts(kind); }
+    bool isDead() const { return dead_.load(); }
+
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return dropped_;
+    }
+
+    void start() {
+        thread_ = std::thread(&SinkSlot::run, this);
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            stopping_ = true;
+            queue_.clear();
+            queuedBytes_ = 0;
+        }
+        cv_.notify_all();
+        sink_->interrupt();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    void push(const FanoutPacket& packet) {
+        const size_t size = payloadSize(packet);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+            const bool control = isControlPacket(packet);
+            if (packet.kind == FanoutMediaKind::Video && !control && waitingVideoKeyFrame_) {
+                if (!packet.isKeyFrame) {
+                    noteDropLocked(packet.kind);
+                    return;
+                }
+                waitingVideoKeyFrame_ = false;
+            }
+
+            if (!control && overflowLocked(size)) {
+                if (packet.kind == FanoutMediaKind::Video) {
+                    // 残缺的 GOP 无法解码：丢掉队列里尚未送出的视频帧，从下一个关键帧重新开始
+                    dropQueuedLocked(FanoutMediaKind::Video);
+                    if (!packet.isKeyFrame) {
+                        waitingVideoKeyFrame_ = true;
+                        noteDropLocked(packet.kind);
+                        return;
+                    }
+                } else {
+                    dropOldestAudioLocked(size);
+                }
+                if (overflowLocked(size)) {
+                    if (packet.kind == FanoutMediaKind::Video) {
+                        waitingVideoKeyFrame_ = true;
+                    }
+                    noteDropLocked(packet.kind);
+                    return;
+                }
+            }
+
+            queue_.push_back(packet);
+            queuedBytes_ += size;
+        }
+        cv_.notify_one();
+    }
+
+private:
+    void noteDropLocked(FanoutMediaKind kind) {
+        ++dropped_;
+        FlightRecorder::instance().record(FlightEvent::PacketDrop,
+                                          static_cast<uint32_t>(kind == FanoutMediaKind::Video
+                                                                    ? FlightStreamKind::Video
+                                                                    : FlightStreamKind::Audio),
+                                          static_cast<uint32_t>(dropped_), static_cast<uint32_t>(id_));
+    }
+
+    bool overflowLocked(size_t incomingBytes) const {
+        return queue_.size() >= options_.maxQueuedPackets ||
+               queuedBytes_ + incomingBytes > options_.maxQueuedBytes;
+    }
+
+    void dropQueuedLocked(FanoutMediaKind kind) {
+        for (auto it = queue_.begin(); it != queue_.end();) {
+            if (it->kind == kind && !isControlPacket(*it)) {
+                queuedBytes_ -= payloadSize(*it);
+                noteDropLocked(it->kind);
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void dropOldestAudioLocked(size_t incomingBytes) {
+        for (auto it = queue_.begin(); it != queue_.end() && overflowLocked(incomingBytes);) {
+            if (it->kind == FanoutMediaKind::Audio && !isControlPacket(*it)) {
+                queuedBytes_ -= payloadSize(*it);
+                noteDropLocked(it->kind);
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void run() {
+        ThreadCpuMonitor::Scope cpuScope("fanout", "fanout-sink");
+        while (true) {
+            FanoutPacket packet;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (stopping_) {
+                    break;
+                }
+                packet = std::move(queue_.front());
+                queue_.pop_front();
+                queuedBytes_ -= payloadSize(packet);
+            }
+            if (!sink_->consume(packet)) {
+                OH_LOG_INFO(LOG_APP, "[PacketFanout] Sink %{public}s closed", sink_->debugName());
+                dead_.store(true);
+                break;
+            }
+        }
+    }
+
+    const int32_t id_;
+    std::unique_ptr<IPacketSink> sink_;
+    const SinkOptions options_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<FanoutPacket> queue_;
+    size_t queuedBytes_ = 0;
+    uint64_t dropped_ = 0;
+    bool waitingVideoKeyFrame_ = true;
+    bool stopping_ = false;
+    std::atomic<bool> dead_{false};
+    std::thread thread_;
+};
+
+PacketFanout::~PacketFanout() {
+    reset();
+}
+
+int32_t PacketFanout::addSink(std::unique_ptr<IPacketSink> sink, const SinkOptions& options) {
+    if (!sink) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    pruneDeadLocked();
+    auto slot = std::make_shared<SinkSlot>(nextSinkId_++, std::move(sink), options);
+    for (size_t i = 0; i < 2; ++i) {
+        const auto kind = static_cast<FanoutMediaKind>(i);
+        const KindState& state = kinds_[i];
+        if (!slot->accepts(kind)) {
+            continue;
+        }
+        if (state.header) {
+            FanoutPacket header;
+            header.kind = kind;
+            header.data = state.header;
+            header.isStreamHeader = true;
+            slot->push(header);
+        }
+        if (state.config) {
+            FanoutPacket config;
+            config.kind = kind;
+            config.data = state.config;
+            config.isConfig = true;
+            slot->push(config);
+        }
+        if (state.gopComplete) {
+            // 关键帧加其后全部增量帧，接上随后的实时包才能连续解码
+            for (const auto& cached : state.gop) {
+                slot->push(cached);
+            }
+        }
+    }
+    slot->start();
+    sinks_.push_back(slot);
+    sinkCount_.store(sinks_.size(), std::memory_order_relaxed);
+    OH_LOG_INFO(LOG_APP, "[PacketFanout] Sink %{public}d added, total=%{public}zu", slot->id(), sinks_.size());
+    return slot->id();
+}
+
+bool PacketFanout::removeSink(int32_t sinkId) {
+    std::shared_ptr<SinkSlot> removed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = sinks_.begin(); it != sinks_.end(); ++it) {
+            if ((*it)->id() == sinkId) {
+                removed = *it;
+                sinks_.erase(it);
+                break;
+            }
+        }
+        sinkCount_.store(sinks_.size(), std::memory_order_relaxed);
+        if (removed) {
+            retiredDropped_ += removed->dropped();
+        }
+    }
+    if (!removed) {
+        return false;
+    }
+    removed->stop();
+    return true;
+}
+
+void PacketFanout::publish(const FanoutPacket& packet) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    KindState& state = kinds_[kindIndex(packet.kind)];
+    if (packet.isConfig) {
+        // 新的 config 之后旧 GOP 已无法解码
+        state.config = packet.data;
+        state.gop.clear();
+        state.gopBytes = 0;
+        state.gopComplete = false;
+    } else if (packet.isKeyFrame) {
+        state.gop.clear();
+        state.gop.push_back(packet);
+        state.gopBytes = payloadSize(packet);
+        state.gopComplete = true;
+    } else if (state.gopComplete && !packet.isStreamHeader) {
+        if (state.gopBytes + payloadSize(packet) > MAX_REPLAY_GOP_BYTES) {
+            // 缺了尾部的 GOP 接不上实时包，整段放弃，新消费者等下一个关键帧
+            state.gop.clear();
+            state.gopBytes = 0;
+            state.gopComplete = false;
+        } else {
+            state.gop.push_back(packet);
+            state.gopBytes += payloadSize(packet);
+        }
+    }
+
+    if (sinks_.empty()) {
+        return;
+    }
+    pruneDeadLocked();
+    for (auto& slot : sinks_) {
+        if (slot->accepts(packet.kind)) {
+            slot->push(packet);
+        }
+    }
+}
+
+void PacketFanout::setStreamHeader(FanoutMediaKind kind, std::vector<uint8_t> header) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    KindState& state = kinds_[kindIndex(kind)];
+    state = KindState();
+    state.header = std::make_shared<std::vector<uint8_t>>(std::move(header));
+}
+
+void PacketFanout::reset() {
+    std::vector<std::shared_ptr<SinkSlot>> sinks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sinks.swap(sinks_);
+        sinkCount_.store(0, std::memory_order_relaxed);
+        for (auto& state : kinds_) {
+            state = KindState();
+        }
+        retiredDropped_ = 0;
+    }
+    for (auto& slot : sinks) {
+        slot->stop();
+    }
+}
+
+uint64_t PacketFanout::droppedPackets() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t total = retiredDropped_;
+    for (const auto& slot : sinks_) {
+        total += slot->dropped();
+    }
+    return total;
+}
+
+void PacketFanout::pruneDeadLocked() {
+    for (auto it = sinks_.begin(); it != sinks_.end();) {
+        if ((*it)->isDead()) {
+            retiredDropped_ += (*it)->dropped();
+            // 线程已自行退出，stop() 只做 join，不会阻塞读取线程
+            (*it)->stop();
+            it = sinks_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    sinkCount_.store(sinks_.size(), std::memory_order_relaxed);
+}
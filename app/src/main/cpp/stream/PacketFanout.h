@@ -0,0 +1,99 @@
+// PacketFanout - 编码包旁路分发
+// 解码器之外的本地消费者（socket 转发、录制、缩略图等）共享同一份负载引用，
+// 每个消费者有独立的有界队列和线程，慢消费者只会在自己的队列里丢包，不会拖住屏幕解码。
+#ifndef SCRCPY_PACKET_FANOUT_H
+#define SCRCPY_PACKET_FANOUT_H
+
+#include "stream/EncodedPacket.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class FanoutMediaKind : uint8_t {
+    Video = 0,
+    Audio = 1,
+};
+
+struct FanoutPacket {
+    FanoutMediaKind kind = FanoutMediaKind::Video;
+    PacketPayload data;
+    int64_t pts = 0;
+    bool isConfig = false;
+    bool isKeyFrame = false;
+    // 流头（视频 codecId/width/height，音频 codecId），只在消费者接入时投递一次
+    bool isStreamHeader = false;
+};
+
+class IPacketSink {
+public:
+    virtual ~IPacketSink() = default;
+    // 在消费者自己的线程中调用；返回 false 表示消费者已失效，随后会被移除
+    virtual bool consume(const FanoutPacket& packet) = 0;
+    // 只接收指定类型的包；返回 false 的包不会进入该消费者的队列
+    virtual bool accepts(FanoutMediaKind kind) const = 0;
+    // 移除消费者前调用，用于打断阻塞在 consume 中的 I/O
+    virtual void interrupt() {}
+    virtual const char* debugName() const = 0;
+};
+
+class PacketFanout {
+public:
+    struct SinkOptions {
+        size_t maxQueuedPackets = 240;
+        size_t maxQueuedBytes = 8 * 1024 * 1024;
+    };
+
+    PacketFanout() = default;
+    ~PacketFanout();
+
+    PacketFanout(const PacketFanout&) = delete;
+    PacketFanout& operator=(const PacketFanout&) = delete;
+
+    // 新消费者会先收到已缓存的流头、config 和从最近关键帧起的整个 GOP，之后才是实时包；
+    // GOP 超出回放上限时不回放，消费者从下一个实时关键帧开始
+    int32_t addSink(std::unique_ptr<IPacketSink> sink, const SinkOptions& options);
+    int32_t addSink(std::unique_ptr<IPacketSink> sink) { return addSink(std::move(sink), SinkOptions()); }
+    bool removeSink(int32_t sinkId);
+
+    // 由读取线程调用，只做入队，不会等待消费者
+    void publish(const FanoutPacket& packet);
+    void setStreamHeader(FanoutMediaKind kind, std::vector<uint8_t> header);
+
+    // 停止所有消费者并清空缓存的流状态
+    void reset();
+
+    size_t sinkCount() const { return sinkCount_.load(std::memory_order_relaxed); }
+    uint64_t droppedPackets() const;
+
+private:
+    class SinkSlot;
+
+    struct KindState {
+        PacketPayload header;
+        PacketPayload config;
+        // 最近关键帧及其后的增量帧；gopComplete 为 false 时 gop 不可单独解码，不回放
+        std::vector<FanoutPacket> gop;
+        size_t gopBytes = 0;
+        bool gopComplete = false;
+    };
+
+    static constexpr size_t MAX_REPLAY_GOP_BYTES = 8 * 1024 * 1024;
+
+    static size_t kindIndex(FanoutMediaKind kind) { return static_cast<size_t>(kind); }
+    void pruneDeadLocked();
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<SinkSlot>> sinks_;
+    KindState kinds_[2];
+    int32_t nextSinkId_ = 1;
+    uint64_t retiredDropped_ = 0;
+    std::atomic<size_t> sinkCount_{0};
+};
+
+#endif // SCRCPY_PACKET_FANOUT_H
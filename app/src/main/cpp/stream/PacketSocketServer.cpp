@@ -0,0 +1,185 @@
+#include "stream/PacketSocketServer.h"
+
+#include "diag/ThreadCpuMonitor.h"
+#include "util/SocketTuning.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <hilog/log.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "PacketFanout"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+constexpr uint64_t SCRCPY_PACKET_FLAG_CONFIG = 1ULL << 63;
+constexpr uint64_t SCRCPY_PACKET_FLAG_KEY_FRAME = 1ULL << 62;
+
+void writeUint64BE(uint8_t* out, uint64_t value) {
+    for (int i = 7; i >= 0; --i) {
+        out[i] = static_cast<uint8_t>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+void writeUint32BE(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+}
+
+class SocketPacketSink : public IPacketSink {
+public:
+    SocketPacketSink(int fd, FanoutMediaKind kind) : fd_(fd), kind_(kind) {}
+
+    ~SocketPacketSink() override {
+        ::close(fd_);
+    }
+
+    bool accepts(FanoutMediaKind kind) const override {
+        return kind == kind_;
+    }
+
+    bool consume(const FanoutPacket& packet) override {
+        if (!packet.data) {
+            return true;
+        }
+        if (packet.isStreamHeader) {
+            return sendAll(packet.data->data(), packet.data->size());
+        }
+
+        uint64_t ptsAndFlags = static_cast<uint64_t>(packet.pts);
+        if (packet.isConfig) {
+            ptsAndFlags |= SCRCPY_PACKET_FLAG_CONFIG;
+        }
+        if (packet.isKeyFrame) {
+            ptsAndFlags |= SCRCPY_PACKET_FLAG_KEY_FRAME;
+        }
+        uint8_t header[12];
+        writeUint64BE(header, ptsAndFlags);
+        writeUint32BE(header + 8, static_cast<uint32_t>(packet.data->size()));
+        return sendAll(header, sizeof(header)) && sendAll(packet.data->data(), packet.data->size());
+    }
+
+    void interrupt() override {
+        ::shutdown(fd_, SHUT_RDWR);
+    }
+
+    const char* debugName() const override {
+        return kind_ == FanoutMediaKind::Video ? "video-socket" : "audio-socket";
+    }
+
+private:
+    bool sendAll(const uint8_t* data, size_t size) {
+        size_t sent = 0;
+        while (sent < size) {
+            ssize_t n = ::send(fd_, data + sent, size - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    int fd_;
+    FanoutMediaKind kind_;
+};
+}
+
+PacketSocketServer::PacketSocketServer(PacketFanout& fanout, FanoutMediaKind kind)
+    : fanout_(fanout), kind_(kind) {}
+
+PacketSocketServer::~PacketSocketServer() {
+    stop();
+}
+
+int32_t PacketSocketServer::start(uint16_t port) {
+    if (running_.load()) {
+        return port_;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        OH_LOG_ERROR(LOG_APP, "[PacketServer] create socket failed errno=%{public}d", errno);
+        return -1;
+    }
+
+    int reuseAddr = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof(reuseAddr));
+
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        OH_LOG_ERROR(LOG_APP, "[PacketServer] bind %{public}u failed errno=%{public}d", port, errno);
+        ::close(fd);
+        return -2;
+    }
+    if (listen(fd, 4) != 0) {
+        OH_LOG_ERROR(LOG_APP, "[PacketServer] listen failed errno=%{public}d", errno);
+        ::close(fd);
+        return -3;
+    }
+
+    sockaddr_in localAddr {};
+    socklen_t localAddrLen = sizeof(localAddr);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&localAddr), &localAddrLen) != 0) {
+        OH_LOG_ERROR(LOG_APP, "[PacketServer] getsockname failed errno=%{public}d", errno);
+        ::close(fd);
+        return -4;
+    }
+
+    listenFd_.store(fd);
+    port_ = ntohs(localAddr.sin_port);
+    running_.store(true);
+    acceptThread_ = std::thread(&PacketSocketServer::acceptLoop, this);
+    OH_LOG_INFO(LOG_APP, "[PacketServer] Serving %{public}s packets on 127.0.0.1:%{public}u",
+                kind_ == FanoutMediaKind::Video ? "video" : "audio", port_);
+    return port_;
+}
+
+void PacketSocketServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // shutdown 让阻塞的 accept 返回；等线程退出后再 close，避免 fd 号被复用后 accept 落到别的 socket 上
+    const int fd = listenFd_.load();
+    if (fd >= 0) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    if (acceptThread_.joinable()) {
+        acceptThread_.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        listenFd_.store(-1);
+    }
+}
+
+void PacketSocketServer::acceptLoop() {
+    ThreadCpuMonitor::Scope cpuScope("accept", "packet-accept");
+    const int listenFd = listenFd_.load();
+    while (running_.load()) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR && running_.load()) {
+                continue;
+            }
+            break;
+        }
+        SocketTuning::apply(fd, SocketProfile::Bulk, "packet-sink");
+        int32_t sinkId = fanout_.addSink(std::make_unique<SocketPacketSink>(fd, kind_));
+        OH_LOG_INFO(LOG_APP, "[PacketServer] Client attached as sink %{public}d", sinkId);
+    }
+}
@@ -0,0 +1,39 @@
+// PacketSocketServer - 通过本机 TCP 端口对外提供原始 scrcpy 分帧的编码流
+// 每个连接是 PacketFanout 的一个独立消费者：先收到流头，再收到 (pts|flags, size, payload) 包。
+#ifndef SCRCPY_PACKET_SOCKET_SERVER_H
+#define SCRCPY_PACKET_SOCKET_SERVER_H
+
+#include "stream/PacketFanout.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+class PacketSocketServer {
+public:
+    PacketSocketServer(PacketFanout& fanout, FanoutMediaKind kind);
+    ~PacketSocketServer();
+
+    PacketSocketServer(const PacketSocketServer&) = delete;
+    PacketSocketServer& operator=(const PacketSocketServer&) = delete;
+
+    // 监听 127.0.0.1:port（0 表示随机端口），返回实际端口；失败返回负数
+    int32_t start(uint16_t port);
+    void stop();
+
+    FanoutMediaKind kind() const { return kind_; }
+    uint16_t port() const { return port_; }
+
+private:
+    void acceptLoop();
+
+    PacketFanout& fanout_;
+    const FanoutMediaKind kind_;
+    // stop() 与 accept 线程都会访问
+    std::atomic<int> listenFd_{-1};
+    uint16_t port_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread acceptThread_;
+};
+
+#endif // SCRCPY_PACKET_SOCKET_SERVER_H
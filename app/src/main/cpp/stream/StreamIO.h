@@ -17,6 +17,13 @@ public:
     virtual void readExact(uint8_t* dest, size_t size, int32_t timeoutMs) = 0;
     virtual bool isClosed() const = 0;
     virtual const char* debugName() const = 0;
+
+    // 到达时刻：只有 ADB 转发流能按 WRTE 记录，其它实现返回 0，调用方退回读取时刻
+    virtual void enableArrivalTracking() {}
+    // 下一个待读字节在流中的位置
+    virtual uint64_t readPosition() const { return 0; }
+    // position 处字节到达本机的时刻（steady_clock ns），未知为 0
+    virtual int64_t arrivalNs(uint64_t position) { (void)position; return 0; }
 };
 
 class IByteSink {
@@ -92,8 +99,8 @@ PacketT* readScrcpyPacketPayload(ReadFn&& readToBuffer,
         return nullptr;
     }
 
-    packet->data.resize(static_cast<size_t>(meta.frameSize));
-    readToBuffer(packet->data.data(), static_cast<size_t>(meta.frameSize));
+    packet->data->resize(static_cast<size_t>(meta.frameSize));
+    readToBuffer(packet->data->data(), static_cast<size_t>(meta.frameSize));
 
     return packet;
 }
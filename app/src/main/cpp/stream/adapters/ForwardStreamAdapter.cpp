@@ -26,6 +26,20 @@ public:
         return debugName_;
     }
 
+    void enableArrivalTracking() override {
+        if (stream_) {
+            stream_->arrivals.enable();
+        }
+    }
+
+    uint64_t readPosition() const override {
+        return stream_ ? stream_->readBuffer.totalRead() : 0;
+    }
+
+    int64_t arrivalNs(uint64_t position) override {
+        return stream_ ? stream_->arrivals.arrivalAt(position) : 0;
+    }
+
 private:
     Adb* adb_;
     AdbStream* stream_;
@@ -1,5 +1,6 @@
 #include "stream/adapters/ReverseStreamAdapter.h"
 
+#include "diag/StallWatchdog.h"
 #include <stdexcept>
 
 namespace {
@@ -11,6 +12,7 @@ public:
         if (!channel_) {
             throw std::runtime_error("byte stream channel unavailable");
         }
+        StallWatchdog::WaitScope waitScope("socket_read", -1, StallWatchdog::WaitKind::Idle);
         channel_->readWithTimeout(dest, size, timeoutMs);
     }
 
@@ -35,6 +37,7 @@ public:
         if (!channel_) {
             throw std::runtime_error("byte sink channel unavailable");
         }
+        StallWatchdog::WaitScope waitScope("socket_write");
         channel_->write(data, len);
     }
 
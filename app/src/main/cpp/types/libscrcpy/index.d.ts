@@ -10,7 +10,7 @@ export interface AdbInstallPackageResult extends AdbShellCommandResult {
     remotePath: string;
 }
 
-export const adbCreate: (ip: string, port: number) => number;
+export const adbCreate: (ip: string, port: number, connectTimeoutMs?: number) => number;
 export const adbConnect: (adbId: number, pubKeyPath: string, priKeyPath: string) => number;
 export const adbGetLastConnectError: (adbId: number) => string;
 export const adbPair: (hostPort: string, pairingCode: string, pubKeyPath: string, priKeyPath: string) => Promise<string>;
@@ -45,6 +45,8 @@ export const adbPushFileFromFd: (
     onProgress?: (progress: number) => void
 ) => Promise<void>;
 export const adbTcpForward: (adbId: number, port: number) => number;
+export const adbForwardListen: (adbId: number, localPort: number, remote: string) => number;
+export const adbForwardRemove: (adbId: number, localPort: number) => boolean;
 export const adbLocalSocketForward: (
     adbId: number,
     socketName: string,
@@ -64,7 +66,8 @@ export const nativeStartStreams: (
     surfaceId: string,
     audioSampleRate: number,
     audioChannelCount: number,
-    cb: (type: string, data: string) => void
+    cb: (type: string, data: string) => void,
+    streamAdbIds?: number[]
 ) => Promise<number>;
 export const nativeStartReverseStreams: (
     adbId: number,
@@ -78,7 +81,30 @@ export const nativeStartReverseStreams: (
 ) => Promise<number>;
 export const nativeStopStreams: () => void;
 export const nativeSendControl: (data: ArrayBuffer) => boolean;
+export const nativeResyncVideo: () => boolean;
+export const nativeEnableAutoReconnect: (
+    serverCommand: string,
+    socketName: string,
+    pubKeyPath: string,
+    priKeyPath: string,
+    deadPeerMs?: number,
+    targetMs?: number
+) => boolean;
+export const nativeStartPacketServer: (kind: 'video' | 'audio', port: number) => number;
+export const nativeOnMemoryLevel: (level: number) => void;
+export const nativeGetStats: () => string;
+export const nativeSetDiagnosticsDir: (dir: string) => void;
+export const nativeDumpFlightRecorder: (reason?: string) => string;
+export const nativeSetLockProfiling: (enabled: boolean) => void;
+export const nativeSetAllocTracking: (enabled: boolean, budgetPerFrame?: number) => boolean;
 export const adbClose: (adbId: number) => void;
+export const adbSetTlsSessionDir: (dir: string) => void;
+export const adbSetTlsDecryptPipeline: (enabled: boolean) => void;
+export const adbSetReactorMode: (enabled: boolean, threads?: number) => void;
+export const adbSetIoUring: (enabled: boolean) => boolean;
+export const adbSetReverseBridgeZeroCopy: (enabled: boolean) => void;
+export const adbPoolOpen: (adbId: number, connections: number, pubKeyPath: string, priKeyPath: string) => Promise<number>;
+export const adbPoolConnectionFor: (adbId: number, trafficClass: string) => number;
 export const adbStreamRead: (adbId: number, streamId: number, size: number) => ArrayBuffer;
 export const adbStreamWrite: (adbId: number, streamId: number, data: ArrayBuffer) => Promise<void>;
 export const destroyBufferPool: () => void;
@@ -0,0 +1,210 @@
+#include "util/AllocTracker.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <hilog/log.h>
+#include <new>
+#include <sstream>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "AllocTracker"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+constexpr size_t STAGE_COUNT = static_cast<size_t>(AllocStage::Count);
+
+const char* const STAGE_NAMES[STAGE_COUNT] = {
+    "other", "demux", "send", "stream_write", "video_read", "video_decode", "audio_read", "audio_decode", "control",
+};
+
+struct StageCounters {
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> frees{0};
+};
+
+std::array<StageCounters, STAGE_COUNT> g_counters;
+std::atomic<bool> g_enabled{false};
+std::atomic<uint32_t> g_budgetPerFrame{0};
+std::atomic<uint64_t> g_frames{0};
+// 热身结束时各阶段（不含 other）的分配总数
+std::atomic<uint64_t> g_steadyBaseline{0};
+std::atomic<bool> g_budgetWarned{false};
+
+// 平凡初始化的 thread_local，operator new 中读取不会触发分配
+thread_local AllocStage t_stage = AllocStage::None;
+
+uint64_t pipelineAllocs() {
+    uint64_t total = 0;
+    for (size_t i = 1; i < STAGE_COUNT; ++i) {
+        total += g_counters[i].allocs.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+double steadyAllocsPerFrame(uint64_t frames) {
+    if (frames <= AllocTracker::WARMUP_FRAMES) {
+        return 0;
+    }
+    const uint64_t baseline = g_steadyBaseline.load(std::memory_order_relaxed);
+    const uint64_t total = pipelineAllocs();
+    return static_cast<double>(total > baseline ? total - baseline : 0) /
+           static_cast<double>(frames - AllocTracker::WARMUP_FRAMES);
+}
+}
+
+AllocTracker::StageScope::StageScope(AllocStage stage) : previous_(t_stage) {
+    t_stage = stage;
+}
+
+AllocTracker::StageScope::~StageScope() {
+    t_stage = previous_;
+}
+
+bool AllocTracker::compiledIn() {
+#ifdef SCRCPY_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocTracker::setEnabled(bool enabled, uint32_t budgetPerFrame) {
+    if (enabled) {
+        for (auto& counters : g_counters) {
+            counters.allocs.store(0, std::memory_order_relaxed);
+            counters.bytes.store(0, std::memory_order_relaxed);
+            counters.frees.store(0, std::memory_order_relaxed);
+        }
+        g_frames.store(0, std::memory_order_relaxed);
+        g_steadyBaseline.store(0, std::memory_order_relaxed);
+        g_budgetWarned.store(false, std::memory_order_relaxed);
+    }
+    g_budgetPerFrame.store(budgetPerFrame, std::memory_order_relaxed);
+    g_enabled.store(enabled && compiledIn(), std::memory_order_release);
+    if (enabled && !compiledIn()) {
+        OH_LOG_WARN(LOG_APP, "[AllocTracker] Not compiled in, rebuild with -DSCRCPY_ALLOC_TRACKING=ON");
+    }
+}
+
+bool AllocTracker::enabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void AllocTracker::noteFrame() {
+    if (!enabled()) {
+        return;
+    }
+    const uint64_t frames = g_frames.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (frames == WARMUP_FRAMES) {
+        g_steadyBaseline.store(pipelineAllocs(), std::memory_order_relaxed);
+        return;
+    }
+    const uint32_t budget = g_budgetPerFrame.load(std::memory_order_relaxed);
+    // 每 60 帧检查一次，超预算只告警一次
+    if (budget == 0 || frames < WARMUP_FRAMES + 60 || frames % 60 != 0) {
+        return;
+    }
+    const double perFrame = steadyAllocsPerFrame(frames);
+    if (perFrame > budget && !g_budgetWarned.exchange(true)) {
+        OH_LOG_WARN(LOG_APP, "[AllocTracker] Steady-state allocations %{public}.2f/frame exceed budget %{public}u",
+                    perFrame, budget);
+    }
+}
+
+void AllocTracker::recordAlloc(size_t bytes) {
+    if (!g_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    StageCounters& counters = g_counters[static_cast<size_t>(t_stage)];
+    counters.allocs.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocTracker::recordFree() {
+    if (!g_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    g_counters[static_cast<size_t>(t_stage)].frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string AllocTracker::toJson() {
+    const uint64_t frames = g_frames.load(std::memory_order_relaxed);
+    const uint32_t budget = g_budgetPerFrame.load(std::memory_order_relaxed);
+    const bool steady = frames > WARMUP_FRAMES;
+    const double perFrame = steadyAllocsPerFrame(frames);
+
+    std::ostringstream oss;
+    oss << "{\"compiled\":" << (compiledIn() ? "true" : "false")
+        << ",\"enabled\":" << (enabled() ? "true" : "false")
+        << ",\"frames\":" << frames
+        << ",\"warmupFrames\":" << WARMUP_FRAMES
+        << ",\"steady\":" << (steady ? "true" : "false")
+        << ",\"steadyAllocsPerFrame\":" << perFrame
+        << ",\"budgetPerFrame\":" << budget
+        << ",\"withinBudget\":" << ((budget == 0 || !steady || perFrame <= budget) ? "true" : "false")
+        << ",\"stages\":{";
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "\"" << STAGE_NAMES[i] << "\":{\"allocs\":" << g_counters[i].allocs.load(std::memory_order_relaxed)
+            << ",\"bytes\":" << g_counters[i].bytes.load(std::memory_order_relaxed)
+            << ",\"frees\":" << g_counters[i].frees.load(std::memory_order_relaxed) << "}";
+    }
+    oss << "}}";
+    return oss.str();
+}
+
+#ifdef SCRCPY_ALLOC_TRACKING
+// 全局替换：只覆盖普通与 nothrow 形式，对齐形式仍走默认实现（自成一对，不会混用）
+void* operator new(size_t size) {
+    AllocTracker::recordAlloc(size);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    AllocTracker::recordAlloc(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        AllocTracker::recordFree();
+        std::free(ptr);
+    }
+}
+
+void operator delete[](void* ptr) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    ::operator delete(ptr);
+}
+#endif
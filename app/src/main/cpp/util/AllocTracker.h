@@ -0,0 +1,57 @@
+// AllocTracker - 热路径堆分配统计（可选）
+// 在 CMake 打开 SCRCPY_ALLOC_TRACKING 时替换全局 operator new/delete，把每次分配计到当前线程的
+// 管线阶段上（由 StageScope 标记，可嵌套）。未编译进来时 StageScope 只是一次 thread_local 写，
+// setEnabled 无效果。
+// 稳态检查：以已提交的视频帧为单位，热身 WARMUP_FRAMES 帧之后统计每帧分配次数，
+// 超过预算时记 warn 日志并在 stats 中标记 withinBudget=false。
+#ifndef SCRCPY_ALLOC_TRACKER_H
+#define SCRCPY_ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class AllocStage : uint8_t {
+    None = 0,
+    Demux,
+    Send,
+    StreamWrite,
+    VideoRead,
+    VideoDecode,
+    AudioRead,
+    AudioDecode,
+    Control,
+    Count
+};
+
+class AllocTracker {
+public:
+    class StageScope {
+    public:
+        explicit StageScope(AllocStage stage);
+        ~StageScope();
+        StageScope(const StageScope&) = delete;
+        StageScope& operator=(const StageScope&) = delete;
+
+    private:
+        AllocStage previous_;
+    };
+
+    static constexpr uint64_t WARMUP_FRAMES = 120;
+
+    static bool compiledIn();
+    // 开启时清零计数；budgetPerFrame 为 0 表示不检查预算
+    static void setEnabled(bool enabled, uint32_t budgetPerFrame);
+    static bool enabled();
+
+    // 视频帧成功送入解码器后调用
+    static void noteFrame();
+
+    // 仅供 operator new/delete 调用，不得分配内存
+    static void recordAlloc(size_t bytes);
+    static void recordFree();
+
+    static std::string toJson();
+};
+
+#endif // SCRCPY_ALLOC_TRACKER_H
@@ -0,0 +1,233 @@
+#include "util/MemoryBudget.h"
+
+#include <algorithm>
+#include <hilog/log.h>
+#include <sstream>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "MemoryBudget"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+// 系统只通知进入压力状态，不通知恢复；超过这个时间没有新的通知就视为已恢复
+constexpr int64_t PRESSURE_DECAY_MS = 60 * 1000;
+
+const char* categoryName(BudgetCategory category) {
+    switch (category) {
+        case BudgetCategory::StreamRing: return "streamRing";
+        case BudgetCategory::PendingWrite: return "pendingWrite";
+        case BudgetCategory::PacketStore: return "packetStore";
+        case BudgetCategory::PcmPool: return "pcmPool";
+        default: return "unknown";
+    }
+}
+
+double pressureFactor(MemoryPressure level) {
+    switch (level) {
+        case MemoryPressure::Moderate: return 0.75;
+        case MemoryPressure::Low: return 0.5;
+        case MemoryPressure::Critical: return 0.25;
+        default: return 1.0;
+    }
+}
+}
+
+BudgetLease::BudgetLease(BudgetCategory category, std::string name, size_t requested, size_t minimum)
+    : category_(category), name_(std::move(name)), requested_(requested),
+      minimum_(std::min(minimum, requested)), limit_(requested) {}
+
+BudgetLease::~BudgetLease() {
+    MemoryBudget::instance().unregisterLease(this);
+}
+
+void BudgetLease::release() {
+    MemoryBudget::instance().unregisterLease(this);
+    allocated_.store(0, std::memory_order_relaxed);
+}
+
+void BudgetLease::addAllocated(int64_t delta) {
+    if (delta >= 0) {
+        allocated_.fetch_add(static_cast<size_t>(delta), std::memory_order_relaxed);
+    } else {
+        allocated_.fetch_sub(static_cast<size_t>(-delta), std::memory_order_relaxed);
+    }
+}
+
+MemoryBudget& MemoryBudget::instance() {
+    static MemoryBudget budget;
+    return budget;
+}
+
+MemoryBudget::~MemoryBudget() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shuttingDown_ = true;
+    }
+    decayCv_.notify_all();
+    if (decayThread_.joinable()) {
+        decayThread_.join();
+    }
+}
+
+std::shared_ptr<BudgetLease> MemoryBudget::acquire(BudgetCategory category, const std::string& name,
+                                                   size_t requested, size_t minimum) {
+    std::shared_ptr<BudgetLease> lease(new BudgetLease(category, name, requested, minimum));
+    std::lock_guard<std::mutex> lock(mutex_);
+    leases_.push_back(lease.get());
+    rebalanceLocked();
+    return lease;
+}
+
+void MemoryBudget::unregisterLease(const BudgetLease* lease) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(leases_.begin(), leases_.end(), lease);
+    if (it == leases_.end()) {
+        return;
+    }
+    leases_.erase(it);
+    rebalanceLocked();
+}
+
+void MemoryBudget::setTotalBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    totalBudget_ = bytes;
+    rebalanceLocked();
+}
+
+size_t MemoryBudget::totalBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totalBudget_;
+}
+
+void MemoryBudget::onMemoryPressure(MemoryPressure level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pressure_ = level;
+    pressureAt_ = std::chrono::steady_clock::now();
+    OH_LOG_INFO(LOG_APP, "[MemoryBudget] Memory pressure level=%{public}d", static_cast<int32_t>(level));
+    rebalanceLocked();
+    if (level != MemoryPressure::Normal && !decayThread_.joinable()) {
+        decayThread_ = std::thread(&MemoryBudget::decayThreadFunc, this);
+    }
+    decayCv_.notify_all();
+}
+
+MemoryPressure MemoryBudget::pressure() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pressureExpiredLocked() ? MemoryPressure::Normal : pressure_;
+}
+
+bool MemoryBudget::pressureExpiredLocked() const {
+    if (pressure_ == MemoryPressure::Normal) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - pressureAt_).count();
+    return elapsed >= PRESSURE_DECAY_MS;
+}
+
+void MemoryBudget::decayThreadFunc() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!shuttingDown_) {
+        if (pressure_ == MemoryPressure::Normal) {
+            decayCv_.wait(lock);
+            continue;
+        }
+        // 新的压力通知会刷新 pressureAt_ 并唤醒这里重新计算截止时间
+        decayCv_.wait_until(lock, pressureAt_ + std::chrono::milliseconds(PRESSURE_DECAY_MS));
+        if (!shuttingDown_ && pressureExpiredLocked()) {
+            OH_LOG_INFO(LOG_APP, "[MemoryBudget] Memory pressure expired, restoring limits");
+            rebalanceLocked();
+        }
+    }
+}
+
+size_t MemoryBudget::effectiveBudgetLocked() const {
+    return static_cast<size_t>(static_cast<double>(totalBudget_) * pressureFactor(pressure_));
+}
+
+void MemoryBudget::rebalanceLocked() {
+    if (pressureExpiredLocked()) {
+        pressure_ = MemoryPressure::Normal;
+    }
+    ++rebalanceCount_;
+
+    size_t requestedTotal = 0;
+    size_t minimumTotal = 0;
+    for (const BudgetLease* lease : leases_) {
+        requestedTotal += lease->requested_;
+        minimumTotal += lease->minimum_;
+    }
+
+    const size_t budget = effectiveBudgetLocked();
+    if (requestedTotal <= budget) {
+        for (BudgetLease* lease : leases_) {
+            lease->limit_.store(lease->requested_, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    // 先保证每个登记方的最小容量，剩余部分按 (requested - minimum) 的比例分配
+    const size_t spare = budget > minimumTotal ? budget - minimumTotal : 0;
+    const size_t flexibleTotal = requestedTotal - minimumTotal;
+    for (BudgetLease* lease : leases_) {
+        const size_t flexible = lease->requested_ - lease->minimum_;
+        size_t extra = 0;
+        if (flexibleTotal > 0) {
+            extra = static_cast<size_t>(static_cast<double>(spare) * flexible / flexibleTotal);
+        }
+        lease->limit_.store(lease->minimum_ + std::min(extra, flexible), std::memory_order_relaxed);
+    }
+}
+
+std::string MemoryBudget::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    struct CategoryTotals {
+        size_t count = 0;
+        size_t requested = 0;
+        size_t limit = 0;
+        size_t allocated = 0;
+    };
+    CategoryTotals totals[static_cast<size_t>(BudgetCategory::Count)];
+    size_t allocatedTotal = 0;
+    for (const BudgetLease* lease : leases_) {
+        CategoryTotals& t = totals[static_cast<size_t>(lease->category_)];
+        ++t.count;
+        t.requested += lease->requested_;
+        t.limit += lease->limit();
+        t.allocated += lease->allocated();
+        allocatedTotal += lease->allocated();
+    }
+
+    std::ostringstream oss;
+    oss << "{\"totalBudget\":" << totalBudget_
+        << ",\"effectiveBudget\":" << effectiveBudgetLocked()
+        << ",\"pressure\":" << static_cast<int32_t>(pressure_)
+        << ",\"allocated\":" << allocatedTotal
+        << ",\"rebalances\":" << rebalanceCount_
+        << ",\"categories\":{";
+    for (size_t i = 0; i < static_cast<size_t>(BudgetCategory::Count); ++i) {
+        if (i > 0) {
+            oss << ",";
+        }
+        const CategoryTotals& t = totals[i];
+        oss << "\"" << categoryName(static_cast<BudgetCategory>(i)) << "\":{"
+            << "\"count\":" << t.count
+            << ",\"requested\":" << t.requested
+            << ",\"limit\":" << t.limit
+            << ",\"allocated\":" << t.allocated << "}";
+    }
+    oss << "},\"leases\":[";
+    for (size_t i = 0; i < leases_.size(); ++i) {
+        const BudgetLease* lease = leases_[i];
+        if (i > 0) {
+            oss << ",";
+        }
+        oss << "{\"name\":\"" << lease->name_ << "\""
+            << ",\"category\":\"" << categoryName(lease->category_) << "\""
+            << ",\"limit\":" << lease->limit()
+            << ",\"allocated\":" << lease->allocated() << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
@@ -0,0 +1,101 @@
+// MemoryBudget - 进程级流缓冲内存预算
+// ADB 读环形缓冲、待发送写缓冲、编码包池和 PCM 池都在这里登记。
+// 登记方拿到一个 BudgetLease：limit() 是当前允许持有的上限（随活跃流数量和系统内存压力变化），
+// setAllocated() 上报实际持有的字节数，用于统计。
+#ifndef SCRCPY_MEMORY_BUDGET_H
+#define SCRCPY_MEMORY_BUDGET_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class BudgetCategory : uint8_t {
+    StreamRing = 0,
+    PendingWrite,
+    PacketStore,
+    PcmPool,
+    Count,
+};
+
+// 对应 AbilityConstant.MemoryLevel，Normal 为本地扩展
+enum class MemoryPressure : int32_t {
+    Normal = -1,
+    Moderate = 0,
+    Low = 1,
+    Critical = 2,
+};
+
+class BudgetLease {
+public:
+    ~BudgetLease();
+
+    BudgetLease(const BudgetLease&) = delete;
+    BudgetLease& operator=(const BudgetLease&) = delete;
+
+    size_t limit() const { return limit_.load(std::memory_order_relaxed); }
+    size_t allocated() const { return allocated_.load(std::memory_order_relaxed); }
+    void setAllocated(size_t bytes) { allocated_.store(bytes, std::memory_order_relaxed); }
+    void addAllocated(int64_t delta);
+    BudgetCategory category() const { return category_; }
+    // 登记方不再需要份额（如流已关闭）但对象还有人引用时，提前退出分配并立即重新平衡；
+    // limit() 保持最后一次分到的值，析构时不会重复注销
+    void release();
+
+private:
+    friend class MemoryBudget;
+    BudgetLease(BudgetCategory category, std::string name, size_t requested, size_t minimum);
+
+    const BudgetCategory category_;
+    const std::string name_;
+    const size_t requested_;
+    const size_t minimum_;
+    std::atomic<size_t> limit_;
+    std::atomic<size_t> allocated_{0};
+};
+
+class MemoryBudget {
+public:
+    static MemoryBudget& instance();
+
+    // requested 是理想容量，minimum 是保证不低于的容量；返回时 limit() 已按当前预算分配好
+    std::shared_ptr<BudgetLease> acquire(BudgetCategory category, const std::string& name,
+                                         size_t requested, size_t minimum);
+
+    void setTotalBudget(size_t bytes);
+    size_t totalBudget() const;
+    void onMemoryPressure(MemoryPressure level);
+    MemoryPressure pressure() const;
+
+    std::string toJson() const;
+
+private:
+    friend class BudgetLease;
+    MemoryBudget() = default;
+    ~MemoryBudget();
+
+    void unregisterLease(const BudgetLease* lease);
+    // 系统不通知压力解除，由这个线程在 PRESSURE_DECAY_MS 后恢复上限；首次收到压力通知时启动
+    void decayThreadFunc();
+    bool pressureExpiredLocked() const;
+    void rebalanceLocked();
+    size_t effectiveBudgetLocked() const;
+
+    mutable std::mutex mutex_;
+    std::vector<BudgetLease*> leases_;
+    size_t totalBudget_ = 128 * 1024 * 1024;
+    MemoryPressure pressure_ = MemoryPressure::Normal;
+    std::chrono::steady_clock::time_point pressureAt_;
+    uint64_t rebalanceCount_ = 0;
+    std::thread decayThread_;
+    std::condition_variable decayCv_;
+    bool shuttingDown_ = false;
+};
+
+#endif // SCRCPY_MEMORY_BUDGET_H
@@ -0,0 +1,121 @@
+#include "util/ProfiledMutex.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <sstream>
+
+std::atomic<bool> LockProfiler::enabled_{false};
+
+namespace {
+struct LockRegistry {
+    std::mutex mutex;
+    // LockStats 创建后不释放，ProfiledMutex 持有裸指针
+    std::map<std::string, std::unique_ptr<LockStats>> stats;
+};
+
+LockRegistry& registry() {
+    static LockRegistry* instance = new LockRegistry();
+    return *instance;
+}
+
+size_t bucketFor(uint64_t waitNs) {
+    uint64_t us = waitNs / 1000;
+    size_t bucket = 0;
+    while (us > 1 && bucket + 1 < LockStats::BUCKETS) {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+}
+
+void LockStats::recordWait(uint64_t waitNs) {
+    contended.fetch_add(1, std::memory_order_relaxed);
+    waitNsTotal.fetch_add(waitNs, std::memory_order_relaxed);
+    uint64_t currentMax = waitNsMax.load(std::memory_order_relaxed);
+    while (waitNs > currentMax &&
+           !waitNsMax.compare_exchange_weak(currentMax, waitNs, std::memory_order_relaxed)) {
+    }
+    waitHistogram[bucketFor(waitNs)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LockStats::reset() {
+    acquisitions.store(0, std::memory_order_relaxed);
+    contended.store(0, std::memory_order_relaxed);
+    waitNsTotal.store(0, std::memory_order_relaxed);
+    waitNsMax.store(0, std::memory_order_relaxed);
+    for (auto& bucket : waitHistogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LockProfiler::setEnabled(bool enabled) {
+    if (enabled && !enabled_.load(std::memory_order_relaxed)) {
+        LockRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto& entry : reg.stats) {
+            entry.second->reset();
+        }
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+LockStats* LockProfiler::statsFor(const char* name) {
+    LockRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto& slot = reg.stats[name];
+    if (!slot) {
+        slot = std::make_unique<LockStats>();
+    }
+    return slot.get();
+}
+
+std::string LockProfiler::toJson() {
+    LockRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::ostringstream oss;
+    oss << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"locks\":[";
+    bool first = true;
+    for (const auto& entry : reg.stats) {
+        const LockStats& s = *entry.second;
+        if (!first) {
+            oss << ",";
+        }
+        first = false;
+        oss << "{\"name\":\"" << entry.first << "\""
+            << ",\"acquisitions\":" << s.acquisitions.load(std::memory_order_relaxed)
+            << ",\"contended\":" << s.contended.load(std::memory_order_relaxed)
+            << ",\"waitUsTotal\":" << s.waitNsTotal.load(std::memory_order_relaxed) / 1000
+            << ",\"waitUsMax\":" << s.waitNsMax.load(std::memory_order_relaxed) / 1000
+            << ",\"waitHistogramLog2Us\":[";
+        // 只输出到最后一个非零桶
+        size_t last = 0;
+        for (size_t i = 0; i < LockStats::BUCKETS; ++i) {
+            if (s.waitHistogram[i].load(std::memory_order_relaxed) > 0) {
+                last = i + 1;
+            }
+        }
+        for (size_t i = 0; i < last; ++i) {
+            if (i > 0) {
+                oss << ",";
+            }
+            oss << s.waitHistogram[i].load(std::memory_order_relaxed);
+        }
+        oss << "]}";
+    }
+    oss << "]}";
+    return oss.str();
+}
+
+void ProfiledMutex::lockProfiled() {
+    stats_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (mutex_.try_lock()) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    mutex_.lock();
+    const auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    stats_->recordWait(static_cast<uint64_t>(waited));
+}
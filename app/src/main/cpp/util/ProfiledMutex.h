@@ -0,0 +1,82 @@
+// ProfiledMutex - 可选开启的锁竞争统计
+// 包装 std::mutex，满足 Lockable，可直接用于 lock_guard / unique_lock。
+// 与 std::condition_variable 配合时用 uniqueLock() 取得底层 std::mutex 的 unique_lock；
+// 此时只统计首次加锁，wait 唤醒后的重新加锁不计入。
+// 统计默认关闭，关闭时 lock() 只多一次 relaxed 原子读。
+#ifndef SCRCPY_PROFILED_MUTEX_H
+#define SCRCPY_PROFILED_MUTEX_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// 按锁名聚合（同名的多个实例合并统计，例如所有 AdbStream::writeMutex）
+struct LockStats {
+    // 等待时间直方图：第 i 桶为 [2^i, 2^(i+1)) 微秒，第 0 桶包含 < 1us，最后一桶为上溢
+    static constexpr size_t BUCKETS = 21;
+
+    std::atomic<uint64_t> acquisitions{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> waitNsTotal{0};
+    std::atomic<uint64_t> waitNsMax{0};
+    std::array<std::atomic<uint64_t>, BUCKETS> waitHistogram{};
+
+    void recordWait(uint64_t waitNs);
+    void reset();
+};
+
+class LockProfiler {
+public:
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    // 开启时清零已有统计
+    static void setEnabled(bool enabled);
+    static LockStats* statsFor(const char* name);
+    static std::string toJson();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class ProfiledMutex {
+public:
+    explicit ProfiledMutex(const char* name) : stats_(LockProfiler::statsFor(name)) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        if (!LockProfiler::enabled()) {
+            mutex_.lock();
+            return;
+        }
+        lockProfiled();
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) {
+            return false;
+        }
+        if (LockProfiler::enabled()) {
+            stats_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void unlock() { mutex_.unlock(); }
+
+    std::unique_lock<std::mutex> uniqueLock() {
+        lock();
+        return std::unique_lock<std::mutex>(mutex_, std::adopt_lock);
+    }
+
+private:
+    void lockProfiled();
+
+    std::mutex mutex_;
+    LockStats* stats_;
+};
+
+#endif // SCRCPY_PROFILED_MUTEX_H
@@ -0,0 +1,205 @@
+#include "util/SocketTuning.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <hilog/log.h>
+#include <map>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sstream>
+#include <sys/socket.h>
+
+#undef LOG_TAG
+#undef LOG_DOMAIN
+#define LOG_TAG "SocketTuning"
+#define LOG_DOMAIN 0x3200
+
+namespace {
+struct ProfileSpec {
+    uint64_t nominalBitsPerSec;   // 用于 BDP 估算的名义码率
+    int minBuffer;
+    int maxBuffer;
+    int notSentLowat;
+    bool quickAck;
+    int keepIdleSec;
+    int keepIntervalSec;
+    int keepCount;
+    int userTimeoutMs;
+};
+
+// 无法取得 RTT（非 TCP、连接尚未建立）时按 20ms 估算，对应常见 Wi-Fi 调试链路
+constexpr uint32_t DEFAULT_RTT_US = 20000;
+
+const ProfileSpec& specFor(SocketProfile profile) {
+    static const ProfileSpec LOW_LATENCY = {
+        8ull * 1000 * 1000, 32 * 1024, 256 * 1024, 16 * 1024, true, 5, 2, 3, 10000,
+    };
+    static const ProfileSpec BULK = {
+        200ull * 1000 * 1000, 256 * 1024, 4 * 1024 * 1024, 128 * 1024, false, 5, 2, 3, 15000,
+    };
+    return profile == SocketProfile::LowLatency ? LOW_LATENCY : BULK;
+}
+
+struct Applied {
+    std::string profile;
+    bool tcp = false;
+    uint32_t rttUs = 0;
+    int bdpBytes = 0;
+    int rcvBuf = -1;
+    int sndBuf = -1;
+    int notSentLowat = -1;
+    int quickAck = -1;
+    int keepAlive = -1;
+    int keepIdle = -1;
+    int keepInterval = -1;
+    int keepCount = -1;
+    int userTimeoutMs = -1;
+    uint64_t applyCount = 0;
+    uint64_t failures = 0;
+};
+
+std::mutex g_mutex;
+std::map<std::string, Applied> g_applied;
+
+bool setInt(int fd, int level, int name, int value, const char* optName, const char* label, uint64_t& failures) {
+    if (setsockopt(fd, level, name, &value, sizeof(value)) == 0) {
+        return true;
+    }
+    ++failures;
+    OH_LOG_WARN(LOG_APP, "[SocketTuning] %{public}s: set %{public}s=%{public}d failed errno=%{public}d",
+                label, optName, value, errno);
+    return false;
+}
+
+int getInt(int fd, int level, int name) {
+    int value = -1;
+    socklen_t len = sizeof(value);
+    if (getsockopt(fd, level, name, &value, &len) != 0) {
+        return -1;
+    }
+    return value;
+}
+
+bool isTcpSocket(int fd) {
+    sockaddr_storage addr {};
+    socklen_t len = sizeof(addr);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        return false;
+    }
+    if (addr.ss_family != AF_INET && addr.ss_family != AF_INET6) {
+        return false;
+    }
+    return getInt(fd, SOL_SOCKET, SO_TYPE) == SOCK_STREAM;
+}
+
+uint32_t measureRttUs(int fd) {
+    struct tcp_info info {};
+    socklen_t len = sizeof(info);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &len) != 0 || info.tcpi_rtt == 0) {
+        return 0;
+    }
+    return info.tcpi_rtt;
+}
+}
+
+void SocketTuning::apply(int fd, SocketProfile profile, const char* label) {
+    if (fd < 0) {
+        return;
+    }
+    const ProfileSpec& spec = specFor(profile);
+    Applied applied;
+    applied.profile = profileName(profile);
+    applied.tcp = isTcpSocket(fd);
+
+    // BDP 估算：名义码率 × RTT，×2 给拥塞窗口增长留余量
+    if (applied.tcp) {
+        applied.rttUs = measureRttUs(fd);
+    }
+    const uint32_t rttUs = applied.rttUs > 0 ? applied.rttUs : DEFAULT_RTT_US;
+    const uint64_t bdp = spec.nominalBitsPerSec / 8 * rttUs / 1000000 * 2;
+    applied.bdpBytes = static_cast<int>(std::min<uint64_t>(
+        std::max<uint64_t>(bdp, static_cast<uint64_t>(spec.minBuffer)), static_cast<uint64_t>(spec.maxBuffer)));
+
+    uint64_t failures = 0;
+    setInt(fd, SOL_SOCKET, SO_RCVBUF, applied.bdpBytes, "SO_RCVBUF", label, failures);
+    setInt(fd, SOL_SOCKET, SO_SNDBUF, applied.bdpBytes, "SO_SNDBUF", label, failures);
+
+    if (applied.tcp) {
+        setInt(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY", label, failures);
+        setInt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, spec.notSentLowat, "TCP_NOTSENT_LOWAT", label, failures);
+        if (spec.quickAck) {
+            setInt(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK", label, failures);
+        }
+        setInt(fd, SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE", label, failures);
+        setInt(fd, IPPROTO_TCP, TCP_KEEPIDLE, spec.keepIdleSec, "TCP_KEEPIDLE", label, failures);
+        setInt(fd, IPPROTO_TCP, TCP_KEEPINTVL, spec.keepIntervalSec, "TCP_KEEPINTVL", label, failures);
+        setInt(fd, IPPROTO_TCP, TCP_KEEPCNT, spec.keepCount, "TCP_KEEPCNT", label, failures);
+        setInt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, spec.userTimeoutMs, "TCP_USER_TIMEOUT", label, failures);
+
+        applied.notSentLowat = getInt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT);
+        applied.quickAck = getInt(fd, IPPROTO_TCP, TCP_QUICKACK);
+        applied.keepAlive = getInt(fd, SOL_SOCKET, SO_KEEPALIVE);
+        applied.keepIdle = getInt(fd, IPPROTO_TCP, TCP_KEEPIDLE);
+        applied.keepInterval = getInt(fd, IPPROTO_TCP, TCP_KEEPINTVL);
+        applied.keepCount = getInt(fd, IPPROTO_TCP, TCP_KEEPCNT);
+        applied.userTimeoutMs = getInt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT);
+    }
+    // 内核会把 SO_RCVBUF/SO_SNDBUF 翻倍并受 rmem_max/wmem_max 限制，上报读回的实际值
+    applied.rcvBuf = getInt(fd, SOL_SOCKET, SO_RCVBUF);
+    applied.sndBuf = getInt(fd, SOL_SOCKET, SO_SNDBUF);
+
+    OH_LOG_INFO(LOG_APP,
+                "[SocketTuning] %{public}s fd=%{public}d profile=%{public}s rtt=%{public}uus bdp=%{public}d "
+                "rcvbuf=%{public}d sndbuf=%{public}d",
+                label, fd, applied.profile.c_str(), applied.rttUs, applied.bdpBytes, applied.rcvBuf, applied.sndBuf);
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    Applied& slot = g_applied[label];
+    const uint64_t applyCount = slot.applyCount + 1;
+    const uint64_t totalFailures = slot.failures + failures;
+    slot = applied;
+    slot.applyCount = applyCount;
+    slot.failures = totalFailures;
+}
+
+void SocketTuning::rearmQuickAck(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+}
+
+const char* SocketTuning::profileName(SocketProfile profile) {
+    return profile == SocketProfile::LowLatency ? "low_latency" : "bulk";
+}
+
+std::string SocketTuning::toJson() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    std::ostringstream oss;
+    oss << "{";
+    bool first = true;
+    for (const auto& entry : g_applied) {
+        const Applied& a = entry.second;
+        if (!first) {
+            oss << ",";
+        }
+        first = false;
+        oss << "\"" << entry.first << "\":{"
+            << "\"profile\":\"" << a.profile << "\""
+            << ",\"tcp\":" << (a.tcp ? "true" : "false")
+            << ",\"rttUs\":" << a.rttUs
+            << ",\"bdpBytes\":" << a.bdpBytes
+            << ",\"rcvBuf\":" << a.rcvBuf
+            << ",\"sndBuf\":" << a.sndBuf
+            << ",\"notSentLowat\":" << a.notSentLowat
+            << ",\"quickAck\":" << a.quickAck
+            << ",\"keepAlive\":" << a.keepAlive
+            << ",\"keepIdleSec\":" << a.keepIdle
+            << ",\"keepIntervalSec\":" << a.keepInterval
+            << ",\"keepCount\":" << a.keepCount
+            << ",\"userTimeoutMs\":" << a.userTimeoutMs
+            << ",\"applyCount\":" << a.applyCount
+            << ",\"failures\":" << a.failures << "}";
+    }
+    oss << "}";
+    return oss.str();
+}
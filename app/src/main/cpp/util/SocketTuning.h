@@ -0,0 +1,31 @@
+// SocketTuning - 通道 socket 参数预设
+// 每个通道 fd 创建/accept 后调用 apply()，按预设设置：
+//   LowLatency：控制通道，小缓冲 + 小 TCP_NOTSENT_LOWAT + TCP_QUICKACK
+//   Bulk：ADB 主连接 / 视频音频隧道，按带宽时延积（BDP）设置收发缓冲
+// 两种预设都开启 keepalive 和 TCP_USER_TIMEOUT，用于尽快发现对端失联。
+// BDP = 预设的名义码率 × TCP_INFO 测得的 RTT，再按预设上下限裁剪；非 TCP fd 只设置缓冲大小。
+// 每个 label 记录最近一次 getsockopt 读回的实际值，供 stats 上报。
+#ifndef SCRCPY_SOCKET_TUNING_H
+#define SCRCPY_SOCKET_TUNING_H
+
+#include <cstdint>
+#include <string>
+
+enum class SocketProfile : uint8_t {
+    LowLatency = 0,
+    Bulk,
+};
+
+class SocketTuning {
+public:
+    // listening socket 上调用时，accept 得到的连接继承缓冲大小（需在 listen 之前）
+    static void apply(int fd, SocketProfile profile, const char* label);
+
+    // TCP_QUICKACK 不是持久选项，内核会在某些情况下回到延迟 ACK；控制通道每次读到数据后重新打开
+    static void rearmQuickAck(int fd);
+
+    static const char* profileName(SocketProfile profile);
+    static std::string toJson();
+};
+
+#endif // SCRCPY_SOCKET_TUNING_H
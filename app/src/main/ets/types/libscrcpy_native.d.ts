@@ -28,7 +28,7 @@ declare module 'libscrcpy_native.so' {
 
 
     // ADB Module
-    export function adbCreate(ip: string, port: number): Promise<number>;
+    export function adbCreate(ip: string, port: number, connectTimeoutMs?: number): Promise<number>;
     export function adbConnect(adbId: number, pubKeyPath: string, priKeyPath: string, onWaitAuth?: () => void): Promise<number>;
     export function adbGetLastConnectError(adbId: number): string;
     export function adbPair(hostPort: string, pairingCode: string, pubKeyPath: string, priKeyPath: string): Promise<string>;
@@ -63,6 +63,8 @@ declare module 'libscrcpy_native.so' {
         onProgress?: (progress: number) => void
     ): Promise<void>;
     export function adbTcpForward(adbId: number, port: number): number;
+    export function adbForwardListen(adbId: number, localPort: number, remote: string): number;
+    export function adbForwardRemove(adbId: number, localPort: number): boolean;
     export function adbLocalSocketForward(
         adbId: number,
         socketName: string,
@@ -79,6 +81,13 @@ declare module 'libscrcpy_native.so' {
     export function adbClose(adbId: number): void;
     export function adbGenerateKeyPair(pubKeyPath: string, priKeyPath: string): number;
     export function adbIsConnected(adbId: number): boolean;
+    export function adbSetTlsSessionDir(dir: string): void;
+    export function adbSetTlsDecryptPipeline(enabled: boolean): void;
+    export function adbSetReactorMode(enabled: boolean, threads?: number): void;
+    export function adbSetIoUring(enabled: boolean): boolean;
+    export function adbSetReverseBridgeZeroCopy(enabled: boolean): void;
+    export function adbPoolOpen(adbId: number, connections: number, pubKeyPath: string, priKeyPath: string): Promise<number>;
+    export function adbPoolConnectionFor(adbId: number, trafficClass: string): number;
 
     // Stream Manager
     export function nativeStartStreams(
@@ -89,7 +98,8 @@ declare module 'libscrcpy_native.so' {
         surfaceId: string,
         audioSampleRate: number,
         audioChannelCount: number,
-        callback: (type: string, data: string) => void
+        callback: (type: string, data: string) => void,
+        streamAdbIds?: number[]
     ): Promise<number>;
     export function nativeStartReverseStreams(
         adbId: number,
@@ -103,4 +113,20 @@ declare module 'libscrcpy_native.so' {
     ): Promise<number>;
     export function nativeStopStreams(): void;
     export function nativeSendControl(data: ArrayBuffer): boolean;
+    export function nativeResyncVideo(): boolean;
+    export function nativeEnableAutoReconnect(
+        serverCommand: string,
+        socketName: string,
+        pubKeyPath: string,
+        priKeyPath: string,
+        deadPeerMs?: number,
+        targetMs?: number
+    ): boolean;
+    export function nativeStartPacketServer(kind: 'video' | 'audio', port: number): number;
+    export function nativeOnMemoryLevel(level: number): void;
+    export function nativeGetStats(): string;
+    export function nativeSetDiagnosticsDir(dir: string): void;
+    export function nativeDumpFlightRecorder(reason?: string): string;
+    export function nativeSetLockProfiling(enabled: boolean): void;
+    export function nativeSetAllocTracking(enabled: boolean, budgetPerFrame?: number): boolean;
 }
@@ -0,0 +1,216 @@
+// HappyEyeballs 主机端测试
+// 黑洞地址用 backlog 已满的回环 listener 模拟：accept 队列满时内核直接丢弃 SYN，connect 一直停在进行中。
+#include "adb/channel/HappyEyeballs.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+constexpr int ATTEMPT_DELAY_MS = 100;
+// 调度抖动的余量
+constexpr int SLACK_MS = 150;
+
+int g_failures = 0;
+
+#define EXPECT(cond)                                                          \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                     \
+        }                                                                     \
+    } while (0)
+
+struct Endpoint {
+    sockaddr_in sin{};
+    addrinfo info{};
+
+    explicit Endpoint(uint16_t port) {
+        sin.sin_family = AF_INET;
+        sin.sin_port = htons(port);
+        sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        info.ai_family = AF_INET;
+        info.ai_socktype = SOCK_STREAM;
+        info.ai_protocol = IPPROTO_TCP;
+        info.ai_addr = reinterpret_cast<sockaddr*>(&sin);
+        info.ai_addrlen = sizeof(sin);
+    }
+};
+
+int listenLoopback(int backlog, uint16_t& port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(sin);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&sin), sizeof(sin)) != 0 || listen(fd, backlog) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&sin), &len) != 0) {
+        std::perror("listenLoopback");
+        return -1;
+    }
+    port = ntohs(sin.sin_port);
+    return fd;
+}
+
+// 不 accept 的 listener，把 accept 队列塞满后新的 SYN 全被丢弃
+struct BlackHole {
+    int listenFd = -1;
+    uint16_t port = 0;
+    std::vector<int> fillers;
+
+    BlackHole() {
+        listenFd = listenLoopback(0, port);
+        Endpoint target(port);
+        for (int i = 0; i < 8; ++i) {
+            int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            ::connect(fd, target.info.ai_addr, target.info.ai_addrlen);
+            pollfd pfd{fd, POLLOUT, 0};
+            if (poll(&pfd, 1, 200) <= 0) {
+                ::close(fd);
+                return;
+            }
+            fillers.push_back(fd);
+        }
+        std::fprintf(stderr, "accept queue never filled, black hole unreliable\n");
+    }
+
+    ~BlackHole() {
+        for (int fd : fillers) {
+            ::close(fd);
+        }
+        ::close(listenFd);
+    }
+};
+
+int openFdCount() {
+    int count = 0;
+    DIR* dir = opendir("/proc/self/fd");
+    if (!dir) {
+        return -1;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            ++count;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+long long elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint16_t peerPort(int fd) {
+    sockaddr_in sin{};
+    socklen_t len = sizeof(sin);
+    getpeername(fd, reinterpret_cast<sockaddr*>(&sin), &len);
+    return ntohs(sin.sin_port);
+}
+
+// 首个地址无响应时，下一个地址在一个尝试间隔后接上，而不是等到整体超时
+void testFallsBackAfterAttemptDelay() {
+    BlackHole hole;
+    uint16_t livePort = 0;
+    int liveFd = listenLoopback(4, livePort);
+    Endpoint dead(hole.port);
+    Endpoint live(livePort);
+
+    const int fdsBefore = openFdCount();
+    const auto start = std::chrono::steady_clock::now();
+    int fd = HappyEyeballs::connect({&dead.info, &live.info}, 5000, ATTEMPT_DELAY_MS);
+    const long long took = elapsedMs(start);
+
+    EXPECT(fd >= 0);
+    EXPECT(took >= ATTEMPT_DELAY_MS - 5);
+    EXPECT(took < ATTEMPT_DELAY_MS + SLACK_MS);
+    if (fd >= 0) {
+        EXPECT(peerPort(fd) == livePort);
+        EXPECT((fcntl(fd, F_GETFL, 0) & O_NONBLOCK) == 0);
+        // 只多出胜出的连接，仍在进行中的黑洞尝试已关闭
+        EXPECT(openFdCount() == fdsBefore + 1);
+        ::close(fd);
+    }
+    ::close(liveFd);
+}
+
+// 所有地址都无响应时按整体截止时间返回，不留下任何 socket
+void testDeadlineWhenAllBlackHoled() {
+    BlackHole first;
+    BlackHole second;
+    Endpoint a(first.port);
+    Endpoint b(second.port);
+    const int timeoutMs = 3 * ATTEMPT_DELAY_MS;
+
+    const int fdsBefore = openFdCount();
+    const auto start = std::chrono::steady_clock::now();
+    int fd = HappyEyeballs::connect({&a.info, &b.info}, timeoutMs, ATTEMPT_DELAY_MS);
+    const long long took = elapsedMs(start);
+
+    EXPECT(fd < 0);
+    EXPECT(took >= timeoutMs - 5);
+    EXPECT(took < timeoutMs + SLACK_MS);
+    EXPECT(openFdCount() == fdsBefore);
+}
+
+// 被拒绝的地址立即让位给下一个，不必等满间隔
+void testRefusedAddressSkipsDelay() {
+    uint16_t refusedPort = 0;
+    int closedFd = listenLoopback(1, refusedPort);
+    ::close(closedFd);
+    uint16_t livePort = 0;
+    int liveFd = listenLoopback(4, livePort);
+    Endpoint refused(refusedPort);
+    Endpoint live(livePort);
+
+    const int fdsBefore = openFdCount();
+    const auto start = std::chrono::steady_clock::now();
+    int fd = HappyEyeballs::connect({&refused.info, &live.info}, 5000, ATTEMPT_DELAY_MS);
+    const long long took = elapsedMs(start);
+
+    EXPECT(fd >= 0);
+    EXPECT(took < ATTEMPT_DELAY_MS);
+    if (fd >= 0) {
+        EXPECT(peerPort(fd) == livePort);
+        EXPECT(openFdCount() == fdsBefore + 1);
+        ::close(fd);
+    }
+    ::close(liveFd);
+}
+
+void testInterleavesFamilies() {
+    addrinfo v6a{}, v6b{}, v4a{}, v4b{};
+    v6a.ai_family = AF_INET6;
+    v6b.ai_family = AF_INET6;
+    v4a.ai_family = AF_INET;
+    v4b.ai_family = AF_INET;
+    v6a.ai_next = &v6b;
+    v6b.ai_next = &v4a;
+    v4a.ai_next = &v4b;
+
+    std::vector<const addrinfo*> ordered = HappyEyeballs::interleaveAddressFamilies(&v6a);
+    std::vector<const addrinfo*> expected = {&v6a, &v4a, &v6b, &v4b};
+    EXPECT(ordered == expected);
+    EXPECT(HappyEyeballs::interleaveAddressFamilies(nullptr).empty());
+}
+}
+
+int main() {
+    testInterleavesFamilies();
+    testFallsBackAfterAttemptDelay();
+    testDeadlineWhenAllBlackHoled();
+    testRefusedAddressSkipsDelay();
+    if (g_failures != 0) {
+        std::fprintf(stderr, "%d expectation(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("happy_eyeballs: all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,70 @@
+// MemoryBudget 主机端测试：关闭的流提前交还份额后，其余流的上限要立即回升
+#include "util/MemoryBudget.h"
+#include <cstdio>
+#include <memory>
+
+namespace {
+constexpr size_t MiB = 1024 * 1024;
+
+int g_failures = 0;
+
+#define EXPECT(cond)                                                          \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            std::fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                     \
+        }                                                                     \
+    } while (0)
+
+std::shared_ptr<BudgetLease> acquireRing(const char* name, size_t requested, size_t minimum) {
+    return MemoryBudget::instance().acquire(BudgetCategory::StreamRing, name, requested, minimum);
+}
+
+// 三条流超出总预算时按比例收缩；释放其中两条后剩下的一条回到期望容量
+void testReleaseRebalancesRemainingLeases() {
+    MemoryBudget::instance().setTotalBudget(100 * MiB);
+    auto video = acquireRing("video#1", 64 * MiB, 8 * MiB);
+    auto first = acquireRing("other#2", 64 * MiB, 8 * MiB);
+    auto second = acquireRing("other#3", 64 * MiB, 8 * MiB);
+    first->setAllocated(64 * MiB);
+
+    EXPECT(video->limit() < 64 * MiB);
+    EXPECT(video->limit() >= 8 * MiB);
+
+    first->release();
+    EXPECT(first->allocated() == 0);
+    EXPECT(video->limit() < 64 * MiB);
+
+    second->release();
+    EXPECT(video->limit() == 64 * MiB);
+
+    // 释放后的租约不再参与分配，重复释放和析构都不会影响其他租约
+    first->release();
+    first.reset();
+    second.reset();
+    EXPECT(video->limit() == 64 * MiB);
+}
+
+// 释放后再登记新流，新流与仍在用的流分预算，不把已释放的份额算进去
+void testReleasedLeaseExcludedFromLaterRebalance() {
+    MemoryBudget::instance().setTotalBudget(100 * MiB);
+    auto video = acquireRing("video#4", 64 * MiB, 8 * MiB);
+    auto closed = acquireRing("other#5", 64 * MiB, 8 * MiB);
+    closed->release();
+    auto fresh = acquireRing("other#6", 32 * MiB, 1 * MiB);
+
+    EXPECT(video->limit() == 64 * MiB);
+    EXPECT(fresh->limit() == 32 * MiB);
+}
+}
+
+int main() {
+    testReleaseRebalancesRemainingLeases();
+    testReleasedLeaseExcludedFromLaterRebalance();
+    if (g_failures != 0) {
+        std::fprintf(stderr, "%d expectation(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("memory_budget: all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,21 @@
+// 主机测试用的 hilog 替身：日志直接丢弃
+// 参数放进 sizeof 里只做类型检查、不求值，这样仅被日志引用的辅助函数也算被使用，-Wall -Wextra 下不会报 unused
+#ifndef SCRCPY_TEST_HILOG_STUB_H
+#define SCRCPY_TEST_HILOG_STUB_H
+
+#define LOG_APP 0
+
+template <typename... Args>
+inline int ScrcpyTestLogDiscard(const Args&...)
+{
+    return 0;
+}
+
+#define SCRCPY_TEST_LOG_DISCARD(type, ...) ((void)sizeof(ScrcpyTestLogDiscard((type), __VA_ARGS__)))
+#define OH_LOG_DEBUG(type, ...) SCRCPY_TEST_LOG_DISCARD(type, __VA_ARGS__)
+#define OH_LOG_INFO(type, ...) SCRCPY_TEST_LOG_DISCARD(type, __VA_ARGS__)
+#define OH_LOG_WARN(type, ...) SCRCPY_TEST_LOG_DISCARD(type, __VA_ARGS__)
+#define OH_LOG_ERROR(type, ...) SCRCPY_TEST_LOG_DISCARD(type, __VA_ARGS__)
+#define OH_LOG_FATAL(type, ...) SCRCPY_TEST_LOG_DISCARD(type, __VA_ARGS__)
+
+#endif // SCRCPY_TEST_HILOG_STUB_H